@@ -4,3 +4,7 @@
 
 #include "CoreMinimal.h"
 
+DECLARE_LOG_CATEGORY_EXTERN(LogFlightSim, Log, All);
+
+// Trace channel used by gun rounds and other projectiles, see DefaultEngine.ini
+#define ECC_Gunfire ECC_GameTraceChannel1
@@ -2,16 +2,23 @@
 
 #include "AIAircraftPawn.h"
 #include "HealthComponent.h"
-#include "Kismet/GameplayStatics.h"
-#include "TimerManager.h"
+#include "AIFlightSubsystem.h"
+#include "AircraftRegistrySubsystem.h"
+#include "SensorSubsystem.h"
+#include "WeaponComponent.h"
 #include "Kismet/KismetMathLibrary.h"
-#include "Sound/SoundBase.h"
-#include "Particles/ParticleSystem.h"
+#include "Net/UnrealNetwork.h"
 
 // Sets default values
 AAIAircraftPawn::AAIAircraftPawn()
 {
-	PrimaryActorTick.bCanEverTick = true;
+	// Movement, state and firing are driven by UAIFlightSubsystem
+	PrimaryActorTick.bCanEverTick = false;
+
+	// AI flies on the server only
+	bReplicates = true;
+	SetReplicatingMovement(true);
+	SetNetUpdateFrequency(20.0f);
 
 	AircraftMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("AircraftMesh"));
 	RootComponent = AircraftMesh;
@@ -22,16 +29,46 @@ AAIAircraftPawn::AAIAircraftPawn()
 	MuzzleLocation = CreateDefaultSubobject<USceneComponent>(TEXT("MuzzleLocation"));
 	MuzzleLocation->SetupAttachment(AircraftMesh);
 
+	WeaponComponent = CreateDefaultSubobject<UWeaponComponent>(TEXT("WeaponComponent"));
+	WeaponComponent->SetMuzzle(MuzzleLocation);
+	// The AI only runs on the server; clients fire the replicated trigger themselves
+	WeaponComponent->bUpdateOnSimulatedProxy = true;
+	WeaponComponent->DefaultStats.FireInterval = 0.5f;
+
+	// The defaults these had before they moved to the weapon component, so PostLoad only carries over changed values
+	FireRate_DEPRECATED = 0.5f;
+	FireAngleThreshold_DEPRECATED = 0.98f;
+	MuzzleFlashFX_DEPRECATED = nullptr;
+	FireSound_DEPRECATED = nullptr;
+	WeaponRange_DEPRECATED = 30000.0f;
+
 	FlightSpeed = 5000.0f;
 	TurnSpeed = 50.0f;
-	FireRate = 0.5f;
-	WeaponRange = 30000.0f;
-	FireAngleThreshold = 0.98f;
 	AvoidanceDistance = 10000.0f;
 	MaxSpeed = 8000.0f;
 	CirclingOffsetDistance = 5000.0f;
 
-	CurrentAIState = EAIState::Seeking;
+	TeamId = 1;
+
+	SensorModel.Range = 500000.0f;
+	SensorModel.AzimuthHalfAngle = 90.0f;
+	SensorModel.ElevationHalfAngle = 45.0f;
+	SensorModel.ScanRate = 180.0f;
+
+	FlightIndex = INDEX_NONE;
+}
+
+void AAIAircraftPawn::PostLoad()
+{
+	Super::PostLoad();
+
+	// Only values that differ from the native defaults were set by a Blueprint or level
+	const AAIAircraftPawn* Defaults = GetDefault<AAIAircraftPawn>();
+	FWeaponStats& Stats = WeaponComponent->DefaultStats;
+	if (FireRate_DEPRECATED != Defaults->FireRate_DEPRECATED) Stats.FireInterval = FireRate_DEPRECATED;
+	if (FireAngleThreshold_DEPRECATED != Defaults->FireAngleThreshold_DEPRECATED) Stats.FireAngleThreshold = FireAngleThreshold_DEPRECATED;
+	if (MuzzleFlashFX_DEPRECATED) Stats.MuzzleFlashFX = MuzzleFlashFX_DEPRECATED;
+	if (FireSound_DEPRECATED) Stats.FireSound = FireSound_DEPRECATED;
 }
 
 // Called when the game starts or when spawned
@@ -43,133 +80,78 @@ void AAIAircraftPawn::BeginPlay()
 	{
 		HealthComponent->OnHealthChanged.AddDynamic(this, &AAIAircraftPawn::HandleTakeDamage);
 	}
-}
-
-// Called every frame
-void AAIAircraftPawn::Tick(float DeltaTime)
-{
-	Super::Tick(DeltaTime);
-
-	if (HealthComponent && HealthComponent->IsDead()) return;
 
-	if (CurrentAIState == EAIState::Seeking || CurrentAIState == EAIState::Circling)
+	if (HasAuthority())
 	{
-		MoveAndTurn(DeltaTime);
-		TryFireWeapon();
-	}
-	else if (CurrentAIState == EAIState::Evading)
-	{
-		PerformEvasion(DeltaTime);
-	}
-}
-
-void AAIAircraftPawn::MoveAndTurn(float DeltaTime)
-{
-	APawn* PlayerPawn = UGameplayStatics::GetPlayerPawn(GetWorld(), 0);
-	if (!PlayerPawn) return;
-
-	float DistanceToPlayer = FVector::Dist(PlayerPawn->GetActorLocation(), GetActorLocation());
+		if (UAIFlightSubsystem* FlightSubsystem = GetWorld()->GetSubsystem<UAIFlightSubsystem>())
+		{
+			FlightIndex = FlightSubsystem->RegisterAircraft(this);
+		}
 
-	FVector TargetLocation;
-	if (DistanceToPlayer < AvoidanceDistance)
-	{
-		CurrentAIState = EAIState::Circling;
-		FVector RightVector = GetActorRightVector();
-		TargetLocation = PlayerPawn->GetActorLocation() + (RightVector * CirclingOffsetDistance);
+		if (USensorSubsystem* Sensors = GetWorld()->GetSubsystem<USensorSubsystem>())
+		{
+			Sensors->RegisterSensor(this, SensorModel);
+		}
 	}
 	else
 	{
-		CurrentAIState = EAIState::Seeking;
-		TargetLocation = PlayerPawn->GetActorLocation();
+		AircraftMesh->SetSimulatePhysics(false);
 	}
 
-	FVector DirectionToTarget = (TargetLocation - GetActorLocation()).GetSafeNormal();
-	FRotator TargetRotation = FMath::RInterpTo(GetActorRotation(), DirectionToTarget.Rotation(), DeltaTime, TurnSpeed * 0.1f);
-	SetActorRotation(TargetRotation);
-
-	FVector CurrentVelocity = AircraftMesh->GetPhysicsLinearVelocity();
-	if (CurrentVelocity.Size() < MaxSpeed)
+	if (UAircraftRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UAircraftRegistrySubsystem>())
 	{
-		AircraftMesh->AddForce(GetActorForwardVector() * FlightSpeed * 100.0f);
+		Registry->RegisterAircraft(this);
 	}
 }
 
-void AAIAircraftPawn::TryFireWeapon()
+void AAIAircraftPawn::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	APawn* PlayerPawn = UGameplayStatics::GetPlayerPawn(GetWorld(), 0);
-	if (!PlayerPawn) return;
-
-	FVector DirectionToPlayer = (PlayerPawn->GetActorLocation() - GetActorLocation()).GetSafeNormal();
-	float DotProduct = FVector::DotProduct(GetActorForwardVector(), DirectionToPlayer);
-
-	if (DotProduct > FireAngleThreshold)
+	if (UAIFlightSubsystem* FlightSubsystem = GetWorld()->GetSubsystem<UAIFlightSubsystem>())
 	{
-		GetWorldTimerManager().SetTimer(FireRateTimerHandle, this, &AAIAircraftPawn::FireWeapon, FireRate, true, 0.0f);
+		FlightSubsystem->UnregisterAircraft(this);
 	}
-	else
-	{
-		GetWorldTimerManager().ClearTimer(FireRateTimerHandle);
-	}
-}
-
-void AAIAircraftPawn::FireWeapon()
-{
-	FHitResult HitResult;
-	FVector Start = MuzzleLocation->GetComponentLocation();
-	FVector End = Start + (GetActorForwardVector() * WeaponRange);
-	FCollisionQueryParams CollisionParams;
-	CollisionParams.AddIgnoredActor(this);
-
-	GetWorld()->LineTraceSingleByChannel(HitResult, Start, End, ECC_Visibility, CollisionParams);
 
-	if (HitResult.GetActor())
+	if (USensorSubsystem* Sensors = GetWorld()->GetSubsystem<USensorSubsystem>())
 	{
-		UHealthComponent* HitHealthComponent = HitResult.GetActor()->FindComponentByClass<UHealthComponent>();
-		if (HitHealthComponent)
-		{
-			HitHealthComponent->TakeDamage(10.0f);
-		}
+		Sensors->UnregisterSensor(this);
 	}
 
-	if (MuzzleFlashFX)
+	if (UAircraftRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UAircraftRegistrySubsystem>())
 	{
-		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), MuzzleFlashFX, MuzzleLocation->GetComponentLocation());
+		Registry->UnregisterAircraft(this);
 	}
 
-	if (FireSound)
-	{
-		UGameplayStatics::PlaySoundAtLocation(this, FireSound, GetActorLocation());
-	}
+	Super::EndPlay(EndPlayReason);
 }
 
-void AAIAircraftPawn::HandleTakeDamage(AActor* DamagedActor, float NewHealth)
+void AAIAircraftPawn::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
-	if (CurrentAIState != EAIState::Evading)
-	{
-		BeginEvasion();
-	}
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AAIAircraftPawn, TeamId);
 }
 
-void AAIAircraftPawn::BeginEvasion()
+void AAIAircraftPawn::SetGenericTeamId(const FGenericTeamId& NewTeamId)
 {
-	CurrentAIState = EAIState::Evading;
-	GetWorldTimerManager().SetTimer(EvasionTimerHandle, this, &AAIAircraftPawn::EndEvasion, 2.0f, false);
+	TeamId = NewTeamId.GetId();
 }
 
-void AAIAircraftPawn::EndEvasion()
+FGenericTeamId AAIAircraftPawn::GetGenericTeamId() const
 {
-	CurrentAIState = EAIState::Seeking;
+	return FGenericTeamId(TeamId);
 }
 
-void AAIAircraftPawn::PerformEvasion(float DeltaTime)
+EAIState AAIAircraftPawn::GetAIState() const
 {
-	FRotator EvasionRotation = GetActorRotation() + FRotator(0.0f, 90.0f, 0.0f);
-	SetActorRotation(FMath::RInterpTo(GetActorRotation(), EvasionRotation, DeltaTime, TurnSpeed * 0.2f));
+	const UAIFlightSubsystem* FlightSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UAIFlightSubsystem>() : nullptr;
+	return FlightSubsystem ? FlightSubsystem->GetAIState(FlightIndex) : EAIState::Seeking;
+}
 
-	FVector CurrentVelocity = AircraftMesh->GetPhysicsLinearVelocity();
-	if (CurrentVelocity.Size() < MaxSpeed)
+void AAIAircraftPawn::HandleTakeDamage(AActor* DamagedActor, float NewHealth)
+{
+	if (UAIFlightSubsystem* FlightSubsystem = GetWorld()->GetSubsystem<UAIFlightSubsystem>())
 	{
-		AircraftMesh->AddForce(GetActorForwardVector() * FlightSpeed * 100.0f);
+		FlightSubsystem->NotifyDamaged(FlightIndex);
 	}
 }
 
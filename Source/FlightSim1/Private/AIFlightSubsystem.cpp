@@ -0,0 +1,742 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#include "AIFlightSubsystem.h"
+#include "AIAircraftPawn.h"
+#include "WeaponComponent.h"
+#include "AircraftRegistrySubsystem.h"
+#include "SensorSubsystem.h"
+#include "TerrainHeightSubsystem.h"
+#include "Components/StaticMeshComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Camera/PlayerCameraManager.h"
+#include "FlightSimProfiling.h"
+#include "Async/ParallelFor.h"
+
+bool UAIFlightSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UAIFlightSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	Terrain = Collection.InitializeDependency<UTerrainHeightSubsystem>();
+	Registry = Collection.InitializeDependency<UAircraftRegistrySubsystem>();
+	Sensors = Collection.InitializeDependency<USensorSubsystem>();
+}
+
+TStatId UAIFlightSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAIFlightSubsystem, STATGROUP_Tickables);
+}
+
+int32 UAIFlightSubsystem::RegisterAircraft(AAIAircraftPawn* Aircraft)
+{
+	check(Aircraft);
+
+	const int32 Index = Pawns.Add(Aircraft);
+	Meshes.Add(Aircraft->AircraftMesh);
+
+	FlightSpeeds.Add(Aircraft->FlightSpeed);
+	TurnSpeeds.Add(Aircraft->TurnSpeed);
+	MaxSpeeds.Add(Aircraft->MaxSpeed);
+	AvoidanceDistances.Add(Aircraft->AvoidanceDistance);
+	CirclingOffsets.Add(Aircraft->CirclingOffsetDistance);
+	FireAngleThresholds.Add(Aircraft->WeaponComponent->GetStats().FireAngleThreshold);
+	MuzzleSpeeds.Add(Aircraft->WeaponComponent->GetStats().MuzzleSpeed);
+
+	Teams.Add(Aircraft->TeamId);
+	Targets.Add(nullptr);
+	Leaders.Add(nullptr);
+	FormationSlots.Add(FVector::ZeroVector);
+	States.Add(EAIState::Seeking);
+	EvasionTimeRemaining.Add(0.0f);
+
+	// New aircraft start fully simulated until the next significance pass places them
+	SignificanceTierIndices.Add(0);
+	FramesUntilUpdate.Add(1);
+	PendingDeltaTime.Add(0.0f);
+	WeaponCooldowns.Add(0.0f);
+
+	Locations.AddZeroed();
+	Rotations.AddZeroed();
+	Velocities.AddZeroed();
+
+	if (bKinematicFlight)
+	{
+		// Spawned in the air, so start at cruise speed rather than accelerating from rest
+		Aircraft->AircraftMesh->SetSimulatePhysics(false);
+		Velocities[Index] = Aircraft->GetActorForwardVector() * Aircraft->MaxSpeed;
+	}
+
+	return Index;
+}
+
+void UAIFlightSubsystem::UnregisterAircraft(AAIAircraftPawn* Aircraft)
+{
+	if (!Aircraft || !Pawns.IsValidIndex(Aircraft->FlightIndex) || Pawns[Aircraft->FlightIndex] != Aircraft) return;
+
+	RemoveAtSwap(Aircraft->FlightIndex);
+	Aircraft->FlightIndex = INDEX_NONE;
+}
+
+void UAIFlightSubsystem::RemoveAtSwap(int32 Index)
+{
+	Pawns.RemoveAtSwap(Index, EAllowShrinking::No);
+	Meshes.RemoveAtSwap(Index, EAllowShrinking::No);
+	FlightSpeeds.RemoveAtSwap(Index, EAllowShrinking::No);
+	TurnSpeeds.RemoveAtSwap(Index, EAllowShrinking::No);
+	MaxSpeeds.RemoveAtSwap(Index, EAllowShrinking::No);
+	AvoidanceDistances.RemoveAtSwap(Index, EAllowShrinking::No);
+	CirclingOffsets.RemoveAtSwap(Index, EAllowShrinking::No);
+	FireAngleThresholds.RemoveAtSwap(Index, EAllowShrinking::No);
+	MuzzleSpeeds.RemoveAtSwap(Index, EAllowShrinking::No);
+	Teams.RemoveAtSwap(Index, EAllowShrinking::No);
+	Targets.RemoveAtSwap(Index, EAllowShrinking::No);
+	Leaders.RemoveAtSwap(Index, EAllowShrinking::No);
+	FormationSlots.RemoveAtSwap(Index, EAllowShrinking::No);
+	States.RemoveAtSwap(Index, EAllowShrinking::No);
+	EvasionTimeRemaining.RemoveAtSwap(Index, EAllowShrinking::No);
+	SignificanceTierIndices.RemoveAtSwap(Index, EAllowShrinking::No);
+	FramesUntilUpdate.RemoveAtSwap(Index, EAllowShrinking::No);
+	PendingDeltaTime.RemoveAtSwap(Index, EAllowShrinking::No);
+	WeaponCooldowns.RemoveAtSwap(Index, EAllowShrinking::No);
+	Locations.RemoveAtSwap(Index, EAllowShrinking::No);
+	Rotations.RemoveAtSwap(Index, EAllowShrinking::No);
+	Velocities.RemoveAtSwap(Index, EAllowShrinking::No);
+
+	// The last aircraft now lives in the freed slot
+	if (Pawns.IsValidIndex(Index))
+	{
+		Pawns[Index]->FlightIndex = Index;
+	}
+}
+
+void UAIFlightSubsystem::NotifyDamaged(int32 Index)
+{
+	if (!States.IsValidIndex(Index) || States[Index] == EAIState::Evading) return;
+
+	States[Index] = EAIState::Evading;
+	EvasionTimeRemaining[Index] = EvasionDuration;
+}
+
+void UAIFlightSubsystem::GatherState()
+{
+	for (int32 i = 0; i < Pawns.Num(); ++i)
+	{
+		Locations[i] = Meshes[i]->GetComponentLocation();
+		Rotations[i] = Meshes[i]->GetComponentRotation();
+
+		// Kinematic aircraft keep the velocity ApplyThrust integrated for them
+		if (Meshes[i]->IsSimulatingPhysics())
+		{
+			Velocities[i] = Meshes[i]->GetPhysicsLinearVelocity();
+		}
+	}
+}
+
+void UAIFlightSubsystem::UpdateSignificance()
+{
+	if (SignificanceTiers.Num() == 0) return;
+
+	// Every local or remote player's view, so aircraft near any of them keep a high tier
+	Viewers.Reset();
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PlayerController = It->Get();
+		if (!PlayerController) continue;
+
+		FSignificanceViewer& Viewer = Viewers.AddDefaulted_GetRef();
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(Viewer.Location, ViewRotation);
+		Viewer.Direction = ViewRotation.Vector();
+		const float HalfFov = PlayerController->PlayerCameraManager ? PlayerController->PlayerCameraManager->GetFOVAngle() * 0.5f : 45.0f;
+		Viewer.CosHalfFov = FMath::Cos(FMath::DegreesToRadians(HalfFov));
+		Viewer.Pawn = PlayerController->GetPawn();
+	}
+	if (Viewers.Num() == 0) return;
+
+	const int32 LastTier = SignificanceTiers.Num() - 1;
+	for (int32 i = 0; i < Pawns.Num(); ++i)
+	{
+		// The most significant any player finds the aircraft
+		float Significance = 0.0f;
+		const APawn* Target = Targets[i].Get();
+		for (const FSignificanceViewer& Viewer : Viewers)
+		{
+			const FVector ToAircraft = Locations[i] - Viewer.Location;
+			const float Distance = FMath::Max(ToAircraft.Size(), 1.0f);
+
+			// Apparent size: roughly the fraction of the view the aircraft covers
+			float ViewerSignificance = Meshes[i]->Bounds.SphereRadius / Distance;
+			if (FVector::DotProduct(Viewer.Direction, ToAircraft) < Viewer.CosHalfFov * Distance)
+			{
+				ViewerSignificance *= OffScreenSignificanceScale;
+			}
+			if (Target && Target == Viewer.Pawn)
+			{
+				ViewerSignificance *= ThreatSignificanceScale;
+			}
+			Significance = FMath::Max(Significance, ViewerSignificance);
+		}
+
+		// Promote as soon as the next tier's threshold is reached, demote only once clearly below the current one
+		int32 Tier = FMath::Min<int32>(SignificanceTierIndices[i], LastTier);
+		while (Tier > 0 && Significance >= SignificanceTiers[Tier - 1].MinSignificance)
+		{
+			--Tier;
+		}
+		while (Tier < LastTier && Significance < SignificanceTiers[Tier].MinSignificance * (1.0f - SignificanceHysteresis))
+		{
+			++Tier;
+		}
+
+		if (Tier != SignificanceTierIndices[i])
+		{
+			SetSignificanceTier(i, Tier);
+		}
+	}
+}
+
+void UAIFlightSubsystem::SetSignificanceTier(int32 Index, int32 NewTier)
+{
+	const FAISignificanceTier& Tier = SignificanceTiers[NewTier];
+	SignificanceTierIndices[Index] = NewTier;
+
+	// Don't leave a promoted aircraft waiting out its old, longer interval
+	FramesUntilUpdate[Index] = FMath::Min(FramesUntilUpdate[Index], FMath::Max(Tier.UpdateInterval, 1));
+	WeaponCooldowns[Index] = FMath::Min(WeaponCooldowns[Index], Tier.WeaponEvaluationInterval);
+
+	UStaticMeshComponent* Mesh = Meshes[Index];
+	const bool bSimulatePhysics = Tier.bSimulatePhysics && !bKinematicFlight;
+	if (Mesh->IsSimulatingPhysics() != bSimulatePhysics)
+	{
+		if (bSimulatePhysics)
+		{
+			Mesh->SetSimulatePhysics(true);
+			Mesh->SetPhysicsLinearVelocity(Velocities[Index]);
+		}
+		else
+		{
+			Velocities[Index] = Mesh->GetPhysicsLinearVelocity();
+			Mesh->SetSimulatePhysics(false);
+		}
+	}
+
+	Pawns[Index]->WeaponComponent->SetEffectsEnabled(Tier.bEnableEffects);
+}
+
+void UAIFlightSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	FLIGHTSIM_SCOPE(AI, AITick);
+
+	if (Pawns.Num() == 0) return;
+
+	GatherState();
+	FrameDeltaTime = DeltaTime;
+
+	TimeUntilAssignment -= DeltaTime;
+	if (TimeUntilAssignment <= 0.0f)
+	{
+		AssignTargets();
+		TimeUntilAssignment = AssignmentInterval;
+	}
+
+	TimeUntilSignificance -= DeltaTime;
+	if (TimeUntilSignificance <= 0.0f)
+	{
+		UpdateSignificance();
+		TimeUntilSignificance = SignificanceInterval;
+	}
+
+	// Less significant aircraft skip frames and catch up with one longer step
+	Updates.Reset();
+	for (int32 i = 0; i < Pawns.Num(); ++i)
+	{
+		PendingDeltaTime[i] += DeltaTime;
+		if (--FramesUntilUpdate[i] > 0) continue;
+
+		const FAISignificanceTier* Tier = SignificanceTiers.IsValidIndex(SignificanceTierIndices[i]) ? &SignificanceTiers[SignificanceTierIndices[i]] : nullptr;
+		FramesUntilUpdate[i] = Tier ? FMath::Max(Tier->UpdateInterval, 1) : 1;
+
+		FAIUpdate& Update = Updates.AddDefaulted_GetRef();
+		Update.Index = i;
+		Update.StepTime = PendingDeltaTime[i];
+		Update.bSimulatingPhysics = Meshes[i]->IsSimulatingPhysics();
+		PendingDeltaTime[i] = 0.0f;
+	}
+
+	// Decisions only read the snapshot and write their own update, so they can run on any thread. The game thread
+	// waits inside the ParallelFor, so nothing they read changes under them.
+	{
+		FLIGHTSIM_STAT_SCOPE(AIDecide);
+		ParallelForWithTaskContext(TEXT("AIFlightDecisions"), DecisionContexts, Updates.Num(), DecisionBatchSize,
+			[this](FAIDecisionContext& Context, int32 UpdateIndex) { Decide(Updates[UpdateIndex], Context); },
+			bParallelDecisions ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+	}
+
+	{
+		FLIGHTSIM_STAT_SCOPE(AIApply);
+		for (const FAIUpdate& Update : Updates)
+		{
+			ApplyUpdate(Update);
+		}
+	}
+}
+
+void UAIFlightSubsystem::Decide(FAIUpdate& Update, FAIDecisionContext& Context) const
+{
+	const int32 i = Update.Index;
+	const float StepTime = Update.StepTime;
+
+	Update.State = States[i];
+	Update.EvasionTimeRemaining = EvasionTimeRemaining[i];
+	Update.WeaponCooldown = WeaponCooldowns[i] - StepTime;
+
+	if (Update.State == EAIState::Evading)
+	{
+		Update.EvasionTimeRemaining -= StepTime;
+		if (Update.EvasionTimeRemaining <= 0.0f)
+		{
+			Update.State = EAIState::Seeking;
+		}
+	}
+
+	if (Update.State == EAIState::Evading)
+	{
+		PerformEvasion(Update);
+		return;
+	}
+
+	// Aircraft chase where their own sensor puts the target; once the track is lost they wait for reassignment
+	const APawn* Target = Targets[i].Get();
+	const FSensorTrack* Track = Target && Sensors ? Sensors->FindTrack(Pawns[i], Target) : nullptr;
+	if (Target && !Track)
+	{
+		Update.bLostTarget = true;
+		Target = nullptr;
+	}
+	const FVector TrackedLocation = Track ? Track->PredictLocation(Sensors->GetTime()) : FVector::ZeroVector;
+
+	FVector FormationGoal;
+	const bool bInFormation = Target && GetFormationGoal(i, TrackedLocation, FormationGoal);
+	const FVector FlockSteer = ComputeFlocking(i, Context.Neighbors, bInFormation);
+
+	if (!Target)
+	{
+		// Nothing to chase until the next assignment pass, keep flying straight apart from keeping clear of the group
+		if (FlockSteer.IsNearlyZero())
+		{
+			Steer(Update, Rotations[i], 0.0f);
+		}
+		else
+		{
+			Steer(Update, AvoidTerrain(i, (Rotations[i].Vector() + FlockSteer).Rotation()), TurnSpeeds[i] * 0.1f);
+		}
+		return;
+	}
+
+	if (bInFormation)
+	{
+		// Wingmen hold their slot until the leader closes on the target
+		Update.State = EAIState::Seeking;
+		const FVector Direction = (FormationGoal - Locations[i]).GetSafeNormal() + FlockSteer;
+		Steer(Update, AvoidTerrain(i, Direction.Rotation()), TurnSpeeds[i] * 0.1f);
+	}
+	else
+	{
+		MoveAndTurn(Update, TrackedLocation, FlockSteer);
+	}
+
+	if (Update.WeaponCooldown <= 0.0f)
+	{
+		// Rounds take Distance / MuzzleSpeed to arrive, so aim where the track will be by then
+		const float LeadTime = FVector::Dist(TrackedLocation, Locations[i]) / FMath::Max(MuzzleSpeeds[i], 1.0f);
+		const FVector DirectionToTarget = (TrackedLocation + Track->Velocity * LeadTime - Locations[i]).GetSafeNormal();
+		const FAISignificanceTier* Tier = SignificanceTiers.IsValidIndex(SignificanceTierIndices[i]) ? &SignificanceTiers[SignificanceTierIndices[i]] : nullptr;
+		Update.bEvaluateFire = true;
+		Update.bFire = FVector::DotProduct(Rotations[i].Vector(), DirectionToTarget) > FireAngleThresholds[i];
+		Update.WeaponCooldown = Tier ? Tier->WeaponEvaluationInterval : 0.0f;
+	}
+}
+
+bool UAIFlightSubsystem::GetFormationGoal(int32 Index, const FVector& TargetLocation, FVector& OutGoal) const
+{
+	const AAIAircraftPawn* Leader = Leaders[Index].Get();
+	if (!Leader) return false;
+
+	const int32 LeaderIndex = Leader->FlightIndex;
+	if (!Pawns.IsValidIndex(LeaderIndex) || Pawns[LeaderIndex] != Leader || States[LeaderIndex] == EAIState::Evading) return false;
+	if (FVector::DistSquared(Locations[LeaderIndex], TargetLocation) < FMath::Square(FormationBreakDistance)) return false;
+
+	// Aim ahead of the slot along the leader's heading, so the wingman slides into the slot flying parallel to the
+	// leader rather than chasing the point itself
+	const FRotator& LeaderRotation = Rotations[LeaderIndex];
+	OutGoal = Locations[LeaderIndex] + LeaderRotation.RotateVector(FormationSlots[Index]) + LeaderRotation.Vector() * FormationLookAhead;
+	return true;
+}
+
+FVector UAIFlightSubsystem::ComputeFlocking(int32 Index, TArray<int32>& Neighbors, bool bSeparationOnly) const
+{
+	if (!Registry || MaxNeighbors <= 0) return FVector::ZeroVector;
+
+	// The registry grid is rebuilt once per frame, so this costs a few cells per aircraft rather than a pass over all of them
+	Neighbors.Reset();
+	Registry->QueryKNearest(Locations[Index], MaxNeighbors + 1, NeighborRadius, Neighbors);
+
+	const FVector& Location = Locations[Index];
+	FVector Separation = FVector::ZeroVector;
+	FVector HeadingSum = FVector::ZeroVector;
+	FVector LocationSum = FVector::ZeroVector;
+	int32 NumFlockmates = 0;
+	for (int32 Entry : Neighbors)
+	{
+		if (Registry->GetEntryAircraft(Entry) == Pawns[Index]) continue;
+
+		// Keep clear of everyone, friend or foe
+		const FVector Away = Location - Registry->GetEntryLocation(Entry);
+		const float Distance = Away.Size();
+		if (Distance < SeparationRadius && Distance > KINDA_SMALL_NUMBER)
+		{
+			Separation += Away / Distance * (1.0f - Distance / SeparationRadius);
+		}
+
+		// Only flock with the own team
+		if (Registry->GetEntryTeam(Entry) == Teams[Index])
+		{
+			HeadingSum += Registry->GetEntryVelocity(Entry).GetSafeNormal();
+			LocationSum += Registry->GetEntryLocation(Entry);
+			++NumFlockmates;
+		}
+	}
+
+	FVector Steer = Separation * SeparationWeight;
+	if (!bSeparationOnly && NumFlockmates > 0)
+	{
+		const FVector Heading = Velocities[Index].GetSafeNormal(UE_SMALL_NUMBER, Rotations[Index].Vector());
+		Steer += (HeadingSum / NumFlockmates - Heading) * AlignmentWeight;
+		Steer += (LocationSum / NumFlockmates - Location).GetSafeNormal() * CohesionWeight;
+	}
+	return Steer;
+}
+
+void UAIFlightSubsystem::ApplyUpdate(const FAIUpdate& Update)
+{
+	const int32 i = Update.Index;
+
+	States[i] = Update.State;
+	EvasionTimeRemaining[i] = Update.EvasionTimeRemaining;
+	WeaponCooldowns[i] = Update.WeaponCooldown;
+	if (Update.bLostTarget)
+	{
+		Targets[i] = nullptr;
+	}
+
+	if (Update.bSimulatingPhysics)
+	{
+		if (Update.Rotation != Rotations[i])
+		{
+			Rotations[i] = Update.Rotation;
+			Meshes[i]->SetWorldRotation(Update.Rotation);
+		}
+		ApplyThrust(i, Update.StepTime);
+	}
+	else
+	{
+		MoveKinematic(i, Update);
+	}
+
+	// The gun runs on the aircraft's own update interval; rounds that fell due in between are fired together
+	UWeaponComponent* Weapon = Pawns[i]->WeaponComponent;
+	if (Update.bEvaluateFire)
+	{
+		Weapon->SetTriggerHeld(Update.bFire);
+	}
+	Weapon->UpdateWeapon(Update.StepTime);
+}
+
+void UAIFlightSubsystem::AssignTargets()
+{
+	FLIGHTSIM_STAT_SCOPE(AssignTargets);
+
+	if (!Sensors) return;
+
+	const int32 NumAttackers = Pawns.Num();
+	const int32 K = FMath::Max(CandidatesPerAttacker, 1);
+	const double Now = Sensors->GetTime();
+	const float MaxTargetDistanceSquared = FMath::Square(MaxTargetDistance);
+
+	// 1. Gather the K nearest hostile tracks per attacker and their distance/geometry cost. Attackers only know
+	//    what their own sensor has found, so an aircraft can be jumped by one it has not seen.
+	AssignmentCandidates.SetNumUninitialized(NumAttackers * K);
+	BestBaseCosts.SetNumUninitialized(NumAttackers);
+	for (int32 i = 0; i < NumAttackers; ++i)
+	{
+		NearbyTracks.Reset();
+		if (const TArray<FSensorTrack>* Tracks = Sensors->FindTracks(Pawns[i]))
+		{
+			for (const FSensorTrack& Track : *Tracks)
+			{
+				if (!Track.IsValid() || Track.Team == Teams[i] || !Track.Target.IsValid()) continue;
+
+				const FVector TrackLocation = Track.PredictLocation(Now);
+				const float DistanceSquared = FVector::DistSquared(TrackLocation, Locations[i]);
+				if (DistanceSquared > MaxTargetDistanceSquared) continue;
+
+				// Keep only the K nearest, in order. K is small, so insertion beats sorting the whole track file.
+				if (NearbyTracks.Num() == K && DistanceSquared >= NearbyTracks.Last().DistanceSquared) continue;
+
+				int32 Insert = NearbyTracks.Num();
+				while (Insert > 0 && NearbyTracks[Insert - 1].DistanceSquared > DistanceSquared)
+				{
+					--Insert;
+				}
+				if (NearbyTracks.Num() == K)
+				{
+					NearbyTracks.Pop(EAllowShrinking::No);
+				}
+				NearbyTracks.Insert(FNearbyTrack{ &Track, TrackLocation, DistanceSquared }, Insert);
+			}
+		}
+
+		const FVector Forward = Rotations[i].Vector();
+		float BestCost = UE_BIG_NUMBER;
+		for (int32 c = 0; c < K; ++c)
+		{
+			FAssignmentCandidate& Candidate = AssignmentCandidates[i * K + c];
+			if (!NearbyTracks.IsValidIndex(c))
+			{
+				Candidate.Target = nullptr;
+				continue;
+			}
+
+			const FNearbyTrack& Nearby = NearbyTracks[c];
+			const FVector ToTarget = Nearby.Location - Locations[i];
+			const float Distance = ToTarget.Size();
+			const FVector DirectionToTarget = Distance > KINDA_SMALL_NUMBER ? ToTarget / Distance : Forward;
+
+			// How far the target is off our nose, and how far we are off its tail
+			const float NoseOff = 1.0f - FVector::DotProduct(Forward, DirectionToTarget);
+			const FVector TargetHeading = Nearby.Track->Velocity.GetSafeNormal();
+			const float TailOff = TargetHeading.IsZero() ? 1.0f : 1.0f - FVector::DotProduct(TargetHeading, DirectionToTarget);
+
+			Candidate.Target = Nearby.Track->Target.Get();
+			Candidate.BaseCost = Distance / MaxTargetDistance + NoseAngleWeight * NoseOff + AspectWeight * TailOff;
+			BestCost = FMath::Min(BestCost, Candidate.BaseCost);
+		}
+		BestBaseCosts[i] = BestCost;
+	}
+
+	// 2. Attackers with the clearest shot choose first. O(n log n).
+	AssignmentOrder.SetNumUninitialized(NumAttackers);
+	for (int32 i = 0; i < NumAttackers; ++i)
+	{
+		AssignmentOrder[i] = i;
+	}
+	AssignmentOrder.Sort([this](int32 A, int32 B) { return BestBaseCosts[A] < BestBaseCosts[B]; });
+
+	// 3. Greedy pick, penalizing targets that already have attackers so the furball spreads out
+	// Attackers on the same target fly in groups of FormationSize: the first to choose it leads, the rest take vee slots
+	AttackerCounts.Reset();
+	GroupLeaders.Reset();
+	const int32 GroupSize = FMath::Max(FormationSize, 1);
+	for (int32 i : AssignmentOrder)
+	{
+		APawn* BestTarget = nullptr;
+		float BestCost = UE_BIG_NUMBER;
+		for (int32 c = 0; c < K; ++c)
+		{
+			const FAssignmentCandidate& Candidate = AssignmentCandidates[i * K + c];
+			if (!Candidate.Target) continue;
+
+			const int32* Count = AttackerCounts.Find(Candidate.Target);
+			const float Cost = Candidate.BaseCost + AttackerCountWeight * (Count ? *Count : 0);
+			if (Cost < BestCost)
+			{
+				BestCost = Cost;
+				BestTarget = Candidate.Target;
+			}
+		}
+
+		Targets[i] = BestTarget;
+		Leaders[i] = nullptr;
+		FormationSlots[i] = FVector::ZeroVector;
+		if (!BestTarget) continue;
+
+		int32& Count = AttackerCounts.FindOrAdd(BestTarget);
+		const int32 Slot = Count++ % GroupSize;
+		if (Slot == 0)
+		{
+			GroupLeaders.Add(BestTarget, Pawns[i]);
+		}
+		else
+		{
+			// Alternating right and left, one step further back and out per pair
+			const int32 Rank = (Slot + 1) / 2;
+			const float Side = Slot % 2 == 1 ? 1.0f : -1.0f;
+			Leaders[i] = GroupLeaders.FindRef(BestTarget);
+			FormationSlots[i] = FVector(-Rank * FormationSpacing, Side * Rank * FormationSpacing, 0.0f);
+		}
+	}
+}
+
+void UAIFlightSubsystem::MoveAndTurn(FAIUpdate& Update, const FVector& TargetActorLocation, const FVector& FlockSteer) const
+{
+	const int32 Index = Update.Index;
+	const FVector& Location = Locations[Index];
+	const float DistanceToTarget = FVector::Dist(TargetActorLocation, Location);
+
+	FVector TargetLocation;
+	if (DistanceToTarget < AvoidanceDistances[Index])
+	{
+		Update.State = EAIState::Circling;
+		const FVector RightVector = FRotationMatrix(Rotations[Index]).GetScaledAxis(EAxis::Y);
+		TargetLocation = TargetActorLocation + (RightVector * CirclingOffsets[Index]);
+	}
+	else
+	{
+		Update.State = EAIState::Seeking;
+		TargetLocation = TargetActorLocation;
+	}
+
+	const FVector DirectionToTarget = (TargetLocation - Location).GetSafeNormal() + FlockSteer;
+	Steer(Update, AvoidTerrain(Index, DirectionToTarget.Rotation()), TurnSpeeds[Index] * 0.1f);
+}
+
+void UAIFlightSubsystem::PerformEvasion(FAIUpdate& Update) const
+{
+	const int32 Index = Update.Index;
+	const FRotator EvasionRotation = Rotations[Index] + FRotator(0.0f, 90.0f, 0.0f);
+	Steer(Update, AvoidTerrain(Index, EvasionRotation), TurnSpeeds[Index] * 0.2f);
+}
+
+void UAIFlightSubsystem::Steer(FAIUpdate& Update, const FRotator& DesiredRotation, float InterpSpeed) const
+{
+	if (!Update.bSimulatingPhysics)
+	{
+		IntegrateKinematic(Update, DesiredRotation.Vector());
+		return;
+	}
+
+	// Rotation and thrust are applied on the game thread
+	Update.Rotation = FMath::RInterpTo(Rotations[Update.Index], DesiredRotation, Update.StepTime, InterpSpeed);
+}
+
+FRotator UAIFlightSubsystem::AvoidTerrain(int32 Index, const FRotator& DesiredRotation) const
+{
+	if (!Terrain) return DesiredRotation;
+
+	// Check clearance where the aircraft will be shortly, so it starts climbing before the terrain arrives
+	float Clearance;
+	const FVector PredictedLocation = Locations[Index] + Velocities[Index] * TerrainLookAheadTime;
+	if (!Terrain->GetHeightAboveGround(PredictedLocation, Clearance) || Clearance >= MinTerrainClearance)
+	{
+		return DesiredRotation;
+	}
+
+	FRotator PullUp = DesiredRotation;
+	PullUp.Pitch = FMath::Max(FRotator::NormalizeAxis(PullUp.Pitch), PullUpPitch);
+	return PullUp;
+}
+
+void UAIFlightSubsystem::ApplyThrust(int32 Index, float DeltaTime)
+{
+	if (Velocities[Index].SizeSquared() < FMath::Square(MaxSpeeds[Index]))
+	{
+		// The force lasts one physics frame, so scale it up when this step covers skipped frames
+		const float StepScale = FrameDeltaTime > KINDA_SMALL_NUMBER ? DeltaTime / FrameDeltaTime : 1.0f;
+		Meshes[Index]->AddForce(Rotations[Index].Vector() * FlightSpeeds[Index] * 100.0f * StepScale);
+	}
+}
+
+void UAIFlightSubsystem::IntegrateKinematic(FAIUpdate& Update, const FVector& DesiredDirection) const
+{
+	const int32 Index = Update.Index;
+	const float DeltaTime = Update.StepTime;
+
+	Update.Rotation = Rotations[Index];
+	Update.Velocity = Velocities[Index];
+	Update.Location = Locations[Index];
+	if (DeltaTime <= 0.0f) return;
+
+	constexpr float Gravity = 980.0f;
+
+	float Speed = Velocities[Index].Size();
+	const FVector Heading = Speed > KINDA_SMALL_NUMBER ? Velocities[Index] / Speed : Rotations[Index].Vector();
+
+	// Thrust along the flight path; lift is assumed to balance gravity
+	Speed = FMath::Min(Speed + FlightSpeeds[Index] * DeltaTime, MaxSpeeds[Index]);
+
+	// Turn the flight path toward the goal, limited by the airframe's turn rate and by the load factor at this speed
+	const float MaxTurnRate = FMath::Min(FMath::DegreesToRadians(TurnSpeeds[Index]),
+		Gravity * FMath::Sqrt(FMath::Max(FMath::Square(MaxLoadFactor) - 1.0f, 0.0f)) / FMath::Max(Speed, 1.0f));
+	const float AngleToGoal = FMath::Acos(FMath::Clamp(FVector::DotProduct(Heading, DesiredDirection), -1.0f, 1.0f));
+
+	FVector NewHeading = Heading;
+	if (AngleToGoal > KINDA_SMALL_NUMBER)
+	{
+		FVector TurnAxis = FVector::CrossProduct(Heading, DesiredDirection);
+		if (!TurnAxis.Normalize())
+		{
+			// Goal directly behind, break horizontally
+			TurnAxis = FVector::UpVector;
+		}
+		NewHeading = Heading.RotateAngleAxisRad(FMath::Min(AngleToGoal, MaxTurnRate * DeltaTime), TurnAxis).GetSafeNormal();
+	}
+
+	// Coordinated turn: bank until lift provides the horizontal centripetal acceleration
+	const FRotator OldRotation = Heading.Rotation();
+	FRotator NewRotation = NewHeading.Rotation();
+	const float YawRate = FMath::DegreesToRadians(FRotator::NormalizeAxis(NewRotation.Yaw - OldRotation.Yaw)) / DeltaTime;
+	const float TargetBank = FMath::RadiansToDegrees(FMath::Atan(Speed * YawRate / Gravity));
+	NewRotation.Roll = FMath::FInterpConstantTo(FRotator::NormalizeAxis(Rotations[Index].Roll), TargetBank, DeltaTime, BankRate);
+
+	// The move itself, and any sweep it needs, happens on the game thread
+	Update.Rotation = NewRotation;
+	Update.Velocity = NewHeading * Speed;
+	Update.Location = Locations[Index] + Update.Velocity * DeltaTime;
+}
+
+void UAIFlightSubsystem::MoveKinematic(int32 Index, const FAIUpdate& Update)
+{
+	FVector Velocity = Update.Velocity;
+	UStaticMeshComponent* Mesh = Meshes[Index];
+	if (NeedsSweep(Index, Velocity.Size() * Update.StepTime))
+	{
+		FHitResult Hit;
+		Mesh->SetWorldLocationAndRotation(Update.Location, Update.Rotation, true, &Hit);
+		if (Hit.bBlockingHit)
+		{
+			// Slide along whatever was hit instead of pushing into it again next step
+			Velocity = FVector::VectorPlaneProject(Velocity, Hit.ImpactNormal);
+		}
+		Locations[Index] = Mesh->GetComponentLocation();
+	}
+	else
+	{
+		Mesh->SetWorldLocationAndRotation(Update.Location, Update.Rotation);
+		Locations[Index] = Update.Location;
+	}
+
+	Rotations[Index] = Update.Rotation;
+	Velocities[Index] = Velocity;
+
+	// Not simulating, so this is what GetVelocity reports to the registry and weapons
+	Mesh->ComponentVelocity = Velocity;
+}
+
+bool UAIFlightSubsystem::NeedsSweep(int32 Index, float MoveDistance)
+{
+	if (Terrain && Terrain->IsNearGround(Locations[Index]))
+	{
+		return true;
+	}
+
+	if (!Registry) return true;
+
+	// The aircraft itself is always in the result
+	NearbyEntries.Reset();
+	Registry->QueryRadius(Locations[Index], SweepProximity + Meshes[Index]->Bounds.SphereRadius + MoveDistance, NearbyEntries);
+	return NearbyEntries.Num() > 1;
+}
@@ -0,0 +1,108 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#include "AerodynamicProfile.h"
+
+UAerodynamicProfile::UAerodynamicProfile()
+{
+	AngleOfAttackSamples = 256;
+	MachSamples = 16;
+	AirspeedSamples = 64;
+}
+
+const FAeroTables& UAerodynamicProfile::GetTables()
+{
+	if (!Tables.IsValid())
+	{
+		BakeTables();
+	}
+	return Tables;
+}
+
+void UAerodynamicProfile::PostLoad()
+{
+	Super::PostLoad();
+	BakeTables();
+}
+
+#if WITH_EDITOR
+void UAerodynamicProfile::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	BakeTables();
+}
+#endif
+
+void UAerodynamicProfile::BakeTables()
+{
+	const int32 AlphaCount = FMath::Max(AngleOfAttackSamples, 2);
+	const FRichCurve* Lift = LiftCurve.GetRichCurveConst();
+
+	// Sample angles are spaced uniformly in sin(alpha), which is what the flight model looks up by
+	TArray<float> SampleAngles;
+	SampleAngles.SetNumUninitialized(AlphaCount);
+	Tables.Lift.SetNumUninitialized(AlphaCount);
+	for (int32 i = 0; i < AlphaCount; ++i)
+	{
+		const float SinAlpha = -1.0f + 2.0f * i / (AlphaCount - 1);
+		SampleAngles[i] = FMath::RadiansToDegrees(FMath::Asin(SinAlpha));
+		Tables.Lift[i] = Lift ? Lift->Eval(SampleAngles[i]) : 0.0f;
+	}
+
+	// Drag: one column per Mach sample, blended from the two authored curves that bracket it
+	TArray<const FAeroDragCurve*> SortedDrag;
+	for (const FAeroDragCurve& Curve : DragCurves)
+	{
+		SortedDrag.Add(&Curve);
+	}
+	SortedDrag.Sort([](const FAeroDragCurve& A, const FAeroDragCurve& B) { return A.Mach < B.Mach; });
+
+	Tables.MaxMach = SortedDrag.Num() > 1 ? SortedDrag.Last()->Mach : 0.0f;
+	Tables.DragMachSamples = Tables.MaxMach > 0.0f ? FMath::Max(MachSamples, 2) : 1;
+	Tables.Drag.SetNumZeroed(AlphaCount * Tables.DragMachSamples);
+
+	for (int32 Column = 0; Column < Tables.DragMachSamples && SortedDrag.Num() > 0; ++Column)
+	{
+		const float Mach = Tables.DragMachSamples > 1 ? Tables.MaxMach * Column / (Tables.DragMachSamples - 1) : 0.0f;
+
+		int32 Upper = 0;
+		while (Upper < SortedDrag.Num() - 1 && SortedDrag[Upper]->Mach < Mach)
+		{
+			++Upper;
+		}
+		const int32 LowerIndex = FMath::Max(Upper - 1, 0);
+		const FAeroDragCurve& LowerCurve = *SortedDrag[LowerIndex];
+		const FAeroDragCurve& UpperCurve = *SortedDrag[Upper];
+		const float MachSpan = UpperCurve.Mach - LowerCurve.Mach;
+		const float Blend = MachSpan > UE_KINDA_SMALL_NUMBER ? FMath::Clamp((Mach - LowerCurve.Mach) / MachSpan, 0.0f, 1.0f) : 0.0f;
+
+		const FRichCurve* DragLower = LowerCurve.DragCurve.GetRichCurveConst();
+		const FRichCurve* DragUpper = UpperCurve.DragCurve.GetRichCurveConst();
+		for (int32 Row = 0; Row < AlphaCount; ++Row)
+		{
+			const float CdLower = DragLower ? DragLower->Eval(SampleAngles[Row]) : 0.0f;
+			const float CdUpper = DragUpper ? DragUpper->Eval(SampleAngles[Row]) : 0.0f;
+			Tables.Drag[Row * Tables.DragMachSamples + Column] = FMath::Lerp(CdLower, CdUpper, Blend);
+		}
+	}
+
+	// Control effectiveness over the authored airspeed range; full authority if no curve is set
+	const FRichCurve* Effectiveness = ControlEffectivenessCurve.GetRichCurveConst();
+	if (Effectiveness && Effectiveness->GetNumKeys() > 0)
+	{
+		float MinSpeed, MaxSpeed;
+		Effectiveness->GetTimeRange(MinSpeed, MaxSpeed);
+		Tables.MaxControlSpeed = FMath::Max(MaxSpeed, 1.0f);
+
+		const int32 SpeedCount = FMath::Max(AirspeedSamples, 2);
+		Tables.ControlEffectiveness.SetNumUninitialized(SpeedCount);
+		for (int32 i = 0; i < SpeedCount; ++i)
+		{
+			Tables.ControlEffectiveness[i] = Effectiveness->Eval(Tables.MaxControlSpeed * i / (SpeedCount - 1));
+		}
+	}
+	else
+	{
+		Tables.ControlEffectiveness = { 1.0f, 1.0f };
+		Tables.MaxControlSpeed = 1.0f;
+	}
+}
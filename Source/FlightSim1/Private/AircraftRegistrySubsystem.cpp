@@ -0,0 +1,229 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#include "AircraftRegistrySubsystem.h"
+#include "GameFramework/Pawn.h"
+#include "GenericTeamAgentInterface.h"
+#include "FlightSimProfiling.h"
+
+bool UAircraftRegistrySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UAircraftRegistrySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAircraftRegistrySubsystem, STATGROUP_Tickables);
+}
+
+void UAircraftRegistrySubsystem::RegisterAircraft(APawn* NewAircraft)
+{
+	if (!NewAircraft || EntryLookup.Contains(NewAircraft)) return;
+
+	// New entries are not part of the grid until the next rebuild, but are immediately visible through the accessors
+	const int32 Entry = Aircraft.Add(NewAircraft);
+	Locations.Add(NewAircraft->GetActorLocation());
+	Velocities.Add(NewAircraft->GetVelocity());
+	Teams.Add(FGenericTeamId::GetTeamIdentifier(NewAircraft).GetId());
+	RemovedEntries.Add(false);
+	EntryLookup.Add(NewAircraft, Entry);
+}
+
+void UAircraftRegistrySubsystem::UnregisterAircraft(APawn* OldAircraft)
+{
+	int32 Entry = INDEX_NONE;
+	if (!EntryLookup.RemoveAndCopyValue(OldAircraft, Entry)) return;
+
+	// Keep indices stable until the next rebuild so grid ranges and in-flight query results stay valid
+	Aircraft[Entry] = nullptr;
+	RemovedEntries[Entry] = true;
+	bHasRemovedEntries = true;
+}
+
+void UAircraftRegistrySubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	FLIGHTSIM_SCOPE(AI, RegistryRebuild);
+
+	RebuildGrid();
+	FLIGHTSIM_SET_COUNTER(LiveAircraft, GetNumEntries());
+}
+
+FIntVector UAircraftRegistrySubsystem::GetCell(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt32(Location.X / CellSize),
+		FMath::FloorToInt32(Location.Y / CellSize),
+		FMath::FloorToInt32(Location.Z / CellSize));
+}
+
+void UAircraftRegistrySubsystem::RebuildGrid()
+{
+	// Compact out entries removed since the last rebuild
+	if (bHasRemovedEntries)
+	{
+		for (int32 Entry = Aircraft.Num() - 1; Entry >= 0; --Entry)
+		{
+			if (!RemovedEntries[Entry]) continue;
+
+			Aircraft.RemoveAtSwap(Entry, EAllowShrinking::No);
+			Locations.RemoveAtSwap(Entry, EAllowShrinking::No);
+			Velocities.RemoveAtSwap(Entry, EAllowShrinking::No);
+			Teams.RemoveAtSwap(Entry, EAllowShrinking::No);
+			if (Aircraft.IsValidIndex(Entry))
+			{
+				EntryLookup.FindChecked(Aircraft[Entry]) = Entry;
+			}
+		}
+		RemovedEntries.Init(false, Aircraft.Num());
+		bHasRemovedEntries = false;
+	}
+
+	// Snapshot positions once for the whole frame
+	const int32 NumEntries = Aircraft.Num();
+	Keyed.Reset(NumEntries);
+	for (int32 Entry = 0; Entry < NumEntries; ++Entry)
+	{
+		Locations[Entry] = Aircraft[Entry]->GetActorLocation();
+		Velocities[Entry] = Aircraft[Entry]->GetVelocity();
+		Keyed.Emplace(GetCell(Locations[Entry]), Entry);
+	}
+
+	// Sort by cell so every cell is a contiguous run
+	Keyed.Sort([](const TPair<FIntVector, int32>& A, const TPair<FIntVector, int32>& B)
+	{
+		if (A.Key.X != B.Key.X) return A.Key.X < B.Key.X;
+		if (A.Key.Y != B.Key.Y) return A.Key.Y < B.Key.Y;
+		return A.Key.Z < B.Key.Z;
+	});
+
+	SortedEntries.Reset(NumEntries);
+	CellRanges.Reset();
+	for (int32 i = 0; i < Keyed.Num(); ++i)
+	{
+		SortedEntries.Add(Keyed[i].Value);
+
+		FIntPoint& Range = CellRanges.FindOrAdd(Keyed[i].Key, FIntPoint(i, 0));
+		Range.Y++;
+	}
+}
+
+template <typename PredicateType>
+void UAircraftRegistrySubsystem::GatherFromCells(const FVector& Center, float Radius, PredicateType&& Predicate) const
+{
+	const FIntVector MinCell = GetCell(Center - FVector(Radius));
+	const FIntVector MaxCell = GetCell(Center + FVector(Radius));
+	const int64 BoxCellCount = int64(MaxCell.X - MinCell.X + 1) * (MaxCell.Y - MinCell.Y + 1) * (MaxCell.Z - MinCell.Z + 1);
+
+	auto VisitRange = [this, &Predicate](const FIntPoint& Range)
+	{
+		for (int32 i = Range.X; i < Range.X + Range.Y; ++i)
+		{
+			const int32 Entry = SortedEntries[i];
+			if (!RemovedEntries[Entry])
+			{
+				Predicate(Entry);
+			}
+		}
+	};
+
+	// Large query volumes over a sparse grid are cheaper to answer by walking the occupied cells
+	if (BoxCellCount > CellRanges.Num())
+	{
+		for (const TPair<FIntVector, FIntPoint>& Cell : CellRanges)
+		{
+			if (Cell.Key.X >= MinCell.X && Cell.Key.X <= MaxCell.X &&
+				Cell.Key.Y >= MinCell.Y && Cell.Key.Y <= MaxCell.Y &&
+				Cell.Key.Z >= MinCell.Z && Cell.Key.Z <= MaxCell.Z)
+			{
+				VisitRange(Cell.Value);
+			}
+		}
+		return;
+	}
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+			{
+				if (const FIntPoint* Range = CellRanges.Find(FIntVector(X, Y, Z)))
+				{
+					VisitRange(*Range);
+				}
+			}
+		}
+	}
+}
+
+void UAircraftRegistrySubsystem::QueryRadius(const FVector& Center, float Radius, TArray<int32>& OutEntries) const
+{
+	const float RadiusSquared = FMath::Square(Radius);
+	GatherFromCells(Center, Radius, [&](int32 Entry)
+	{
+		if (FVector::DistSquared(Locations[Entry], Center) <= RadiusSquared)
+		{
+			OutEntries.Add(Entry);
+		}
+	});
+}
+
+void UAircraftRegistrySubsystem::QueryCone(const FVector& Origin, const FVector& Direction, float CosHalfAngle, float Range, TArray<int32>& OutEntries) const
+{
+	const float RangeSquared = FMath::Square(Range);
+	GatherFromCells(Origin, Range, [&](int32 Entry)
+	{
+		const FVector ToEntry = Locations[Entry] - Origin;
+		const float DistanceSquared = ToEntry.SizeSquared();
+		if (DistanceSquared > RangeSquared || DistanceSquared < KINDA_SMALL_NUMBER) return;
+
+		// Compare against the cosine scaled by distance to avoid normalizing
+		const float Projection = FVector::DotProduct(ToEntry, Direction);
+		if (Projection > 0.0f && FMath::Square(Projection) >= FMath::Square(CosHalfAngle) * DistanceSquared)
+		{
+			OutEntries.Add(Entry);
+		}
+	});
+}
+
+template <typename FilterType>
+void UAircraftRegistrySubsystem::GatherKNearest(const FVector& Center, int32 K, float MaxRadius, FilterType&& Filter, TArray<int32>& OutEntries) const
+{
+	if (K <= 0) return;
+
+	// Double the search radius, starting at one cell, until enough candidates are found
+	TArray<int32, TInlineAllocator<32>> Candidates;
+	float Radius = FMath::Min(CellSize, MaxRadius);
+	while (true)
+	{
+		Candidates.Reset();
+		const float RadiusSquared = FMath::Square(Radius);
+		GatherFromCells(Center, Radius, [&](int32 Entry)
+		{
+			if (Filter(Entry) && FVector::DistSquared(Locations[Entry], Center) <= RadiusSquared)
+			{
+				Candidates.Add(Entry);
+			}
+		});
+
+		if (Candidates.Num() >= K || Radius >= MaxRadius) break;
+		Radius = FMath::Min(Radius * 2.0f, MaxRadius);
+	}
+
+	Candidates.Sort([this, &Center](int32 A, int32 B)
+	{
+		return FVector::DistSquared(Locations[A], Center) < FVector::DistSquared(Locations[B], Center);
+	});
+
+	OutEntries.Append(Candidates.GetData(), FMath::Min(K, Candidates.Num()));
+}
+
+void UAircraftRegistrySubsystem::QueryKNearest(const FVector& Center, int32 K, float MaxRadius, TArray<int32>& OutEntries) const
+{
+	GatherKNearest(Center, K, MaxRadius, [](int32) { return true; }, OutEntries);
+}
+
+void UAircraftRegistrySubsystem::QueryKNearestHostiles(const FVector& Center, uint8 Team, int32 K, float MaxRadius, TArray<int32>& OutEntries) const
+{
+	GatherKNearest(Center, K, MaxRadius, [this, Team](int32 Entry) { return Teams[Entry] != Team; }, OutEntries);
+}
@@ -8,6 +8,7 @@
 #include "EnhancedInputComponent.h"
 #include "InputActionValue.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "FlightSimProfiling.h"
 
 // Sets default values
 AAirplanePawn::AAirplanePawn()
@@ -60,35 +61,22 @@ void AAirplanePawn::Tick(float DeltaTime)
 	CurrentThrottle = FMath::FInterpTo(CurrentThrottle, TargetThrottle, DeltaTime, ThrottleChangeSpeed);
 
 	// --- Physics Forces ---
+	// Thrust, lift, drag and control torques come from the basic model in FlightModel
 	if (AirframeMesh)
 	{
-		// 1. THRUST
-		const FVector ThrustForce = AirframeMesh->GetForwardVector() * CurrentThrottle * EnginePower;
-		AirframeMesh->AddForce(ThrustForce);
-
-		// 2. LIFT
-		const FVector Velocity = AirframeMesh->GetPhysicsLinearVelocity();
-		const double SpeedSquared = Velocity.SizeSquared();
-		const FVector LiftDirection = AirframeMesh->GetUpVector();
-		const FVector LiftForce = LiftDirection * SpeedSquared * LiftCoefficient;
-		AirframeMesh->AddForce(LiftForce);
-
-		// 3. DRAG
-		const FVector DragForce = -Velocity * Velocity.Size() * DragCoefficient;
-		AirframeMesh->AddForce(DragForce);
-
-		// 4. CONTROL TORQUES (Pitch, Roll, Yaw)
-		// Pitch
-		const FVector PitchTorque = AirframeMesh->GetRightVector() * PitchInput * ControlStrength;
-		AirframeMesh->AddTorqueInRadians(PitchTorque);
-
-		// Roll
-		const FVector RollTorque = AirframeMesh->GetForwardVector() * RollInput * ControlStrength;
-		AirframeMesh->AddTorqueInRadians(RollTorque);
-
-		// Yaw
-		const FVector YawTorque = AirframeMesh->GetUpVector() * YawInput * ControlStrength;
-		AirframeMesh->AddTorqueInRadians(YawTorque);
+		FLIGHTSIM_SCOPE(Aerodynamics, BasicAerodynamics);
+
+		FlightModelBatch.SetNum(1);
+		FlightModelBatch.SetState(0, AirframeMesh->GetPhysicsLinearVelocity(), AirframeMesh->GetForwardVector(), AirframeMesh->GetRightVector(), AirframeMesh->GetUpVector());
+		FlightModelBatch.SetControls(0, static_cast<float>(CurrentThrottle), static_cast<float>(PitchInput), static_cast<float>(RollInput), static_cast<float>(YawInput), true);
+
+		const float Control = static_cast<float>(ControlStrength);
+		FlightModelBatch.SetTuning(0, static_cast<float>(EnginePower), static_cast<float>(LiftCoefficient), static_cast<float>(DragCoefficient), Control, Control, Control);
+
+		FlightModel::EvaluateBasicAerodynamics(FlightModelBatch);
+
+		AirframeMesh->AddForce(FlightModelBatch.GetForce(0));
+		AirframeMesh->AddTorqueInRadians(FlightModelBatch.GetTorque(0));
 	}
 }
 
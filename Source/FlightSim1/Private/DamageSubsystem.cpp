@@ -0,0 +1,162 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#include "DamageSubsystem.h"
+#include "FlightSim1.h"
+#include "FlightSimProfiling.h"
+#include "HealthComponent.h"
+#include "DogfightGameModeBase.h"
+#include "Engine/World.h"
+
+bool UDamageSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UDamageSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDamageSubsystem, STATGROUP_Tickables);
+}
+
+FHealthHandle UDamageSubsystem::RegisterHealth(UHealthComponent* Health)
+{
+	check(Health);
+
+	FHealthHandle Handle;
+	if (FreeSlots.Num() > 0)
+	{
+		Handle.Index = FreeSlots.Pop(EAllowShrinking::No);
+		Components[Handle.Index] = Health;
+	}
+	else
+	{
+		Handle.Index = Components.Add(Health);
+		Serials.Add(0);
+		PendingDamage.Add(0.0f);
+	}
+
+	Handle.Serial = NextSerial++;
+	Serials[Handle.Index] = Handle.Serial;
+
+	if (AActor* Owner = Health->GetOwner())
+	{
+		SlotsByActor.Add(Owner, Handle.Index);
+	}
+	return Handle;
+}
+
+void UDamageSubsystem::UnregisterHealth(FHealthHandle Handle)
+{
+	if (!IsHandleValid(Handle)) return;
+
+	if (AActor* Owner = Components[Handle.Index]->GetOwner())
+	{
+		SlotsByActor.Remove(Owner);
+	}
+
+	Components[Handle.Index] = nullptr;
+	Serials[Handle.Index] = 0;
+	FreeSlots.Add(Handle.Index);
+}
+
+bool UDamageSubsystem::IsHandleValid(FHealthHandle Handle) const
+{
+	return Components.IsValidIndex(Handle.Index) && Serials[Handle.Index] == Handle.Serial && Components[Handle.Index];
+}
+
+FHealthHandle UDamageSubsystem::FindHealth(const AActor* Target) const
+{
+	FHealthHandle Handle;
+	if (const int32* Slot = Target ? SlotsByActor.Find(Target) : nullptr)
+	{
+		Handle.Index = *Slot;
+		Handle.Serial = Serials[*Slot];
+	}
+	return Handle;
+}
+
+float UDamageSubsystem::GetHealth(FHealthHandle Handle) const
+{
+	return IsHandleValid(Handle) ? Components[Handle.Index]->GetCurrentHealth() : 0.0f;
+}
+
+void UDamageSubsystem::QueueDamage(FHealthHandle Target, float Amount, AActor* Instigator, EFlightDamageType DamageType)
+{
+	if (!Target.IsValid() || Amount <= 0.0f) return;
+
+	QueuedDamage.Add({ Target, Amount, Instigator, DamageType });
+}
+
+void UDamageSubsystem::QueueDamage(const AActor* Target, float Amount, AActor* Instigator, EFlightDamageType DamageType)
+{
+	QueueDamage(FindHealth(Target), Amount, Instigator, DamageType);
+}
+
+void UDamageSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (QueuedDamage.Num() > 0)
+	{
+		ResolveDamage();
+	}
+}
+
+void UDamageSubsystem::ResolveDamage()
+{
+	FLIGHTSIM_SCOPE(Weapons, ResolveDamage);
+
+	// 1. Sum the frame's damage per target. The hit that takes a target past zero gets the kill.
+	Kills.Reset();
+	for (const FQueuedDamage& Damage : QueuedDamage)
+	{
+		if (!IsHandleValid(Damage.Target)) continue;
+
+		const int32 Slot = Damage.Target.Index;
+		UHealthComponent* Health = Components[Slot];
+		if (Health->IsDead()) continue;
+
+		if (PendingDamage[Slot] == 0.0f)
+		{
+			DamagedSlots.Add(Slot);
+		}
+
+		const bool bWasAlive = PendingDamage[Slot] < Health->GetCurrentHealth();
+		PendingDamage[Slot] += Damage.Amount;
+		if (bWasAlive && PendingDamage[Slot] >= Health->GetCurrentHealth())
+		{
+			Kills.Add({ Health, Damage.Instigator, Damage.DamageType });
+		}
+	}
+	QueuedDamage.Reset();
+
+	// 2. Apply once per target, one OnHealthChanged each
+	for (int32 Slot : DamagedSlots)
+	{
+		if (UHealthComponent* Health = Components[Slot])
+		{
+			Health->ApplyResolvedDamage(PendingDamage[Slot]);
+		}
+		PendingDamage[Slot] = 0.0f;
+	}
+	DamagedSlots.Reset();
+
+	// 3. Kills: log, tell the game mode, then let the component run its death sequence
+	if (Kills.Num() == 0) return;
+
+	ADogfightGameModeBase* GameMode = GetWorld()->GetAuthGameMode<ADogfightGameModeBase>();
+	for (const FKill& Kill : Kills)
+	{
+		if (!IsValid(Kill.Victim)) continue;
+
+		AActor* Victim = Kill.Victim->GetOwner();
+		UE_LOG(LogFlightSim, Log, TEXT("Kill: %s destroyed %s (%s)"),
+			*GetNameSafe(Kill.Killer.Get()), *GetNameSafe(Victim), *UEnum::GetValueAsString(Kill.DamageType));
+
+		if (GameMode)
+		{
+			GameMode->AircraftDied(Cast<APawn>(Victim));
+		}
+		Kill.Victim->Die();
+	}
+	Kills.Reset();
+}
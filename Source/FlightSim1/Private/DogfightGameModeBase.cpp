@@ -3,32 +3,241 @@
 #include "DogfightGameModeBase.h"
 #include "Kismet/GameplayStatics.h"
 #include "Blueprint/UserWidget.h"
+#include "GenericTeamAgentInterface.h"
+#include "FlightSimProfiling.h"
+#include "AIAircraftPawn.h"
+#include "DroneSwarmSubsystem.h"
+#include "FlightSim1.h"
+#include "Engine/AssetManager.h"
 
 ADogfightGameModeBase::ADogfightGameModeBase()
 {
+	// Only ticks while a match start is still spawning aircraft
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+
 	NumberOfEnemiesToSpawn = 3;
 	SpawnRadius = 20000.0f;
+	SpawnSeparation = 3000.0f;
+	SpawnWaveSize = 25;
+	SpawnWaveInterval = 0.0f;
+	SpawnBudgetMs = 2.0f;
+	NumberOfAlliesToSpawn = 0;
+	NumberOfDronesToSpawn = 0;
+	DroneSpawnDistance = 300000.0f;
+	PlayerTeamId = 0;
+	EnemyTeamId = 1;
 	LivingEnemies = 0;
+	NextPendingSpawn = 0;
+	FirstWaveTime = 0.0f;
+	LoadedAIPawnClass = nullptr;
 }
 
 void ADogfightGameModeBase::BeginPlay()
 {
 	Super::BeginPlay();
+
+	if (UDroneSwarmSubsystem* DroneSwarm = GetWorld()->GetSubsystem<UDroneSwarmSubsystem>())
+	{
+		DroneSwarm->OnDroneDestroyed.AddUObject(this, &ADogfightGameModeBase::OnDroneDestroyed);
+	}
+
 	SpawnEnemies();
 }
 
 void ADogfightGameModeBase::SpawnEnemies()
 {
-	if (!AIPawnClass) return;
+	if (AIPawnClass.IsNull()) return;
+
+	// Allies start on the far side of the player so the two groups merge head-on, with their rings clear of the
+	// enemies' however many aircraft either side has
+	TArray<FPendingSpawn> Enemies;
+	TArray<FPendingSpawn> Allies;
+	AddSpawnPoints(Enemies, NumberOfEnemiesToSpawn, EnemyTeamId, FVector::ZeroVector);
+	const float AllyDistance = GetSpawnRingsRadius(NumberOfEnemiesToSpawn) + GetSpawnRingsRadius(NumberOfAlliesToSpawn) + SpawnSeparation;
+	AddSpawnPoints(Allies, NumberOfAlliesToSpawn, PlayerTeamId, FVector(-AllyDistance, 0.0f, 0.0f));
 
-	for (int32 i = 0; i < NumberOfEnemiesToSpawn; ++i)
+	// Interleave the teams so both grow at the same rate across waves
+	PendingSpawns.Reset(Enemies.Num() + Allies.Num());
+	int32 EnemyIndex = 0;
+	int32 AllyIndex = 0;
+	while (EnemyIndex < Enemies.Num() || AllyIndex < Allies.Num())
+	{
+		const bool bTakeEnemy = AllyIndex >= Allies.Num()
+			|| (EnemyIndex < Enemies.Num() && EnemyIndex * Allies.Num() <= AllyIndex * Enemies.Num());
+		PendingSpawns.Add(bTakeEnemy ? Enemies[EnemyIndex++] : Allies[AllyIndex++]);
+	}
+	NextPendingSpawn = 0;
+
+	// The pawn class and everything it references stream in off the game thread
+	AIPawnClassHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(AIPawnClass.ToSoftObjectPath(),
+		FStreamableDelegate::CreateUObject(this, &ADogfightGameModeBase::OnAIPawnClassLoaded));
+	if (!AIPawnClassHandle.IsValid())
+	{
+		UE_LOG(LogFlightSim, Error, TEXT("Could not load AI pawn class %s"), *AIPawnClass.ToString());
+		PendingSpawns.Reset();
+	}
+}
+
+void ADogfightGameModeBase::OnAIPawnClassLoaded()
+{
+	LoadedAIPawnClass = AIPawnClass.Get();
+	if (!LoadedAIPawnClass)
+	{
+		UE_LOG(LogFlightSim, Error, TEXT("Could not load AI pawn class %s"), *AIPawnClass.ToString());
+		PendingSpawns.Reset();
+		return;
+	}
+
+	SpawnDroneWave(NumberOfDronesToSpawn);
+
+	FirstWaveTime = GetWorld()->GetTimeSeconds();
+	SetActorTickEnabled(true);
+}
+
+void ADogfightGameModeBase::SpawnDroneWave(int32 Count)
+{
+	UDroneSwarmSubsystem* DroneSwarm = GetWorld()->GetSubsystem<UDroneSwarmSubsystem>();
+	if (Count <= 0 || !DroneSwarm || !LoadedAIPawnClass) return;
+
+	if (!LoadedAIPawnClass->IsChildOf<AAIAircraftPawn>())
+	{
+		UE_LOG(LogFlightSim, Error, TEXT("Drones need an AAIAircraftPawn class to promote to, %s is not one"), *LoadedAIPawnClass->GetName());
+		return;
+	}
+
+	FLIGHTSIM_STAT_SCOPE(SpawnEnemies);
+
+	// Drones are cheap to create, so the whole wave goes in at once rather than through the spawn budget
+	// Kept clear of the aircraft rings when the swarm is large
+	const float Distance = FMath::Max(DroneSpawnDistance, GetSpawnRingsRadius(NumberOfEnemiesToSpawn) + GetSpawnRingsRadius(Count) + SpawnSeparation);
+	TArray<FPendingSpawn> Spawns;
+	AddSpawnPoints(Spawns, Count, EnemyTeamId, FVector(Distance, 0.0f, 0.0f));
+
+	TArray<FVector> Locations;
+	Locations.Reserve(Spawns.Num());
+	for (const FPendingSpawn& Spawn : Spawns)
+	{
+		Locations.Add(Spawn.Location);
+	}
+
+	DroneSwarm->SpawnDrones(LoadedAIPawnClass, Locations, EnemyTeamId);
+	LivingEnemies += Locations.Num();
+}
+
+void ADogfightGameModeBase::OnDroneDestroyed(uint8 TeamId)
+{
+	if (TeamId != PlayerTeamId)
+	{
+		EnemyDied();
+	}
+}
+
+void ADogfightGameModeBase::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (IsSpawning() && LoadedAIPawnClass)
+	{
+		SpawnPendingAircraft();
+	}
+}
+
+void ADogfightGameModeBase::SpawnPendingAircraft()
+{
+	FLIGHTSIM_STAT_SCOPE(SpawnEnemies);
+
+	// Waves released so far cap how far into the queue this frame may go
+	int32 Released = PendingSpawns.Num();
+	if (SpawnWaveInterval > 0.0f)
+	{
+		const int32 Waves = FMath::FloorToInt32((GetWorld()->GetTimeSeconds() - FirstWaveTime) / SpawnWaveInterval) + 1;
+		Released = FMath::Min(Released, Waves * FMath::Max(SpawnWaveSize, 1));
+	}
+
+	const double Deadline = FPlatformTime::Seconds() + SpawnBudgetMs * 0.001;
+	while (NextPendingSpawn < Released)
+	{
+		const FPendingSpawn& Spawn = PendingSpawns[NextPendingSpawn++];
+		if (SpawnAircraft(Spawn.Location, Spawn.TeamId) && Spawn.TeamId == EnemyTeamId)
+		{
+			LivingEnemies++;
+		}
+
+		if (FPlatformTime::Seconds() >= Deadline) break;
+	}
+
+	if (NextPendingSpawn >= PendingSpawns.Num())
+	{
+		PendingSpawns.Empty();
+		NextPendingSpawn = 0;
+		SetActorTickEnabled(false);
+		AIPawnClassHandle.Reset();
+		CheckWinCondition();
+	}
+}
+
+APawn* ADogfightGameModeBase::SpawnAircraft(const FVector& Location, uint8 TeamId)
+{
+	FTransform SpawnTransform(FRotator::ZeroRotator, Location);
+
+	// Deferred so the team is set before BeginPlay registers the aircraft
+	APawn* NewPawn = GetWorld()->SpawnActorDeferred<APawn>(LoadedAIPawnClass, SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (!NewPawn) return nullptr;
+
+	if (IGenericTeamAgentInterface* TeamAgent = Cast<IGenericTeamAgentInterface>(NewPawn))
+	{
+		TeamAgent->SetGenericTeamId(FGenericTeamId(TeamId));
+	}
+	NewPawn->FinishSpawning(SpawnTransform);
+	return NewPawn;
+}
+
+void ADogfightGameModeBase::AddSpawnPoints(TArray<FPendingSpawn>& OutSpawns, int32 Count, uint8 TeamId, const FVector& Center) const
+{
+	// Concentric rings starting at SpawnRadius, each holding as many aircraft as fit SpawnSeparation apart.
+	// A random rotation per ring keeps formations from lining up between matches.
+	const float Separation = FMath::Max(SpawnSeparation, 1.0f);
+	int32 Placed = 0;
+	for (int32 Ring = 0; Placed < Count; ++Ring)
+	{
+		const float Radius = SpawnRadius + Ring * Separation;
+		const int32 Capacity = FMath::Max(FMath::FloorToInt32(UE_TWO_PI * Radius / Separation), 1);
+		const int32 OnRing = FMath::Min(Capacity, Count - Placed);
+		const float Step = UE_TWO_PI / OnRing;
+		const float Offset = FMath::FRandRange(0.0f, Step);
+
+		for (int32 i = 0; i < OnRing; ++i)
+		{
+			const float Angle = Offset + i * Step;
+			OutSpawns.Add({ Center + FVector(Radius * FMath::Cos(Angle), Radius * FMath::Sin(Angle), 2000.0f), TeamId });
+		}
+		Placed += OnRing;
+	}
+}
+
+float ADogfightGameModeBase::GetSpawnRingsRadius(int32 Count) const
+{
+	const float Separation = FMath::Max(SpawnSeparation, 1.0f);
+	float Radius = SpawnRadius;
+	for (int32 Placed = 0; Placed < Count; Radius += Separation)
+	{
+		Placed += FMath::Max(FMath::FloorToInt32(UE_TWO_PI * Radius / Separation), 1);
+		if (Placed >= Count) return Radius;
+	}
+	return Radius;
+}
+
+void ADogfightGameModeBase::AircraftDied(APawn* DeadAircraft)
+{
+	if (DeadAircraft && DeadAircraft->IsPlayerControlled())
+	{
+		PlayerDied();
+	}
+	else if (FGenericTeamId::GetTeamIdentifier(DeadAircraft) != FGenericTeamId(PlayerTeamId))
 	{
-		float Angle = FMath::FRandRange(0.0f, 360.0f);
-		FVector SpawnLocation = FVector(SpawnRadius * FMath::Cos(Angle), SpawnRadius * FMath::Sin(Angle), 2000.0f);
-		FRotator SpawnRotation = FRotator::ZeroRotator;
-		GetWorld()->SpawnActor<APawn>(AIPawnClass, SpawnLocation, SpawnRotation);
+		EnemyDied();
 	}
-	LivingEnemies = NumberOfEnemiesToSpawn;
 }
 
 void ADogfightGameModeBase::EnemyDied()
@@ -63,7 +272,7 @@ void ADogfightGameModeBase::PlayerDied()
 
 void ADogfightGameModeBase::CheckWinCondition()
 {
-	if (LivingEnemies <= 0)
+	if (LivingEnemies <= 0 && !IsSpawning())
 	{
 		if (GEngine)
 		{
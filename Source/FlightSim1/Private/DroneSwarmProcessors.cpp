@@ -0,0 +1,222 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#include "DroneSwarmProcessors.h"
+#include "DroneSwarmFragments.h"
+#include "DroneSwarmSubsystem.h"
+#include "TerrainHeightSubsystem.h"
+#include "WeaponFireSubsystem.h"
+#include "MassExecutionContext.h"
+#include "Engine/World.h"
+
+// --- Flight ---
+
+UDroneFlightProcessor::UDroneFlightProcessor()
+	: EntityQuery(*this)
+{
+	bAutoRegisterWithProcessingPhases = false;
+	ExecutionFlags = static_cast<int32>(EProcessorExecutionFlags::AllNetModes);
+}
+
+void UDroneFlightProcessor::ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager)
+{
+	EntityQuery.AddRequirement<FDroneFlightFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FDroneTargetFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FDroneHealthFragment>(EMassFragmentAccess::ReadWrite);
+}
+
+void UDroneFlightProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	const UWorld* World = EntityManager.GetWorld();
+	const UDroneSwarmSubsystem* Swarm = World ? World->GetSubsystem<UDroneSwarmSubsystem>() : nullptr;
+	if (!Swarm) return;
+
+	const TArray<UDroneSwarmSubsystem::FDroneTarget>& Targets = Swarm->GetTargets();
+	const UTerrainHeightSubsystem* Terrain = Swarm->GetTerrain();
+	const float LookAheadTime = Swarm->TerrainLookAheadTime;
+	const float MinClearance = Swarm->MinTerrainClearance;
+	const float DeltaTime = Context.GetDeltaTimeSeconds();
+
+	// Everything read here is either this drone's fragments or a snapshot taken before processing started
+	EntityQuery.ParallelForEachEntityChunk(Context, [&](FMassExecutionContext& ChunkContext)
+	{
+		const TArrayView<FDroneFlightFragment> Flights = ChunkContext.GetMutableFragmentView<FDroneFlightFragment>();
+		const TArrayView<FDroneTargetFragment> TargetFragments = ChunkContext.GetMutableFragmentView<FDroneTargetFragment>();
+		const TArrayView<FDroneHealthFragment> Healths = ChunkContext.GetMutableFragmentView<FDroneHealthFragment>();
+
+		for (int32 i = 0; i < ChunkContext.GetNumEntities(); ++i)
+		{
+			FDroneFlightFragment& Flight = Flights[i];
+			FDroneTargetFragment& Target = TargetFragments[i];
+			if (Healths[i].Health <= 0.0f) continue;
+
+			// Nearest hostile player; there are only ever a handful
+			float BestDistanceSquared = UE_BIG_NUMBER;
+			Target.TargetIndex = INDEX_NONE;
+			for (int32 t = 0; t < Targets.Num(); ++t)
+			{
+				if (Targets[t].Team == Target.Team) continue;
+
+				const float DistanceSquared = FVector::DistSquared(Targets[t].Location, Flight.Location);
+				if (DistanceSquared < BestDistanceSquared)
+				{
+					BestDistanceSquared = DistanceSquared;
+					Target.TargetIndex = t;
+				}
+			}
+			Target.DistanceToTarget = Target.TargetIndex != INDEX_NONE ? FMath::Sqrt(BestDistanceSquared) : UE_BIG_NUMBER;
+
+			const float Speed = Flight.Velocity.Size();
+			const FVector Heading = Speed > KINDA_SMALL_NUMBER ? Flight.Velocity / Speed : FVector::ForwardVector;
+
+			FVector DesiredDirection = Heading;
+			if (Target.TargetIndex != INDEX_NONE)
+			{
+				// Lead the target by roughly the time it takes to close the distance
+				const UDroneSwarmSubsystem::FDroneTarget& Hostile = Targets[Target.TargetIndex];
+				const float LeadTime = Target.DistanceToTarget / FMath::Max(Flight.MaxSpeed, 1.0f);
+				DesiredDirection = (Hostile.Location + Hostile.Velocity * LeadTime - Flight.Location).GetSafeNormal(UE_SMALL_NUMBER, Heading);
+			}
+
+			float Clearance;
+			if (Terrain && Terrain->GetHeightAboveGround(Flight.Location + Flight.Velocity * LookAheadTime, Clearance) && Clearance < MinClearance)
+			{
+				DesiredDirection.Z = FMath::Max(DesiredDirection.Z, 0.5f);
+				DesiredDirection.Normalize();
+			}
+
+			// Turn the flight path toward the goal at the turn rate limit
+			FVector NewHeading = Heading;
+			const float AngleToGoal = FMath::Acos(FMath::Clamp(FVector::DotProduct(Heading, DesiredDirection), -1.0f, 1.0f));
+			if (AngleToGoal > KINDA_SMALL_NUMBER)
+			{
+				FVector TurnAxis = FVector::CrossProduct(Heading, DesiredDirection);
+				if (!TurnAxis.Normalize())
+				{
+					TurnAxis = FVector::UpVector;
+				}
+				NewHeading = Heading.RotateAngleAxisRad(FMath::Min(AngleToGoal, Flight.TurnRate * DeltaTime), TurnAxis).GetSafeNormal();
+			}
+
+			Flight.Velocity = NewHeading * Flight.MaxSpeed;
+			Flight.Location += Flight.Velocity * DeltaTime;
+
+			float GroundZ;
+			if (Terrain && Terrain->GetGroundHeight(Flight.Location.X, Flight.Location.Y, GroundZ) && Flight.Location.Z <= GroundZ)
+			{
+				Healths[i].Health = 0.0f;
+			}
+		}
+	});
+}
+
+// --- Weapons ---
+
+UDroneWeaponProcessor::UDroneWeaponProcessor()
+	: EntityQuery(*this)
+{
+	bAutoRegisterWithProcessingPhases = false;
+	bRequiresGameThreadExecution = true;
+	ExecutionFlags = static_cast<int32>(EProcessorExecutionFlags::AllNetModes);
+}
+
+void UDroneWeaponProcessor::ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager)
+{
+	EntityQuery.AddRequirement<FDroneFlightFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FDroneTargetFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FDroneHealthFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FDroneWeaponFragment>(EMassFragmentAccess::ReadWrite);
+}
+
+void UDroneWeaponProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	UWorld* World = EntityManager.GetWorld();
+	const UDroneSwarmSubsystem* Swarm = World ? World->GetSubsystem<UDroneSwarmSubsystem>() : nullptr;
+	UWeaponFireSubsystem* WeaponFire = World ? World->GetSubsystem<UWeaponFireSubsystem>() : nullptr;
+	if (!Swarm || !WeaponFire) return;
+
+	const TArray<UDroneSwarmSubsystem::FDroneTarget>& Targets = Swarm->GetTargets();
+	const float DeltaTime = Context.GetDeltaTimeSeconds();
+
+	EntityQuery.ForEachEntityChunk(Context, [&](FMassExecutionContext& ChunkContext)
+	{
+		const TConstArrayView<FDroneFlightFragment> Flights = ChunkContext.GetFragmentView<FDroneFlightFragment>();
+		const TConstArrayView<FDroneTargetFragment> TargetFragments = ChunkContext.GetFragmentView<FDroneTargetFragment>();
+		const TConstArrayView<FDroneHealthFragment> Healths = ChunkContext.GetFragmentView<FDroneHealthFragment>();
+		const TArrayView<FDroneWeaponFragment> Weapons = ChunkContext.GetMutableFragmentView<FDroneWeaponFragment>();
+
+		for (int32 i = 0; i < ChunkContext.GetNumEntities(); ++i)
+		{
+			FDroneWeaponFragment& Weapon = Weapons[i];
+			Weapon.Cooldown = FMath::Max(Weapon.Cooldown - DeltaTime, 0.0f);
+
+			const FDroneTargetFragment& Target = TargetFragments[i];
+			if (Weapon.Cooldown > 0.0f || Target.TargetIndex == INDEX_NONE || Target.DistanceToTarget > Weapon.Range || Healths[i].Health <= 0.0f) continue;
+
+			const FDroneFlightFragment& Flight = Flights[i];
+			const FVector Heading = Flight.Velocity.GetSafeNormal();
+			const FVector ToTarget = (Targets[Target.TargetIndex].Location - Flight.Location).GetSafeNormal();
+			if (FVector::DotProduct(Heading, ToTarget) < Weapon.FireAngleThreshold) continue;
+
+			WeaponFire->FireRound(nullptr, Flight.Location, Flight.Location, Flight.Velocity + Heading * Weapon.MuzzleSpeed, Weapon.Damage);
+			Weapon.Cooldown = Weapon.FireInterval;
+		}
+	});
+}
+
+// --- Representation ---
+
+UDroneRepresentationProcessor::UDroneRepresentationProcessor()
+	: EntityQuery(*this)
+{
+	bAutoRegisterWithProcessingPhases = false;
+	bRequiresGameThreadExecution = true;
+	ExecutionFlags = static_cast<int32>(EProcessorExecutionFlags::AllNetModes);
+}
+
+void UDroneRepresentationProcessor::ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager)
+{
+	EntityQuery.AddRequirement<FDroneFlightFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FDroneTargetFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FDroneHealthFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddConstSharedRequirement<FDroneClassFragment>();
+}
+
+void UDroneRepresentationProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	UWorld* World = EntityManager.GetWorld();
+	UDroneSwarmSubsystem* Swarm = World ? World->GetSubsystem<UDroneSwarmSubsystem>() : nullptr;
+	if (!Swarm) return;
+
+	EntityQuery.ForEachEntityChunk(Context, [&](FMassExecutionContext& ChunkContext)
+	{
+		const TConstArrayView<FDroneFlightFragment> Flights = ChunkContext.GetFragmentView<FDroneFlightFragment>();
+		const TConstArrayView<FDroneTargetFragment> TargetFragments = ChunkContext.GetFragmentView<FDroneTargetFragment>();
+		const TConstArrayView<FDroneHealthFragment> Healths = ChunkContext.GetFragmentView<FDroneHealthFragment>();
+
+		// A chunk only holds drones of one class
+		const TSubclassOf<AAIAircraftPawn> PawnClass = ChunkContext.GetConstSharedFragment<FDroneClassFragment>().PawnClass;
+		const bool bCanPromote = PawnClass != nullptr;
+
+		for (int32 i = 0; i < ChunkContext.GetNumEntities(); ++i)
+		{
+			const FDroneFlightFragment& Flight = Flights[i];
+			const FDroneTargetFragment& Target = TargetFragments[i];
+
+			if (Healths[i].Health <= 0.0f)
+			{
+				Swarm->DeadDrones.Add({ ChunkContext.GetEntity(i), Target.Team });
+				continue;
+			}
+
+			if (bCanPromote && Target.DistanceToTarget < Swarm->PromotionDistance && Swarm->Promotions.Num() < Swarm->MaxPromotionsPerFrame)
+			{
+				Swarm->Promotions.Add({ ChunkContext.GetEntity(i), PawnClass, Flight.Location, Flight.Velocity, Healths[i].Health, Healths[i].MaxHealth, Target.Team });
+				continue;
+			}
+
+			Swarm->InstanceTransforms.Emplace(Flight.Velocity.ToOrientationQuat(), Flight.Location);
+			Swarm->GridEntities.Add(ChunkContext.GetEntity(i));
+			Swarm->GridLocations.Add(Flight.Location);
+		}
+	});
+}
@@ -0,0 +1,342 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#include "DroneSwarmSubsystem.h"
+#include "DroneSwarmFragments.h"
+#include "DroneSwarmProcessors.h"
+#include "AIAircraftPawn.h"
+#include "HealthComponent.h"
+#include "WeaponComponent.h"
+#include "TerrainHeightSubsystem.h"
+#include "FlightSimProfiling.h"
+#include "MassEntitySubsystem.h"
+#include "MassExecutor.h"
+#include "MassProcessingTypes.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+
+bool UDroneSwarmSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UDroneSwarmSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	Collection.InitializeDependency<UMassEntitySubsystem>();
+	Terrain = Collection.InitializeDependency<UTerrainHeightSubsystem>();
+}
+
+TStatId UDroneSwarmSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDroneSwarmSubsystem, STATGROUP_Tickables);
+}
+
+void UDroneSwarmSubsystem::CreateProcessors()
+{
+	const TSharedRef<FMassEntityManager> EntityManager = GetWorld()->GetSubsystem<UMassEntitySubsystem>()->GetMutableEntityManager().AsShared();
+
+	FlightProcessor = NewObject<UDroneFlightProcessor>(this);
+	WeaponProcessor = NewObject<UDroneWeaponProcessor>(this);
+	RepresentationProcessor = NewObject<UDroneRepresentationProcessor>(this);
+	FlightProcessor->CallInitialize(this, EntityManager);
+	WeaponProcessor->CallInitialize(this, EntityManager);
+	RepresentationProcessor->CallInitialize(this, EntityManager);
+
+	Archetype = EntityManager->CreateArchetype({
+		FDroneFlightFragment::StaticStruct(),
+		FDroneHealthFragment::StaticStruct(),
+		FDroneWeaponFragment::StaticStruct(),
+		FDroneTargetFragment::StaticStruct(),
+		FDroneClassFragment::StaticStruct() });
+}
+
+void UDroneSwarmSubsystem::SpawnDrones(TSubclassOf<AAIAircraftPawn> PawnClass, TConstArrayView<FVector> Locations, uint8 Team)
+{
+	if (!PawnClass || Locations.Num() == 0) return;
+
+	if (!FlightProcessor)
+	{
+		CreateProcessors();
+	}
+
+	// Drones fly, shoot and soak damage like the pawn they stand in for
+	const AAIAircraftPawn* Defaults = PawnClass->GetDefaultObject<AAIAircraftPawn>();
+
+	FDroneFlightFragment Flight;
+	Flight.MaxSpeed = Defaults->MaxSpeed;
+	Flight.TurnRate = FMath::DegreesToRadians(Defaults->TurnSpeed);
+	Flight.Velocity = FVector::ForwardVector * Defaults->MaxSpeed;
+
+	FDroneHealthFragment Health;
+	Health.MaxHealth = Defaults->HealthComponent ? Defaults->HealthComponent->GetMaxHealth() : Health.MaxHealth;
+	Health.Health = Health.MaxHealth;
+
+	const FWeaponStats& WeaponStats = Defaults->WeaponComponent->GetStats();
+	FDroneWeaponFragment Weapon;
+	Weapon.FireInterval = WeaponStats.FireInterval;
+	Weapon.FireAngleThreshold = WeaponStats.FireAngleThreshold;
+	Weapon.MuzzleSpeed = WeaponStats.MuzzleSpeed;
+	Weapon.Damage = WeaponStats.Damage;
+
+	FDroneTargetFragment Target;
+	Target.Team = Team;
+
+	FMassEntityManager& EntityManager = GetWorld()->GetSubsystem<UMassEntitySubsystem>()->GetMutableEntityManager();
+
+	// Drones of one class share a single fragment value, and each class gets its own chunks
+	FDroneClassFragment DroneClass;
+	DroneClass.PawnClass = PawnClass;
+	FMassArchetypeSharedFragmentValues SharedValues;
+	SharedValues.Add(EntityManager.GetOrCreateConstSharedFragment(DroneClass));
+	SharedValues.Sort();
+
+	TArray<FMassEntityHandle> Entities;
+	{
+		// Observers, if any, are notified once for the whole batch when the context goes out of scope
+		TSharedRef<FMassEntityManager::FEntityCreationContext> CreationContext = EntityManager.BatchCreateEntities(Archetype, SharedValues, Locations.Num(), Entities);
+		for (int32 i = 0; i < Entities.Num(); ++i)
+		{
+			Flight.Location = Locations[i];
+			EntityManager.GetFragmentDataChecked<FDroneFlightFragment>(Entities[i]) = Flight;
+			EntityManager.GetFragmentDataChecked<FDroneHealthFragment>(Entities[i]) = Health;
+			EntityManager.GetFragmentDataChecked<FDroneWeaponFragment>(Entities[i]) = Weapon;
+			EntityManager.GetFragmentDataChecked<FDroneTargetFragment>(Entities[i]) = Target;
+		}
+	}
+	NumDrones += Entities.Num();
+
+	// Drawn with the promoted pawn's own mesh, so promotion does not change the look
+	if (!Instances && GetWorld()->GetNetMode() != NM_DedicatedServer && Defaults->AircraftMesh && Defaults->AircraftMesh->GetStaticMesh())
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		AActor* InstanceActor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+		if (InstanceActor)
+		{
+			Instances = NewObject<UInstancedStaticMeshComponent>(InstanceActor, TEXT("Drones"));
+			Instances->SetStaticMesh(Defaults->AircraftMesh->GetStaticMesh());
+			Instances->SetMobility(EComponentMobility::Movable);
+			Instances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+			InstanceActor->SetRootComponent(Instances);
+			Instances->RegisterComponent();
+		}
+	}
+}
+
+void UDroneSwarmSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	FLIGHTSIM_SCOPE(AI, DroneSwarmTick);
+
+	GridEntities.Reset();
+	GridLocations.Reset();
+	if (NumDrones == 0 || !FlightProcessor)
+	{
+		RebuildGrid();
+		return;
+	}
+
+	GatherTargets();
+	InstanceTransforms.Reset();
+	Promotions.Reset();
+	DeadDrones.Reset();
+
+	FMassEntityManager& EntityManager = GetWorld()->GetSubsystem<UMassEntitySubsystem>()->GetMutableEntityManager();
+	FMassProcessingContext ProcessingContext(EntityManager, DeltaTime);
+	// One at a time, in this order: weapons read the flight step's headings, representation the final state
+	UE::Mass::Executor::Run(*FlightProcessor, ProcessingContext);
+	UE::Mass::Executor::Run(*WeaponProcessor, ProcessingContext);
+	UE::Mass::Executor::Run(*RepresentationProcessor, ProcessingContext);
+
+	PromoteDrones();
+	DestroyDeadDrones();
+	UpdateInstances();
+	RebuildGrid();
+
+	FLIGHTSIM_SET_COUNTER(Drones, NumDrones);
+}
+
+void UDroneSwarmSubsystem::GatherTargets()
+{
+	Targets.Reset();
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		APawn* Pawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+		if (!Pawn) continue;
+
+		Targets.Add({ Pawn, Pawn->GetActorLocation(), Pawn->GetVelocity(), FGenericTeamId::GetTeamIdentifier(Pawn).GetId() });
+	}
+}
+
+void UDroneSwarmSubsystem::PromoteDrones()
+{
+	if (Promotions.Num() == 0) return;
+
+	TArray<FMassEntityHandle> Promoted;
+	for (const FDronePromotion& Promotion : Promotions)
+	{
+		const FTransform SpawnTransform(Promotion.Velocity.ToOrientationRotator(), Promotion.Location);
+
+		// Deferred so the team is set before BeginPlay registers the aircraft
+		AAIAircraftPawn* Pawn = GetWorld()->SpawnActorDeferred<AAIAircraftPawn>(Promotion.PawnClass, SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		if (!Pawn) continue;
+
+		Pawn->SetGenericTeamId(FGenericTeamId(Promotion.Team));
+		Pawn->FinishSpawning(SpawnTransform);
+
+		if (Pawn->AircraftMesh->IsSimulatingPhysics())
+		{
+			Pawn->AircraftMesh->SetPhysicsLinearVelocity(Promotion.Velocity);
+		}
+		else
+		{
+			Pawn->AircraftMesh->ComponentVelocity = Promotion.Velocity;
+		}
+
+		// Carried over as state rather than damage, so the new aircraft does not start out evading
+		if (Pawn->HealthComponent && Promotion.Health < Promotion.MaxHealth)
+		{
+			Pawn->HealthComponent->SetCurrentHealth(Promotion.Health);
+		}
+
+		Promoted.Add(Promotion.Entity);
+	}
+
+	FMassEntityManager& EntityManager = GetWorld()->GetSubsystem<UMassEntitySubsystem>()->GetMutableEntityManager();
+	EntityManager.BatchDestroyEntities(Promoted);
+	NumDrones -= Promoted.Num();
+}
+
+void UDroneSwarmSubsystem::DestroyDeadDrones()
+{
+	if (DeadDrones.Num() == 0) return;
+
+	TArray<FMassEntityHandle> Entities;
+	Entities.Reserve(DeadDrones.Num());
+	for (const FDroneLoss& Loss : DeadDrones)
+	{
+		Entities.Add(Loss.Entity);
+	}
+
+	FMassEntityManager& EntityManager = GetWorld()->GetSubsystem<UMassEntitySubsystem>()->GetMutableEntityManager();
+	EntityManager.BatchDestroyEntities(Entities);
+	NumDrones -= Entities.Num();
+
+	for (const FDroneLoss& Loss : DeadDrones)
+	{
+		OnDroneDestroyed.Broadcast(Loss.Team);
+	}
+}
+
+void UDroneSwarmSubsystem::UpdateInstances()
+{
+	if (!Instances) return;
+
+	const int32 NumVisible = InstanceTransforms.Num();
+	const int32 NumInstances = Instances->GetInstanceCount();
+	if (NumInstances < NumVisible)
+	{
+		TArray<FTransform> NewInstances;
+		NewInstances.Init(FTransform::Identity, NumVisible - NumInstances);
+		Instances->AddInstances(NewInstances, false, true);
+	}
+	else if (NumInstances > NumVisible)
+	{
+		TArray<int32> Removed;
+		for (int32 i = NumInstances - 1; i >= NumVisible; --i)
+		{
+			Removed.Add(i);
+		}
+		Instances->RemoveInstances(Removed);
+	}
+
+	if (NumVisible > 0)
+	{
+		Instances->BatchUpdateInstancesTransforms(0, InstanceTransforms, true, true, true);
+	}
+}
+
+FIntVector UDroneSwarmSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt32(Location.X / GridCellSize),
+		FMath::FloorToInt32(Location.Y / GridCellSize),
+		FMath::FloorToInt32(Location.Z / GridCellSize));
+}
+
+void UDroneSwarmSubsystem::RebuildGrid()
+{
+	const int32 NumEntries = GridLocations.Num();
+	Keyed.Reset(NumEntries);
+	for (int32 Drone = 0; Drone < NumEntries; ++Drone)
+	{
+		Keyed.Emplace(GetCell(GridLocations[Drone]), Drone);
+	}
+
+	// Sort by cell so every cell is a contiguous run
+	Keyed.Sort([](const TPair<FIntVector, int32>& A, const TPair<FIntVector, int32>& B)
+	{
+		if (A.Key.X != B.Key.X) return A.Key.X < B.Key.X;
+		if (A.Key.Y != B.Key.Y) return A.Key.Y < B.Key.Y;
+		return A.Key.Z < B.Key.Z;
+	});
+
+	SortedDrones.Reset(NumEntries);
+	CellRanges.Reset();
+	for (int32 i = 0; i < Keyed.Num(); ++i)
+	{
+		SortedDrones.Add(Keyed[i].Value);
+
+		FIntPoint& Range = CellRanges.FindOrAdd(Keyed[i].Key, FIntPoint(i, 0));
+		Range.Y++;
+	}
+}
+
+bool UDroneSwarmSubsystem::HitDrone(const FVector& Start, const FVector& End, float Damage)
+{
+	if (CellRanges.Num() == 0) return false;
+
+	const FIntVector MinCell = GetCell(Start.ComponentMin(End) - FVector(DroneHitRadius));
+	const FIntVector MaxCell = GetCell(Start.ComponentMax(End) + FVector(DroneHitRadius));
+	const FVector Segment = End - Start;
+	const float HitRadiusSquared = FMath::Square(DroneHitRadius);
+
+	// The hit is the drone the round reaches first
+	int32 HitIndex = INDEX_NONE;
+	float HitAlong = UE_BIG_NUMBER;
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+			{
+				const FIntPoint* Range = CellRanges.Find(FIntVector(X, Y, Z));
+				if (!Range) continue;
+
+				for (int32 i = Range->X; i < Range->X + Range->Y; ++i)
+				{
+					const int32 Drone = SortedDrones[i];
+					const FVector& Location = GridLocations[Drone];
+					const float Along = FVector::DotProduct(Location - Start, Segment);
+					if (Along < HitAlong && FMath::PointDistToSegmentSquared(Location, Start, End) <= HitRadiusSquared)
+					{
+						HitIndex = Drone;
+						HitAlong = Along;
+					}
+				}
+			}
+		}
+	}
+	if (HitIndex == INDEX_NONE) return false;
+
+	// Dead drones are removed by the next tick, which also reports them through OnDroneDestroyed
+	FMassEntityManager& EntityManager = GetWorld()->GetSubsystem<UMassEntitySubsystem>()->GetMutableEntityManager();
+	FDroneHealthFragment* Health = EntityManager.IsEntityValid(GridEntities[HitIndex]) ? EntityManager.GetFragmentDataPtr<FDroneHealthFragment>(GridEntities[HitIndex]) : nullptr;
+	if (!Health || Health->Health <= 0.0f) return false;
+
+	Health->Health = FMath::Max(Health->Health - Damage, 0.0f);
+	return true;
+}
@@ -0,0 +1,37 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#include "FighterHUDWidget.h"
+
+void UFighterHUDWidget::PushFlightData(float Airspeed, float Altitude, float AltitudeAboveGround, AActor* LockedTarget, int32 MissileAmmo)
+{
+	const float NewAirspeed = FMath::GridSnap(Airspeed, FMath::Max(AirspeedStep, UE_KINDA_SMALL_NUMBER));
+	const float NewAltitude = FMath::GridSnap(Altitude, FMath::Max(AltitudeStep, UE_KINDA_SMALL_NUMBER));
+	const float NewAltitudeAboveGround = FMath::GridSnap(AltitudeAboveGround, FMath::Max(AltitudeStep, UE_KINDA_SMALL_NUMBER));
+
+	if (!bHasPushed || NewAirspeed != ShownAirspeed)
+	{
+		ShownAirspeed = NewAirspeed;
+		OnAirspeedChanged(NewAirspeed);
+	}
+
+	if (!bHasPushed || NewAltitude != ShownAltitude || NewAltitudeAboveGround != ShownAltitudeAboveGround)
+	{
+		ShownAltitude = NewAltitude;
+		ShownAltitudeAboveGround = NewAltitudeAboveGround;
+		OnAltitudeChanged(NewAltitude, NewAltitudeAboveGround);
+	}
+
+	if (!bHasPushed || LockedTarget != ShownLockedTarget.Get())
+	{
+		ShownLockedTarget = LockedTarget;
+		OnLockedTargetChanged(LockedTarget);
+	}
+
+	if (!bHasPushed || MissileAmmo != ShownMissileAmmo)
+	{
+		ShownMissileAmmo = MissileAmmo;
+		OnMissileAmmoChanged(MissileAmmo);
+	}
+
+	bHasPushed = true;
+}
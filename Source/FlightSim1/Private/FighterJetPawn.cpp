@@ -8,13 +8,25 @@
 #include "Components/SceneComponent.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "DrawDebugHelpers.h"
-#include "Sound/SoundBase.h"
-#include "Particles/ParticleSystem.h"
 #include "Blueprint/UserWidget.h"
-#include "Kismet/GameplayStatics.h"
 #include "HealthComponent.h"
+#include "DamageSubsystem.h"
 #include "AIAircraftPawn.h"
+#include "AircraftRegistrySubsystem.h"
+#include "WeaponComponent.h"
+#include "MissilePoolSubsystem.h"
 #include "Missile.h"
+#include "AerodynamicProfile.h"
+#include "TerrainHeightSubsystem.h"
+#include "FighterHUDWidget.h"
+#include "SContactMarkerLayer.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/GameViewportClient.h"
+#include "SceneView.h"
+#include "GameFramework/GameStateBase.h"
+#include "Net/UnrealNetwork.h"
+#include "FlightSimProfiling.h"
 
 // Sets default values
 AFighterJetPawn::AFighterJetPawn()
@@ -22,6 +34,11 @@ AFighterJetPawn::AFighterJetPawn()
 	// Set this pawn to call Tick() every frame.
 	PrimaryActorTick.bCanEverTick = true;
 
+	// Movement goes through ServerState rather than the engine's replicated movement
+	bReplicates = true;
+	SetReplicatingMovement(false);
+	SetNetUpdateFrequency(30.0f);
+
 	// --- Component Initialization ---
 	AircraftMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("AircraftMesh"));
 	RootComponent = AircraftMesh;
@@ -50,6 +67,15 @@ AFighterJetPawn::AFighterJetPawn()
 
 	HealthComponent = CreateDefaultSubobject<UHealthComponent>(TEXT("HealthComponent"));
 
+	WeaponComponent = CreateDefaultSubobject<UWeaponComponent>(TEXT("WeaponComponent"));
+	WeaponComponent->SetMuzzle(MuzzleLocation);
+
+	// The defaults these had before they moved to the weapon component, so PostLoad only carries over changed values
+	FireRate_DEPRECATED = 0.1f;
+	MuzzleFlashFX_DEPRECATED = nullptr;
+	FireSound_DEPRECATED = nullptr;
+	WeaponRange_DEPRECATED = 50000.0f;
+
 	// --- Default Physics Values ---
 	MaxThrust = 100000000.0f;
 	ThrustAcceleration = 0.5f;
@@ -63,11 +89,18 @@ AFighterJetPawn::AFighterJetPawn()
 	DragCoefficient = 0.02f;
 	InducedDragCoefficient = 0.05f;
 	CriticalAngleOfAttack = 15.0f;
+	AerodynamicProfile = nullptr;
+	AeroTables = nullptr;
 
 
 	// --- Weapon Properties ---
-	WeaponRange = 50000.0f;
-	FireRate = 0.1f;
+	LockRange = 100000.0f;
+	ContactMarkerRange = 300000.0f;
+	SensorModel.Range = 300000.0f;
+	SensorModel.AzimuthHalfAngle = 60.0f;
+	SensorModel.ElevationHalfAngle = 30.0f;
+	SensorModel.ScanRate = 120.0f;
+	FighterHUDWidget = nullptr;
 	MaxMissileAmmo = 10;
 	CurrentMissileAmmo = MaxMissileAmmo;
 
@@ -77,9 +110,27 @@ AFighterJetPawn::AFighterJetPawn()
 	RollInput = 0.0f;
 	YawInput = 0.0f;
 	GroundSteerInput = 0.0f;
+	bAutopilot = false;
 	bIsOnGround = false;
 	bIsFiring = false;
 	LockedTarget = nullptr;
+	TeamId = 0;
+
+	// --- Networking ---
+	InterpolationDelay = 0.1f;
+	MaxExtrapolationTime = 0.25f;
+	CorrectionThreshold = 25.0f;
+	InputRedundancy = 3;
+	MaxMoveTimeAhead = 0.5f;
+	bNetworkedFlight = false;
+	BodyMass = 15000.0f;
+	NextInputSequence = 0;
+	NumCorrections = 0;
+	LastProcessedInput = 0;
+	bHasProcessedInput = false;
+	ServerMoveCycles = 0;
+	ServerMoveTimeBudget = 0.0f;
+	LastMoveBudgetTime = -1.0;
 
 	// --- Find HUD Widget ---
 	static ConstructorHelpers::FClassFinder<UUserWidget> HUDClassFinder(TEXT("/Game/Blueprints/WBP_FighterHUD"));
@@ -103,15 +154,135 @@ void AFighterJetPawn::BeginPlay()
 		HealthComponent->OnDeath.AddDynamic(this, &AFighterJetPawn::HandlePawnDeath);
 	}
 
-	// Create and display HUD
-	if (HUDWidgetClass)
+	if (UAircraftRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UAircraftRegistrySubsystem>())
+	{
+		Registry->RegisterAircraft(this);
+	}
+
+	UpdateSensorRegistration();
+
+	// Coefficient tables are baked once; the flight model only samples them
+	if (AerodynamicProfile)
+	{
+		AeroTables = &AerodynamicProfile->GetTables();
+	}
+	else
+	{
+		LegacyAeroTables.BuildLegacy(LiftCoefficient, DragCoefficient, InducedDragCoefficient, CriticalAngleOfAttack);
+		AeroTables = &LegacyAeroTables;
+	}
+
+	// Networked aircraft are integrated by FlightModel so moves can be replayed; the mesh only sweeps along
+	bNetworkedFlight = GetNetMode() != NM_Standalone;
+	if (bNetworkedFlight)
+	{
+		BodyMass = FMath::Max(AircraftMesh->GetMass(), 1.0f);
+		AircraftMesh->SetSimulatePhysics(false);
+		FlightBody.Location = AircraftMesh->GetComponentLocation();
+		FlightBody.Rotation = AircraftMesh->GetComponentQuat();
+
+		if (HasAuthority())
+		{
+			PublishServerState();
+		}
+	}
+
+	// Pre-warm enough missiles for a full load so launches never spawn actors. Missiles only spawn on the server.
+	if (HasAuthority())
 	{
-		HUDWidgetInstance = CreateWidget<UUserWidget>(GetWorld(), HUDWidgetClass);
-		if (HUDWidgetInstance)
+		if (UMissilePoolSubsystem* MissilePool = GetWorld()->GetSubsystem<UMissilePoolSubsystem>())
 		{
-			HUDWidgetInstance->AddToViewport();
+			MissilePool->Prewarm(MissileClass, MaxMissileAmmo);
 		}
 	}
+
+	CreateHUD();
+}
+
+void AFighterJetPawn::PostLoad()
+{
+	Super::PostLoad();
+
+	// Only values that differ from the native defaults were set by a Blueprint or level
+	const AFighterJetPawn* Defaults = GetDefault<AFighterJetPawn>();
+	FWeaponStats& Stats = WeaponComponent->DefaultStats;
+	if (FireRate_DEPRECATED != Defaults->FireRate_DEPRECATED) Stats.FireInterval = FireRate_DEPRECATED;
+	if (MuzzleFlashFX_DEPRECATED) Stats.MuzzleFlashFX = MuzzleFlashFX_DEPRECATED;
+	if (FireSound_DEPRECATED) Stats.FireSound = FireSound_DEPRECATED;
+}
+
+void AFighterJetPawn::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AFighterJetPawn, ServerState);
+	DOREPLIFETIME(AFighterJetPawn, TeamId);
+	DOREPLIFETIME_CONDITION(AFighterJetPawn, CurrentMissileAmmo, COND_OwnerOnly);
+}
+
+void AFighterJetPawn::NotifyControllerChanged()
+{
+	Super::NotifyControllerChanged();
+
+	// Clients learn they control the pawn after BeginPlay, when the controller replicates
+	if (HasActorBegunPlay())
+	{
+		CreateHUD();
+		UpdateSensorRegistration();
+	}
+}
+
+void AFighterJetPawn::UpdateSensorRegistration()
+{
+	USensorSubsystem* Sensors = GetWorld()->GetSubsystem<USensorSubsystem>();
+	if (!Sensors) return;
+
+	// Lock-on and contact markers run on the pilot's machine; the server checks missile launches by range instead
+	if (IsLocallyControlled() && !(HealthComponent && HealthComponent->IsDead()))
+	{
+		Sensors->RegisterSensor(this, SensorModel);
+	}
+	else
+	{
+		Sensors->UnregisterSensor(this);
+	}
+}
+
+void AFighterJetPawn::CreateHUD()
+{
+	// Only the pilot sees a HUD; other players' aircraft on the same machine do not get one
+	if (!HUDWidgetClass || HUDWidgetInstance || !IsLocallyControlled() || !IsPlayerControlled()) return;
+
+	HUDWidgetInstance = CreateWidget<UUserWidget>(GetWorld(), HUDWidgetClass);
+	if (HUDWidgetInstance)
+	{
+		HUDWidgetInstance->AddToViewport();
+		FighterHUDWidget = Cast<UFighterHUDWidget>(HUDWidgetInstance);
+	}
+}
+
+void AFighterJetPawn::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UAircraftRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UAircraftRegistrySubsystem>())
+	{
+		Registry->UnregisterAircraft(this);
+	}
+
+	if (USensorSubsystem* Sensors = GetWorld()->GetSubsystem<USensorSubsystem>())
+	{
+		Sensors->UnregisterSensor(this);
+	}
+
+	if (ContactMarkerLayer.IsValid())
+	{
+		if (UGameViewportClient* ViewportClient = GetWorld()->GetGameViewport())
+		{
+			ViewportClient->RemoveViewportWidgetContent(ContactMarkerLayer.ToSharedRef());
+		}
+		ContactMarkerLayer.Reset();
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 // Called every frame
@@ -121,10 +292,24 @@ void AFighterJetPawn::Tick(float DeltaTime)
 
 	if (HealthComponent && HealthComponent->IsDead()) return;
 
-	CheckIfOnGround();
-	ApplyAerodynamics(DeltaTime);
-	UpdateHUDVariables();
-	UpdateLockedTarget();
+	if (bNetworkedFlight)
+	{
+		TickNetworkedFlight(DeltaTime);
+	}
+	else
+	{
+		CheckIfOnGround();
+		ApplyAerodynamics(DeltaTime);
+	}
+
+	WeaponComponent->UpdateWeapon(DeltaTime);
+
+	if (IsLocallyControlled())
+	{
+		UpdateLockedTarget();
+		UpdateHUDVariables();
+		UpdateContactMarkers();
+	}
 }
 
 // Called to bind functionality to input
@@ -144,15 +329,29 @@ void AFighterJetPawn::SetupPlayerInputComponent(UInputComponent* PlayerInputComp
 	PlayerInputComponent->BindAction("FireMissile", IE_Pressed, this, &AFighterJetPawn::FireMissile);
 }
 
+void AFighterJetPawn::SetGenericTeamId(const FGenericTeamId& NewTeamId)
+{
+	TeamId = NewTeamId.GetId();
+}
+
+FGenericTeamId AFighterJetPawn::GetGenericTeamId() const
+{
+	return FGenericTeamId(TeamId);
+}
+
 void AFighterJetPawn::OnPawnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
 {
-	if (HealthComponent)
+	// Damage is the server's call; clients replaying moves hit the same things
+	if (!HasAuthority()) return;
+
+	UDamageSubsystem* DamageSubsystem = GetWorld()->GetSubsystem<UDamageSubsystem>();
+	if (HealthComponent && DamageSubsystem)
 	{
-		// Apply damage on hard landings/crashes
-		float ImpactSpeed = NormalImpulse.Size() / (AircraftMesh->GetMass());
+		// Apply damage on hard landings/crashes. Swept moves carry no impulse, so use the closing speed.
+		float ImpactSpeed = bNetworkedFlight ? -FVector::DotProduct(FlightBody.Velocity, Hit.ImpactNormal) : NormalImpulse.Size() / (AircraftMesh->GetMass());
 		if (ImpactSpeed > 1000.0f) // Threshold for damage
 		{
-			HealthComponent->TakeDamage(50.0f);
+			DamageSubsystem->QueueDamage(HealthComponent->GetHealthHandle(), 50.0f, OtherActor, EFlightDamageType::Collision);
 		}
 	}
 }
@@ -163,107 +362,201 @@ void AFighterJetPawn::HandlePawnDeath()
 	SetActorHiddenInGame(true);
 	SetActorEnableCollision(false);
 	SetActorTickEnabled(false);
+
+	if (UAircraftRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UAircraftRegistrySubsystem>())
+	{
+		Registry->UnregisterAircraft(this);
+	}
+
+	if (USensorSubsystem* Sensors = GetWorld()->GetSubsystem<USensorSubsystem>())
+	{
+		Sensors->UnregisterSensor(this);
+	}
+
+	if (ContactMarkerLayer.IsValid())
+	{
+		ContactMarkerLayer->GetMutableMarkers().Reset();
+		ContactMarkerLayer->MarkersChanged();
+	}
 }
 
 void AFighterJetPawn::UpdateHUDVariables()
 {
-	Airspeed = AircraftMesh->GetPhysicsLinearVelocity().Size() * 0.036; // Convert cm/s to km/h
+	FLIGHTSIM_SCOPE(HUD, UpdateHUD);
+
+	Airspeed = GetVelocity().Size() * 0.036; // Convert cm/s to km/h
 	Altitude = GetActorLocation().Z / 100.0f; // Convert cm to m
+
+	float HeightAboveGround;
+	const UTerrainHeightSubsystem* Terrain = GetWorld()->GetSubsystem<UTerrainHeightSubsystem>();
+	AltitudeAboveGround = Terrain && Terrain->GetHeightAboveGround(GetActorLocation(), HeightAboveGround) ? HeightAboveGround / 100.0f : Altitude;
+
+	if (FighterHUDWidget)
+	{
+		FighterHUDWidget->PushFlightData(Airspeed, Altitude, AltitudeAboveGround, LockedTarget, CurrentMissileAmmo);
+	}
+}
+
+void AFighterJetPawn::UpdateContactMarkers()
+{
+	FLIGHTSIM_SCOPE(HUD, UpdateContactMarkers);
+
+	APlayerController* PlayerController = Cast<APlayerController>(GetController());
+	ULocalPlayer* LocalPlayer = PlayerController ? PlayerController->GetLocalPlayer() : nullptr;
+	if (!LocalPlayer || !LocalPlayer->ViewportClient) return;
+
+	const USensorSubsystem* Sensors = GetWorld()->GetSubsystem<USensorSubsystem>();
+	const TArray<FSensorTrack>* Tracks = Sensors ? Sensors->FindTracks(this) : nullptr;
+	if (!Tracks) return;
+
+	if (!ContactMarkerLayer.IsValid())
+	{
+		ContactMarkerLayer = SNew(SContactMarkerLayer);
+		LocalPlayer->ViewportClient->AddViewportWidgetContent(ContactMarkerLayer.ToSharedRef(), 10);
+	}
+
+	// One view-projection matrix for every contact instead of a full projection call each
+	FSceneViewProjectionData ProjectionData;
+	if (!LocalPlayer->GetProjectionData(LocalPlayer->ViewportClient->Viewport, ProjectionData)) return;
+	const FMatrix ViewProjection = ProjectionData.ComputeViewProjectionMatrix();
+	const FIntRect ViewRect = ProjectionData.GetConstrainedViewRect();
+
+	// Boxes are drawn where the radar thinks contacts are, so they lag a hard maneuver until the next sweep
+	const double Now = Sensors->GetTime();
+	const FVector MyLocation = GetActorLocation();
+	const float RangeSquared = FMath::Square(ContactMarkerRange);
+
+	TArray<FContactMarker>& Markers = ContactMarkerLayer->GetMutableMarkers();
+	Markers.Reset();
+	for (const FSensorTrack& Track : *Tracks)
+	{
+		const AActor* Contact = Track.Target.Get();
+		if (!Contact || !Track.IsValid()) continue;
+
+		const FVector ContactLocation = Track.PredictLocation(Now);
+		if (FVector::DistSquared(ContactLocation, MyLocation) > RangeSquared) continue;
+
+		FVector2D ScreenPosition;
+		if (!FSceneView::ProjectWorldToScreen(ContactLocation, ViewRect, ViewProjection, ScreenPosition)) continue;
+
+		FContactMarker& Marker = Markers.AddDefaulted_GetRef();
+		Marker.ScreenPosition = FVector2f(ScreenPosition);
+		if (Contact == LockedTarget)
+		{
+			Marker.Color = FLinearColor::Yellow;
+			Marker.HalfSize = 24.0f;
+		}
+		else
+		{
+			Marker.Color = Track.Team != TeamId ? FLinearColor::Red : FLinearColor::Green;
+			Marker.HalfSize = 14.0f;
+		}
+	}
+	ContactMarkerLayer->MarkersChanged();
 }
 
 void AFighterJetPawn::UpdateLockedTarget()
 {
+	FLIGHTSIM_SCOPE(Weapons, UpdateLockedTarget);
+
 	LockedTarget = nullptr;
 	float BestTargetScore = -1.0f;
 
-	TArray<AActor*> FoundActors;
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), AAIAircraftPawn::StaticClass(), FoundActors);
+	const USensorSubsystem* Sensors = GetWorld()->GetSubsystem<USensorSubsystem>();
+	const TArray<FSensorTrack>* Tracks = Sensors ? Sensors->FindTracks(this) : nullptr;
+	if (!Tracks) return;
 
+	const double Now = Sensors->GetTime();
 	FVector MyLocation = GetActorLocation();
 	FVector MyForward = GetActorForwardVector();
+	const float LockRangeSquared = FMath::Square(LockRange);
 
-	for (AActor* PotentialTarget : FoundActors)
+	// Only hostile tracks firm enough to guide on, within a cone in front of the player and inside lock range
+	for (const FSensorTrack& Track : *Tracks)
 	{
-		if (PotentialTarget)
-		{
-			FVector DirectionToTarget = (PotentialTarget->GetActorLocation() - MyLocation).GetSafeNormal();
-			float DotProduct = FVector::DotProduct(MyForward, DirectionToTarget);
+		APawn* PotentialTarget = Track.Target.Get();
+		if (!PotentialTarget || !Track.IsEstablished() || Track.Team == TeamId) continue;
 
-			// Check if target is in front of us
-			if (DotProduct > 0.8f) // Within a cone in front of the player
-			{
-				if (DotProduct > BestTargetScore)
-				{
-					BestTargetScore = DotProduct;
-					LockedTarget = PotentialTarget;
-				}
-			}
+		const FVector ToTarget = Track.PredictLocation(Now) - MyLocation;
+		if (ToTarget.SizeSquared() > LockRangeSquared) continue;
+
+		float DotProduct = FVector::DotProduct(MyForward, ToTarget.GetSafeNormal());
+		if (DotProduct >= 0.8f && DotProduct > BestTargetScore)
+		{
+			BestTargetScore = DotProduct;
+			LockedTarget = PotentialTarget;
 		}
 	}
 }
 
+void AFighterJetPawn::SetAutopilotInput(float InThrottle, float InPitch, float InRoll, float InYaw, bool bInFireGun, bool bInLaunchMissile)
+{
+	bAutopilot = true;
+
+	CurrentThrottle = FMath::Clamp(InThrottle, 0.0f, 1.0f);
+	PitchInput = FMath::Clamp(InPitch, -1.0f, 1.0f);
+	RollInput = FMath::Clamp(InRoll, -1.0f, 1.0f);
+	YawInput = FMath::Clamp(InYaw, -1.0f, 1.0f);
+
+	if (bInFireGun && !bIsFiring)
+	{
+		StartFire();
+	}
+	else if (!bInFireGun && bIsFiring)
+	{
+		StopFire();
+	}
+
+	if (bInLaunchMissile)
+	{
+		FireMissile();
+	}
+}
+
 void AFighterJetPawn::Throttle(float Value)
 {
+	if (bAutopilot) return;
 	CurrentThrottle = FMath::Clamp(CurrentThrottle + Value * ThrustAcceleration * GetWorld()->GetDeltaSeconds(), 0.0f, 1.0f);
 }
 
-void AFighterJetPawn::Pitch(float Value) { PitchInput = Value; }
-void AFighterJetPawn::Roll(float Value) { RollInput = Value; }
-void AFighterJetPawn::Yaw(float Value) { YawInput = Value; }
+void AFighterJetPawn::Pitch(float Value) { if (!bAutopilot) PitchInput = Value; }
+void AFighterJetPawn::Roll(float Value) { if (!bAutopilot) RollInput = Value; }
+void AFighterJetPawn::Yaw(float Value) { if (!bAutopilot) YawInput = Value; }
 void AFighterJetPawn::GroundSteer(float Value) { GroundSteerInput = Value; }
 
 void AFighterJetPawn::StartFire()
 {
 	bIsFiring = true;
-	GetWorldTimerManager().SetTimer(FireRateTimerHandle, this, &AFighterJetPawn::FireWeapon, FireRate, true, 0.0f);
+	WeaponComponent->SetTriggerHeld(true);
 }
 
 void AFighterJetPawn::StopFire()
 {
 	bIsFiring = false;
-	GetWorldTimerManager().ClearTimer(FireRateTimerHandle);
-}
-
-void AFighterJetPawn::FireWeapon()
-{
-	FHitResult HitResult;
-	FVector Start = MuzzleLocation->GetComponentLocation();
-	FVector End = Start + (GetActorForwardVector() * WeaponRange);
-
-	GetWorld()->LineTraceSingleByChannel(HitResult, Start, End, ECC_Visibility);
-
-	if (HitResult.GetActor())
-	{
-		UHealthComponent* HitHealthComponent = HitResult.GetActor()->FindComponentByClass<UHealthComponent>();
-		if (HitHealthComponent)
-		{
-			HitHealthComponent->TakeDamage(10.f);
-		}
-	}
-
-	if (MuzzleFlashFX)
-	{
-		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), MuzzleFlashFX, MuzzleLocation->GetComponentTransform());
-	}
-	if (FireSound)
-	{
-		UGameplayStatics::PlaySoundAtLocation(this, FireSound, GetActorLocation());
-	}
+	WeaponComponent->SetTriggerHeld(false);
 }
 
 void AFighterJetPawn::FireMissile()
 {
+	FLIGHTSIM_SCOPE(Missiles, FireMissile);
+
 	if (CurrentMissileAmmo > 0)
 	{
 		if (MissileClass && LockedTarget)
 		{
+			// Ammo comes back with the owner's replicated state
+			if (!HasAuthority())
+			{
+				ServerFireMissile(LockedTarget);
+				return;
+			}
+
 			FVector SpawnLocation = MuzzleLocation->GetComponentLocation();
 			FRotator SpawnRotation = GetActorRotation();
-			AMissile* NewMissile = GetWorld()->SpawnActor<AMissile>(MissileClass, SpawnLocation, SpawnRotation);
 
-			if (NewMissile)
+			if (UMissilePoolSubsystem* MissilePool = GetWorld()->GetSubsystem<UMissilePoolSubsystem>())
 			{
-				NewMissile->SetTarget(LockedTarget);
+				MissilePool->Launch(MissileClass, SpawnLocation, SpawnRotation, LockedTarget, this);
 			}
 
 			CurrentMissileAmmo--;
@@ -280,67 +573,351 @@ void AFighterJetPawn::FireMissile()
 
 void AFighterJetPawn::CheckIfOnGround()
 {
+	FLIGHTSIM_SCOPE(Aerodynamics, CheckIfOnGround);
+
 	if (!AircraftMesh) return;
 	FVector Start = AircraftMesh->GetComponentLocation();
+
+	// Well clear of the cached terrain the aircraft cannot be touching down, so skip the trace
+	const UTerrainHeightSubsystem* Terrain = GetWorld()->GetSubsystem<UTerrainHeightSubsystem>();
+	if (Terrain && !Terrain->IsNearGround(Start))
+	{
+		bIsOnGround = false;
+		return;
+	}
+
 	FVector End = Start - FVector(0.0f, 0.0f, 300.0f);
 	FHitResult HitResult;
 	FCollisionQueryParams CollisionParams;
 	CollisionParams.AddIgnoredActor(this);
 
+	FLIGHTSIM_ADD_COUNTER(TracesPerFrame, 1);
 	bIsOnGround = GetWorld()->LineTraceSingleByChannel(HitResult, Start, End, ECC_Visibility, CollisionParams);
 }
 
 // --- NEW ADVANCED AERODYNAMICS FUNCTION ---
+// The model itself lives in FlightModel; the pawn only feeds it state and applies the result
 void AFighterJetPawn::ApplyAerodynamics(float DeltaTime)
 {
+	FLIGHTSIM_SCOPE(Aerodynamics, ApplyAerodynamics);
+
 	if (!AircraftMesh || bIsOnGround) return;
 
-	FVector Velocity = AircraftMesh->GetPhysicsLinearVelocity();
-	// --- CHANGE: Renamed local variable to avoid hiding the class member ---
-	float LocalAirspeed = Velocity.Size();
-	if (LocalAirspeed < 1.0f) return; // Avoid division by zero and weird physics at rest
+	FVector Force, AngularAcceleration;
+	EvaluateFlightModel(AircraftMesh->GetPhysicsLinearVelocity(), AircraftMesh->GetComponentQuat(), CurrentThrottle, PitchInput, RollInput, YawInput, Force, AngularAcceleration);
+
+	AircraftMesh->AddForce(Force);
+	AircraftMesh->AddTorqueInDegrees(AngularAcceleration, NAME_None, true);
+}
+
+void AFighterJetPawn::EvaluateFlightModel(const FVector& Velocity, const FQuat& Rotation, float InThrottle, float InPitch, float InRoll, float InYaw, FVector& OutForce, FVector& OutAngularAcceleration)
+{
+	FlightModelBatch.SetNum(1);
+	FlightModelBatch.SetState(0, Velocity, Rotation.GetForwardVector(), Rotation.GetRightVector(), Rotation.GetUpVector());
+	FlightModelBatch.SetControls(0, InThrottle, InPitch, InRoll, InYaw, true);
+	FlightModelBatch.SetTuning(0, MaxThrust, LiftCoefficient, DragCoefficient, PitchSpeed, RollSpeed, YawSpeed);
+	FlightModelBatch.SetTables(0, AeroTables);
 
-	FVector VelocityNormal = Velocity.GetSafeNormal();
-	FVector UpVector = AircraftMesh->GetUpVector();
-	FVector ForwardVector = AircraftMesh->GetForwardVector();
+	FlightModel::EvaluateAerodynamics(FlightModelBatch);
 
-	// 1. Calculate Angle of Attack (AoA)
-	// The dot product of the velocity vector and the aircraft's up vector gives us the sine of the angle of attack.
-	float AoASin = FVector::DotProduct(VelocityNormal, UpVector);
-	float AngleOfAttack = FMath::Asin(AoASin);
+	OutForce = FlightModelBatch.GetForce(0);
+	OutAngularAcceleration = FlightModelBatch.GetTorque(0);
+}
 
-	// 2. Calculate Dynamic Lift Coefficient based on AoA
-	float CurrentLiftCoefficient = 0;
-	// Simple stall model: lift increases up to the critical angle, then drops off.
-	if (FMath::Abs(FMath::RadiansToDegrees(AngleOfAttack)) < CriticalAngleOfAttack)
+// --- Networked flight ---
+
+void AFighterJetPawn::TickNetworkedFlight(float DeltaTime)
+{
+	if (!IsLocallyControlled())
 	{
-		// Use a sine curve for a smooth lift increase
-		CurrentLiftCoefficient = LiftCoefficient * FMath::Sin(AngleOfAttack * (PI / (2.0f * FMath::DegreesToRadians(CriticalAngleOfAttack))));
+		// The server moves other players' aircraft as their inputs arrive
+		if (!HasAuthority())
+		{
+			InterpolateRemote();
+		}
+		return;
 	}
 
-	// 3. Calculate Lift Force
-	// Lift is perpendicular to the velocity vector.
-	FVector LiftDirection = FVector::CrossProduct(VelocityNormal, AircraftMesh->GetRightVector()).GetSafeNormal();
-	FVector LiftForce = LiftDirection * LocalAirspeed * LocalAirspeed * CurrentLiftCoefficient;
-	AircraftMesh->AddForce(LiftForce);
+	// Long frames are split so every move stays within what the server will simulate
+	int32 NewMoves = 0;
+	float Remaining = DeltaTime;
+	while (Remaining > UE_KINDA_SMALL_NUMBER)
+	{
+		const float MoveTime = FMath::Min(Remaining, FFlightNetInput::MaxDeltaTime);
+		Remaining -= MoveTime;
+
+		FFlightNetInput Input;
+		Input.Sequence = NextInputSequence++;
+		Input.Set(MoveTime, CurrentThrottle, PitchInput, RollInput, YawInput, bIsFiring);
+		StepFlight(Input);
 
-	// 4. Calculate Drag (Parasitic and Induced)
-	// Parasitic drag is from the shape of the aircraft.
-	FVector ParasiticDragForce = -VelocityNormal * LocalAirspeed * LocalAirspeed * DragCoefficient;
-	// Induced drag is a byproduct of generating lift. It's proportional to the square of the lift coefficient.
-	FVector InducedDragForce = -VelocityNormal * LocalAirspeed * LocalAirspeed * (CurrentLiftCoefficient * CurrentLiftCoefficient * InducedDragCoefficient);
-	AircraftMesh->AddForce(ParasiticDragForce + InducedDragForce);
+		if (!HasAuthority())
+		{
+			SavedMoves.Add({ Input, FlightBody });
+			++NewMoves;
+		}
+	}
 
-	// 5. Calculate Thrust
-	FVector ThrustForce = ForwardVector * CurrentThrottle * MaxThrust;
-	AircraftMesh->AddForce(ThrustForce);
+	// A listen server's own aircraft needs no round trip
+	if (HasAuthority())
+	{
+		PublishServerState();
+		return;
+	}
 
-	// 6. Calculate Control Torques (Effectiveness based on Airspeed)
-	float ControlEffectiveness = FMath::GetMappedRangeValueClamped(FVector2D(0.f, 5000.f), FVector2D(0.1f, 1.f), LocalAirspeed);
-	FVector RightVector = AircraftMesh->GetRightVector();
+	if (SavedMoves.Num() > MaxSavedMoves)
+	{
+		SavedMoves.RemoveAt(0, SavedMoves.Num() - MaxSavedMoves, EAllowShrinking::No);
+	}
 
-	AircraftMesh->AddTorqueInDegrees(RightVector * PitchInput * PitchSpeed * ControlEffectiveness, NAME_None, true);
-	AircraftMesh->AddTorqueInDegrees(ForwardVector * RollInput * RollSpeed * ControlEffectiveness, NAME_None, true);
-	AircraftMesh->AddTorqueInDegrees(UpVector * YawInput * YawSpeed * ControlEffectiveness, NAME_None, true);
+	// Each packet repeats the last few moves, which the server skips if it has already run them
+	const int32 NumToSend = FMath::Min3(SavedMoves.Num(), FMath::Max(NewMoves, InputRedundancy), MaxInputsPerPacket);
+	OutgoingInputs.Reset();
+	for (int32 i = SavedMoves.Num() - NumToSend; i < SavedMoves.Num(); ++i)
+	{
+		OutgoingInputs.Add(SavedMoves[i].Input);
+	}
+	if (OutgoingInputs.Num() > 0)
+	{
+		ServerSendInputs(OutgoingInputs);
+	}
 }
 
+void AFighterJetPawn::StepFlight(const FFlightNetInput& Input)
+{
+	FLIGHTSIM_SCOPE(Aerodynamics, ApplyAerodynamics);
+
+	const float DeltaTime = Input.GetDeltaTime();
+
+	CheckIfOnGround();
+
+	FVector Force = FVector::ZeroVector;
+	FVector AngularAcceleration = FVector::ZeroVector;
+	if (!bIsOnGround)
+	{
+		EvaluateFlightModel(FlightBody.Velocity, FlightBody.Rotation, Input.GetThrottle(), Input.GetPitch(), Input.GetRoll(), Input.GetYaw(), Force, AngularAcceleration);
+	}
+
+	FlightModel::IntegrateBody(FlightBody, Force, AngularAcceleration, BodyMass, AircraftMesh->GetLinearDamping(), AircraftMesh->GetAngularDamping(), GetWorld()->GetGravityZ(), DeltaTime);
+
+	// Sweep to the integrated position and slide along whatever is in the way. Hits are dispatched from here,
+	// before the velocity is changed, so OnPawnHit sees the closing speed.
+	FHitResult Hit;
+	AircraftMesh->SetWorldLocationAndRotation(FlightBody.Location, FlightBody.Rotation, true, &Hit);
+	if (Hit.bStartPenetrating)
+	{
+		// Already overlapping, e.g. after a correction; the sweep would never let go
+		AircraftMesh->SetWorldLocationAndRotation(FlightBody.Location, FlightBody.Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+	}
+	else if (Hit.bBlockingHit)
+	{
+		FlightBody.Location = AircraftMesh->GetComponentLocation();
+		if (FVector::DotProduct(FlightBody.Velocity, Hit.ImpactNormal) < 0.0f)
+		{
+			FlightBody.Velocity = FVector::VectorPlaneProject(FlightBody.Velocity, Hit.ImpactNormal);
+		}
+	}
+
+	AircraftMesh->ComponentVelocity = FlightBody.Velocity;
+}
+
+void AFighterJetPawn::SetBodyTransform(const FFlightBodyState& Body)
+{
+	AircraftMesh->SetWorldLocationAndRotation(Body.Location, Body.Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+	AircraftMesh->ComponentVelocity = Body.Velocity;
+}
+
+void AFighterJetPawn::PublishServerState()
+{
+	ServerState.FromBody(FlightBody);
+	ServerState.ServerTime = static_cast<float>(GetWorld()->GetTimeSeconds());
+	ServerState.LastInputSequence = LastProcessedInput;
+	ServerState.Throttle = static_cast<uint8>(FMath::RoundToInt(CurrentThrottle * 255.0f));
+	ServerState.bFiring = bIsFiring;
+}
+
+void AFighterJetPawn::ServerSendInputs_Implementation(const TArray<FFlightNetInput>& Inputs)
+{
+	FLIGHTSIM_STAT_SCOPE(NetServerMove);
+
+	if (HealthComponent && HealthComponent->IsDead()) return;
+
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+
+	// The client's moves may only add up to the server time that has passed, plus a little slack for packets
+	// that were held up
+	const double Now = GetWorld()->GetTimeSeconds();
+	if (LastMoveBudgetTime < 0.0)
+	{
+		ServerMoveTimeBudget = MaxMoveTimeAhead;
+	}
+	else
+	{
+		ServerMoveTimeBudget = FMath::Min(ServerMoveTimeBudget + static_cast<float>(Now - LastMoveBudgetTime), MaxMoveTimeAhead);
+	}
+	LastMoveBudgetTime = Now;
+
+	// Only the newest moves of an oversized packet are looked at
+	const int32 FirstInput = FMath::Max(Inputs.Num() - MaxInputsPerPacket, 0);
+
+	bool bMoved = false;
+	for (int32 i = FirstInput; i < Inputs.Num(); ++i)
+	{
+		FFlightNetInput Input = Inputs[i];
+
+		// Repeated and out-of-order moves are dropped. Sequences wrap, so compare the signed difference.
+		if (bHasProcessedInput && static_cast<int16>(Input.Sequence - LastProcessedInput) <= 0) continue;
+
+		// Out of time: the rest waits for a later packet, by which time the client is corrected
+		if (ServerMoveTimeBudget <= UE_KINDA_SMALL_NUMBER) break;
+		if (Input.GetDeltaTime() > ServerMoveTimeBudget)
+		{
+			Input.DeltaTime = static_cast<uint16>(FMath::FloorToInt32(ServerMoveTimeBudget * 10000.0f));
+		}
+		ServerMoveTimeBudget -= Input.GetDeltaTime();
+
+		CurrentThrottle = Input.GetThrottle();
+		PitchInput = Input.GetPitch();
+		RollInput = Input.GetRoll();
+		YawInput = Input.GetYaw();
+		if (Input.bFiring && !bIsFiring)
+		{
+			StartFire();
+		}
+		else if (!Input.bFiring && bIsFiring)
+		{
+			StopFire();
+		}
+
+		StepFlight(Input);
+		LastProcessedInput = Input.Sequence;
+		bHasProcessedInput = true;
+		bMoved = true;
+	}
+
+	if (bMoved)
+	{
+		PublishServerState();
+	}
+
+	ServerMoveCycles += FPlatformTime::Cycles64() - StartCycles;
+}
+
+void AFighterJetPawn::ServerFireMissile_Implementation(AActor* Target)
+{
+	if (!IsValid(Target) || FVector::DistSquared(Target->GetActorLocation(), GetActorLocation()) > FMath::Square(LockRange)) return;
+
+	LockedTarget = Target;
+	FireMissile();
+}
+
+double AFighterJetPawn::ConsumeServerMoveMilliseconds()
+{
+	const double Milliseconds = FPlatformTime::ToMilliseconds64(ServerMoveCycles);
+	ServerMoveCycles = 0;
+	return Milliseconds;
+}
+
+void AFighterJetPawn::OnRep_ServerState()
+{
+	if (IsLocallyControlled())
+	{
+		if (HasActorBegunPlay())
+		{
+			ReconcileWithServer();
+		}
+		return;
+	}
+
+	// States can arrive out of order over an unreliable channel
+	if (Snapshots.Num() == 0 || ServerState.ServerTime > Snapshots.Last().ServerTime)
+	{
+		Snapshots.Add({ ServerState.ServerTime, ServerState.ToBody() });
+
+		// About a second of history is far more than interpolation needs
+		constexpr int32 MaxSnapshots = 32;
+		if (Snapshots.Num() > MaxSnapshots)
+		{
+			Snapshots.RemoveAt(0, Snapshots.Num() - MaxSnapshots, EAllowShrinking::No);
+		}
+	}
+
+	CurrentThrottle = ServerState.Throttle / 255.0f;
+	// Remote aircraft fire for the tracers and muzzle flashes only; the server's rounds deal the damage
+	if (ServerState.bFiring && !bIsFiring)
+	{
+		StartFire();
+	}
+	else if (!ServerState.bFiring && bIsFiring)
+	{
+		StopFire();
+	}
+}
+
+void AFighterJetPawn::ReconcileWithServer()
+{
+	FLIGHTSIM_STAT_SCOPE(NetReconcile);
+
+	// Moves up to the one the server last ran are settled either way
+	int32 NumAcknowledged = 0;
+	while (NumAcknowledged < SavedMoves.Num() && static_cast<int16>(SavedMoves[NumAcknowledged].Input.Sequence - ServerState.LastInputSequence) <= 0)
+	{
+		++NumAcknowledged;
+	}
+	if (NumAcknowledged == 0) return;
+
+	const FFlightBodyState ServerBody = ServerState.ToBody();
+	const float Error = FVector::Dist(SavedMoves[NumAcknowledged - 1].Result.Location, ServerBody.Location);
+	SavedMoves.RemoveAt(0, NumAcknowledged, EAllowShrinking::No);
+
+	if (Error <= CorrectionThreshold) return;
+
+	// Rewind to the server's state and run the unacknowledged moves again on top of it
+	++NumCorrections;
+	FlightBody = ServerBody;
+	SetBodyTransform(FlightBody);
+	for (FSavedMove& Move : SavedMoves)
+	{
+		StepFlight(Move.Input);
+		Move.Result = FlightBody;
+	}
+}
+
+void AFighterJetPawn::InterpolateRemote()
+{
+	if (Snapshots.Num() == 0) return;
+
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	const double ServerTime = GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+	const float RenderTime = static_cast<float>(ServerTime) - InterpolationDelay;
+
+	// Keep the newest state at or before the render time as the first entry
+	while (Snapshots.Num() > 2 && Snapshots[1].ServerTime <= RenderTime)
+	{
+		Snapshots.RemoveAt(0, 1, EAllowShrinking::No);
+	}
+
+	FFlightBodyState Body;
+	if (Snapshots.Num() >= 2 && RenderTime <= Snapshots[1].ServerTime)
+	{
+		const FStateSnapshot& From = Snapshots[0];
+		const FStateSnapshot& To = Snapshots[1];
+		const float Span = FMath::Max(To.ServerTime - From.ServerTime, UE_KINDA_SMALL_NUMBER);
+		const float Alpha = FMath::Clamp((RenderTime - From.ServerTime) / Span, 0.0f, 1.0f);
+
+		// Hermite curve with the velocities as tangents, so turns stay round between updates
+		Body.Location = FMath::CubicInterp(From.State.Location, From.State.Velocity * Span, To.State.Location, To.State.Velocity * Span, Alpha);
+		Body.Rotation = FQuat::Slerp(From.State.Rotation, To.State.Rotation, Alpha);
+		Body.Velocity = FMath::Lerp(From.State.Velocity, To.State.Velocity, Alpha);
+		Body.AngularVelocity = FMath::Lerp(From.State.AngularVelocity, To.State.AngularVelocity, Alpha);
+	}
+	else
+	{
+		// Updates are late: carry on from the newest state for a while, then hold
+		Body = Snapshots.Last().State;
+		const float Extrapolation = FMath::Clamp(RenderTime - Snapshots.Last().ServerTime, 0.0f, MaxExtrapolationTime);
+		FlightModel::IntegrateBody(Body, FVector::ZeroVector, FVector::ZeroVector, 1.0f, 0.0f, 0.0f, 0.0f, Extrapolation);
+	}
+
+	SetBodyTransform(Body);
+}
@@ -0,0 +1,239 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#include "FlightEffectsSubsystem.h"
+#include "FlightSimProfiling.h"
+#include "Particles/ParticleSystem.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Components/AudioComponent.h"
+#include "Sound/SoundBase.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+
+bool UFlightEffectsSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UFlightEffectsSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFlightEffectsSubsystem, STATGROUP_Tickables);
+}
+
+const FFlightEffectCategorySettings& UFlightEffectsSubsystem::GetSettings(EFlightEffectCategory Category) const
+{
+	return Category == EFlightEffectCategory::Explosion ? Explosions : MuzzleFlashes;
+}
+
+void UFlightEffectsSubsystem::SpawnEffect(EFlightEffectCategory Category, UParticleSystem* Template, const FVector& Location, const FRotator& Rotation)
+{
+	if (!Template || GetWorld()->GetNetMode() == NM_DedicatedServer) return;
+
+	PendingEffects.Add({ Template, Location, Rotation, Category, 0.0f });
+}
+
+void UFlightEffectsSubsystem::StartLoopingSound(AActor* Source, USoundBase* Sound)
+{
+	if (!Source || !Sound || !Source->GetRootComponent() || GetWorld()->GetNetMode() == NM_DedicatedServer) return;
+
+	FLoopingSound& Loop = LoopingSounds.FindOrAdd(Source);
+	UAudioComponent* Audio = Loop.Audio.Get();
+	if (!Audio)
+	{
+		// Owned by the shooter, so it goes away with it
+		Audio = NewObject<UAudioComponent>(Source);
+		Audio->bAutoActivate = false;
+		Audio->bAutoDestroy = false;
+		Audio->SetupAttachment(Source->GetRootComponent());
+		Audio->RegisterComponent();
+		Loop.Audio = Audio;
+	}
+	if (Audio->Sound != Sound)
+	{
+		Audio->SetSound(Sound);
+	}
+
+	// Played from the tick, if it is among the nearest
+	Loop.bWanted = true;
+}
+
+void UFlightEffectsSubsystem::StopLoopingSound(AActor* Source)
+{
+	FLoopingSound* Loop = LoopingSounds.Find(Source);
+	if (!Loop) return;
+
+	Loop->bWanted = false;
+	if (UAudioComponent* Audio = Loop->Audio.Get())
+	{
+		Audio->Stop();
+	}
+}
+
+void UFlightEffectsSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	FLIGHTSIM_SCOPE(Weapons, EffectsTick);
+
+	NumSpawned = 0;
+	NumCulled = 0;
+	if (UpdateView())
+	{
+		SpawnPendingEffects();
+		UpdateLoopingSounds();
+	}
+	else
+	{
+		// Nobody to show them to
+		NumCulled = PendingEffects.Num();
+	}
+	PendingEffects.Reset();
+
+	FLIGHTSIM_SET_COUNTER(ActiveEffects, ActiveEffects.Num());
+	FLIGHTSIM_SET_COUNTER(EffectsSpawned, NumSpawned);
+	FLIGHTSIM_SET_COUNTER(EffectsCulled, NumCulled);
+}
+
+bool UFlightEffectsSubsystem::UpdateView()
+{
+	APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	if (!PlayerController || !PlayerController->IsLocalController()) return false;
+
+	FRotator ViewRotation;
+	PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+	ViewDirection = ViewRotation.Vector();
+
+	const float HalfFov = FMath::DegreesToRadians(PlayerController->PlayerCameraManager ? PlayerController->PlayerCameraManager->GetFOVAngle() * 0.5f : 45.0f);
+	CosHalfFov = FMath::Cos(HalfFov);
+	TanHalfFov = FMath::Max(FMath::Tan(HalfFov), KINDA_SMALL_NUMBER);
+	return true;
+}
+
+void UFlightEffectsSubsystem::SpawnPendingEffects()
+{
+	if (PendingEffects.Num() == 0) return;
+
+	for (int32 i = PendingEffects.Num() - 1; i >= 0; --i)
+	{
+		FEffectRequest& Request = PendingEffects[i];
+		const FFlightEffectCategorySettings& Settings = GetSettings(Request.Category);
+
+		const FVector ToEffect = Request.Location - ViewLocation;
+		const float Distance = FMath::Max(ToEffect.Size(), 1.0f);
+
+		// Fraction of the view the effect would cover
+		Request.ScreenSize = Settings.Radius / (Distance * TanHalfFov);
+
+		const bool bOffScreen = FVector::DotProduct(ViewDirection, ToEffect) < CosHalfFov * Distance - Settings.Radius;
+		if (Distance > Settings.CullDistance || Request.ScreenSize < Settings.MinScreenSize || (Settings.bCullOffScreen && bOffScreen))
+		{
+			PendingEffects.RemoveAtSwap(i, EAllowShrinking::No);
+			++NumCulled;
+		}
+	}
+
+	// The frame's budget goes to what shows most
+	PendingEffects.Sort([](const FEffectRequest& A, const FEffectRequest& B) { return A.ScreenSize > B.ScreenSize; });
+
+	for (const FEffectRequest& Request : PendingEffects)
+	{
+		const int32 CategoryIndex = static_cast<int32>(Request.Category);
+		if (NumSpawned >= SpawnBudgetPerFrame || ActiveCounts[CategoryIndex] >= GetSettings(Request.Category).MaxActive)
+		{
+			++NumCulled;
+			continue;
+		}
+
+		UParticleSystemComponent* Component = AcquireComponent(Request.Template);
+		if (!Component) continue;
+
+		Component->SetWorldLocationAndRotation(Request.Location, Request.Rotation);
+		Component->ActivateSystem(true);
+
+		ActiveEffects.Add(Component);
+		ActiveCategories.Add(Request.Category);
+		++ActiveCounts[CategoryIndex];
+		++NumSpawned;
+	}
+}
+
+UParticleSystemComponent* UFlightEffectsSubsystem::AcquireComponent(UParticleSystem* Template)
+{
+	FFlightEffectPool& Pool = Pools.FindOrAdd(Template);
+	if (Pool.Free.Num() > 0)
+	{
+		return Pool.Free.Pop(EAllowShrinking::No);
+	}
+
+	if (!EffectsActor)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		EffectsActor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+		if (!EffectsActor) return nullptr;
+	}
+
+	// Unattached, so the world transform is set directly on every use
+	UParticleSystemComponent* Component = NewObject<UParticleSystemComponent>(EffectsActor);
+	Component->bAutoActivate = false;
+	Component->bAutoDestroy = false;
+	Component->SetTemplate(Template);
+	Component->OnSystemFinished.AddDynamic(this, &UFlightEffectsSubsystem::OnEffectFinished);
+	Component->RegisterComponent();
+	return Component;
+}
+
+void UFlightEffectsSubsystem::OnEffectFinished(UParticleSystemComponent* Component)
+{
+	const int32 Index = ActiveEffects.Find(Component);
+	if (Index == INDEX_NONE) return;
+
+	--ActiveCounts[static_cast<int32>(ActiveCategories[Index])];
+	ActiveEffects.RemoveAtSwap(Index, EAllowShrinking::No);
+	ActiveCategories.RemoveAtSwap(Index, EAllowShrinking::No);
+	Pools.FindOrAdd(Component->Template).Free.Add(Component);
+}
+
+void UFlightEffectsSubsystem::UpdateLoopingSounds()
+{
+	LoopCandidates.Reset();
+	for (auto It = LoopingSounds.CreateIterator(); It; ++It)
+	{
+		const AActor* Source = It->Key.Get();
+		UAudioComponent* Audio = It->Value.Audio.Get();
+		if (!Source || !Audio)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+		if (!It->Value.bWanted) continue;
+
+		const float DistanceSquared = FVector::DistSquared(Source->GetActorLocation(), ViewLocation);
+		if (DistanceSquared > FMath::Square(LoopingSoundCullDistance))
+		{
+			if (Audio->IsPlaying())
+			{
+				Audio->Stop();
+			}
+			continue;
+		}
+		LoopCandidates.Add({ Audio, DistanceSquared });
+	}
+
+	// Only the nearest guns are heard
+	LoopCandidates.Sort([](const FLoopCandidate& A, const FLoopCandidate& B) { return A.DistanceSquared < B.DistanceSquared; });
+	for (int32 i = 0; i < LoopCandidates.Num(); ++i)
+	{
+		UAudioComponent* Audio = LoopCandidates[i].Audio;
+		if (i < MaxLoopingSounds)
+		{
+			if (!Audio->IsPlaying())
+			{
+				Audio->Play();
+			}
+		}
+		else if (Audio->IsPlaying())
+		{
+			Audio->Stop();
+		}
+	}
+}
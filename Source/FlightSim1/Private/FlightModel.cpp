@@ -0,0 +1,296 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#include "FlightModel.h"
+#include "Math/VectorRegister.h"
+
+namespace
+{
+	// Linear interpolation into Samples spread uniformly over [Min, Max]; clamps outside the range
+	FORCEINLINE float SampleUniform(const float* Samples, int32 Num, float Min, float Max, float X)
+	{
+		const float Position = FMath::Clamp((X - Min) / (Max - Min), 0.0f, 1.0f) * (Num - 1);
+		const int32 Index = FMath::Min(static_cast<int32>(Position), Num - 2);
+		const float Alpha = Position - Index;
+		return Samples[Index] + (Samples[Index + 1] - Samples[Index]) * Alpha;
+	}
+}
+
+float FAeroTables::GetLift(float SinAlpha) const
+{
+	return SampleUniform(Lift.GetData(), Lift.Num(), -1.0f, 1.0f, SinAlpha);
+}
+
+float FAeroTables::GetDrag(float SinAlpha, float Mach) const
+{
+	const int32 AlphaSamples = Drag.Num() / DragMachSamples;
+	if (DragMachSamples < 2 || MaxMach <= 0.0f)
+	{
+		return SampleUniform(Drag.GetData(), AlphaSamples, -1.0f, 1.0f, SinAlpha);
+	}
+
+	// Bilinear: interpolate along Mach in the two rows bracketing the angle of attack
+	const float RowPosition = FMath::Clamp((SinAlpha + 1.0f) * 0.5f, 0.0f, 1.0f) * (AlphaSamples - 1);
+	const int32 Row = FMath::Min(static_cast<int32>(RowPosition), AlphaSamples - 2);
+	const float RowAlpha = RowPosition - Row;
+
+	const float* RowA = Drag.GetData() + Row * DragMachSamples;
+	const float* RowB = RowA + DragMachSamples;
+	const float DragA = SampleUniform(RowA, DragMachSamples, 0.0f, MaxMach, Mach);
+	const float DragB = SampleUniform(RowB, DragMachSamples, 0.0f, MaxMach, Mach);
+	return DragA + (DragB - DragA) * RowAlpha;
+}
+
+float FAeroTables::GetControlEffectiveness(float Airspeed) const
+{
+	return SampleUniform(ControlEffectiveness.GetData(), ControlEffectiveness.Num(), 0.0f, MaxControlSpeed, Airspeed);
+}
+
+void FAeroTables::BuildLegacy(float LiftCoefficient, float DragCoefficient, float InducedDragCoefficient, float CriticalAngleOfAttackDegrees, int32 AlphaSamples)
+{
+	AlphaSamples = FMath::Max(AlphaSamples, 2);
+	const float CriticalAngle = FMath::Max(FMath::DegreesToRadians(CriticalAngleOfAttackDegrees), UE_SMALL_NUMBER);
+
+	Lift.SetNumUninitialized(AlphaSamples);
+	Drag.SetNumUninitialized(AlphaSamples);
+	DragMachSamples = 1;
+	MaxMach = 0.0f;
+
+	for (int32 i = 0; i < AlphaSamples; ++i)
+	{
+		const float SinAlpha = -1.0f + 2.0f * i / (AlphaSamples - 1);
+		const float AngleOfAttack = FMath::Asin(SinAlpha);
+		const float Cl = FMath::Abs(AngleOfAttack) < CriticalAngle ? LiftCoefficient * FMath::Sin(AngleOfAttack * UE_HALF_PI / CriticalAngle) : 0.0f;
+
+		Lift[i] = Cl;
+		Drag[i] = DragCoefficient + Cl * Cl * InducedDragCoefficient;
+	}
+
+	// Linear ramp, two samples reproduce it exactly
+	ControlEffectiveness = { 0.1f, 1.0f };
+	MaxControlSpeed = 5000.0f;
+}
+
+void FFlightModelBatch::SetNum(int32 NewNum)
+{
+	NumAircraft = NewNum;
+	const int32 Padded = Align(NewNum, 4);
+
+	for (TArray<float>* Column : {
+		&VelX, &VelY, &VelZ, &ForwardX, &ForwardY, &ForwardZ, &RightX, &RightY, &RightZ, &UpX, &UpY, &UpZ,
+		&Throttle, &PitchInput, &RollInput, &YawInput, &Active,
+		&MaxThrust, &LiftCoefficient, &DragCoefficient,
+		&PitchRate, &RollRate, &YawRate,
+		&ForceX, &ForceY, &ForceZ, &TorqueX, &TorqueY, &TorqueZ })
+	{
+		Column->SetNumZeroed(Padded, EAllowShrinking::No);
+	}
+	Tables.SetNumZeroed(Padded, EAllowShrinking::No);
+}
+
+void FFlightModelBatch::SetState(int32 Index, const FVector& Velocity, const FVector& Forward, const FVector& Right, const FVector& Up)
+{
+	VelX[Index] = Velocity.X; VelY[Index] = Velocity.Y; VelZ[Index] = Velocity.Z;
+	ForwardX[Index] = Forward.X; ForwardY[Index] = Forward.Y; ForwardZ[Index] = Forward.Z;
+	RightX[Index] = Right.X; RightY[Index] = Right.Y; RightZ[Index] = Right.Z;
+	UpX[Index] = Up.X; UpY[Index] = Up.Y; UpZ[Index] = Up.Z;
+}
+
+void FFlightModelBatch::SetControls(int32 Index, float InThrottle, float InPitch, float InRoll, float InYaw, bool bInActive)
+{
+	Throttle[Index] = InThrottle;
+	PitchInput[Index] = InPitch;
+	RollInput[Index] = InRoll;
+	YawInput[Index] = InYaw;
+	Active[Index] = bInActive ? 1.0f : 0.0f;
+}
+
+void FFlightModelBatch::SetTuning(int32 Index, float InMaxThrust, float InLiftCoefficient, float InDragCoefficient, float InPitchRate, float InRollRate, float InYawRate)
+{
+	MaxThrust[Index] = InMaxThrust;
+	LiftCoefficient[Index] = InLiftCoefficient;
+	DragCoefficient[Index] = InDragCoefficient;
+	PitchRate[Index] = InPitchRate;
+	RollRate[Index] = InRollRate;
+	YawRate[Index] = InYawRate;
+}
+
+namespace FlightModel
+{
+	namespace
+	{
+		// Three lanes-of-four registers forming one vector per aircraft
+		struct FVec3x4
+		{
+			VectorRegister4Float X, Y, Z;
+		};
+
+		FORCEINLINE FVec3x4 Load3(const TArray<float>& X, const TArray<float>& Y, const TArray<float>& Z, int32 i)
+		{
+			return { VectorLoad(&X[i]), VectorLoad(&Y[i]), VectorLoad(&Z[i]) };
+		}
+
+		FORCEINLINE void Store3(const FVec3x4& V, TArray<float>& X, TArray<float>& Y, TArray<float>& Z, int32 i)
+		{
+			VectorStore(V.X, &X[i]);
+			VectorStore(V.Y, &Y[i]);
+			VectorStore(V.Z, &Z[i]);
+		}
+
+		FORCEINLINE FVec3x4 Scale(const FVec3x4& V, const VectorRegister4Float& S)
+		{
+			return { VectorMultiply(V.X, S), VectorMultiply(V.Y, S), VectorMultiply(V.Z, S) };
+		}
+
+		FORCEINLINE FVec3x4 Add(const FVec3x4& A, const FVec3x4& B)
+		{
+			return { VectorAdd(A.X, B.X), VectorAdd(A.Y, B.Y), VectorAdd(A.Z, B.Z) };
+		}
+
+		FORCEINLINE VectorRegister4Float Dot(const FVec3x4& A, const FVec3x4& B)
+		{
+			return VectorMultiplyAdd(A.X, B.X, VectorMultiplyAdd(A.Y, B.Y, VectorMultiply(A.Z, B.Z)));
+		}
+
+		FORCEINLINE FVec3x4 Cross(const FVec3x4& A, const FVec3x4& B)
+		{
+			return {
+				VectorSubtract(VectorMultiply(A.Y, B.Z), VectorMultiply(A.Z, B.Y)),
+				VectorSubtract(VectorMultiply(A.Z, B.X), VectorMultiply(A.X, B.Z)),
+				VectorSubtract(VectorMultiply(A.X, B.Y), VectorMultiply(A.Y, B.X)) };
+		}
+
+		// 1/sqrt(x) where x is above Threshold, 0 elsewhere; matches GetSafeNormal's zero-vector fallback
+		FORCEINLINE VectorRegister4Float SafeInvSqrt(const VectorRegister4Float& X, const VectorRegister4Float& Threshold)
+		{
+			const VectorRegister4Float Mask = VectorCompareGT(X, Threshold);
+			return VectorSelect(Mask, VectorDivide(VectorOneFloat(), VectorSqrt(VectorMax(X, Threshold))), VectorZeroFloat());
+		}
+	}
+
+	void EvaluateAerodynamics(FFlightModelBatch& Batch)
+	{
+		const VectorRegister4Float Zero = VectorZeroFloat();
+		const VectorRegister4Float One = VectorOneFloat();
+		const VectorRegister4Float MinSpeedSquared = VectorSetFloat1(1.0f);
+		const VectorRegister4Float NormalizeThreshold = VectorSetFloat1(UE_SMALL_NUMBER);
+
+		alignas(16) float SinAlphaLanes[4];
+		alignas(16) float SpeedLanes[4];
+		alignas(16) float LiftLanes[4];
+		alignas(16) float DragLanes[4];
+		alignas(16) float EffectivenessLanes[4];
+		alignas(16) float HasTablesLanes[4];
+
+		const int32 PaddedNum = Batch.Throttle.Num();
+		for (int32 i = 0; i < PaddedNum; i += 4)
+		{
+			const FVec3x4 Velocity = Load3(Batch.VelX, Batch.VelY, Batch.VelZ, i);
+			const FVec3x4 Forward = Load3(Batch.ForwardX, Batch.ForwardY, Batch.ForwardZ, i);
+			const FVec3x4 Right = Load3(Batch.RightX, Batch.RightY, Batch.RightZ, i);
+			const FVec3x4 Up = Load3(Batch.UpX, Batch.UpY, Batch.UpZ, i);
+
+			// Lanes below 1 cm/s, inactive lanes and padding produce no force
+			const VectorRegister4Float SpeedSquared = Dot(Velocity, Velocity);
+			const VectorRegister4Float Speed = VectorSqrt(SpeedSquared);
+			const VectorRegister4Float Valid = VectorSelect(VectorCompareGE(SpeedSquared, MinSpeedSquared), VectorLoad(&Batch.Active[i]), Zero);
+
+			const FVec3x4 VelocityNormal = Scale(Velocity, SafeInvSqrt(SpeedSquared, NormalizeThreshold));
+
+			// 1. Sine of the angle of attack between the flight path and the up vector; the tables are indexed by it directly
+			VectorStoreAligned(VectorMin(VectorMax(Dot(VelocityNormal, Up), VectorNegate(One)), One), SinAlphaLanes);
+			VectorStoreAligned(Speed, SpeedLanes);
+
+			// 2. Coefficient lookups, one lane at a time since each aircraft may use its own tables
+			for (int32 Lane = 0; Lane < 4; ++Lane)
+			{
+				const FAeroTables* Tables = Batch.Tables[i + Lane];
+				if (Tables && Tables->IsValid())
+				{
+					LiftLanes[Lane] = Tables->GetLift(SinAlphaLanes[Lane]);
+					DragLanes[Lane] = Tables->GetDrag(SinAlphaLanes[Lane], SpeedLanes[Lane] * (1.0f / SpeedOfSound));
+					EffectivenessLanes[Lane] = Tables->GetControlEffectiveness(SpeedLanes[Lane]);
+					HasTablesLanes[Lane] = 1.0f;
+				}
+				else
+				{
+					LiftLanes[Lane] = DragLanes[Lane] = EffectivenessLanes[Lane] = HasTablesLanes[Lane] = 0.0f;
+				}
+			}
+
+			// Aircraft without tables are switched off like inactive ones
+			const VectorRegister4Float Enabled = VectorMultiply(Valid, VectorLoadAligned(HasTablesLanes));
+
+			// 3. Lift perpendicular to the flight path
+			const FVec3x4 LiftAxis = Cross(VelocityNormal, Right);
+			const FVec3x4 LiftDirection = Scale(LiftAxis, SafeInvSqrt(Dot(LiftAxis, LiftAxis), NormalizeThreshold));
+			const FVec3x4 Lift = Scale(LiftDirection, VectorMultiply(SpeedSquared, VectorLoadAligned(LiftLanes)));
+
+			// 4. Drag opposing the flight path
+			const FVec3x4 Drag = Scale(VelocityNormal, VectorNegate(VectorMultiply(SpeedSquared, VectorLoadAligned(DragLanes))));
+
+			// 5. Thrust along the nose
+			const FVec3x4 Thrust = Scale(Forward, VectorMultiply(VectorLoad(&Batch.Throttle[i]), VectorLoad(&Batch.MaxThrust[i])));
+
+			Store3(Scale(Add(Add(Lift, Drag), Thrust), Enabled), Batch.ForceX, Batch.ForceY, Batch.ForceZ, i);
+
+			// 6. Control torques scaled by airspeed effectiveness
+			const VectorRegister4Float Effectiveness = VectorMultiply(VectorLoadAligned(EffectivenessLanes), Enabled);
+
+			const FVec3x4 PitchTorque = Scale(Right, VectorMultiply(VectorLoad(&Batch.PitchInput[i]), VectorLoad(&Batch.PitchRate[i])));
+			const FVec3x4 RollTorque = Scale(Forward, VectorMultiply(VectorLoad(&Batch.RollInput[i]), VectorLoad(&Batch.RollRate[i])));
+			const FVec3x4 YawTorque = Scale(Up, VectorMultiply(VectorLoad(&Batch.YawInput[i]), VectorLoad(&Batch.YawRate[i])));
+
+			Store3(Scale(Add(Add(PitchTorque, RollTorque), YawTorque), Effectiveness), Batch.TorqueX, Batch.TorqueY, Batch.TorqueZ, i);
+		}
+	}
+
+	void EvaluateBasicAerodynamics(FFlightModelBatch& Batch)
+	{
+		const int32 PaddedNum = Batch.Throttle.Num();
+		for (int32 i = 0; i < PaddedNum; i += 4)
+		{
+			const FVec3x4 Velocity = Load3(Batch.VelX, Batch.VelY, Batch.VelZ, i);
+			const FVec3x4 Forward = Load3(Batch.ForwardX, Batch.ForwardY, Batch.ForwardZ, i);
+			const FVec3x4 Right = Load3(Batch.RightX, Batch.RightY, Batch.RightZ, i);
+			const FVec3x4 Up = Load3(Batch.UpX, Batch.UpY, Batch.UpZ, i);
+			const VectorRegister4Float Active = VectorLoad(&Batch.Active[i]);
+
+			const VectorRegister4Float SpeedSquared = Dot(Velocity, Velocity);
+			const VectorRegister4Float Speed = VectorSqrt(SpeedSquared);
+
+			const FVec3x4 Thrust = Scale(Forward, VectorMultiply(VectorLoad(&Batch.Throttle[i]), VectorLoad(&Batch.MaxThrust[i])));
+			const FVec3x4 Lift = Scale(Up, VectorMultiply(SpeedSquared, VectorLoad(&Batch.LiftCoefficient[i])));
+			const FVec3x4 Drag = Scale(Velocity, VectorNegate(VectorMultiply(Speed, VectorLoad(&Batch.DragCoefficient[i]))));
+
+			Store3(Scale(Add(Add(Thrust, Lift), Drag), Active), Batch.ForceX, Batch.ForceY, Batch.ForceZ, i);
+
+			const FVec3x4 PitchTorque = Scale(Right, VectorMultiply(VectorLoad(&Batch.PitchInput[i]), VectorLoad(&Batch.PitchRate[i])));
+			const FVec3x4 RollTorque = Scale(Forward, VectorMultiply(VectorLoad(&Batch.RollInput[i]), VectorLoad(&Batch.RollRate[i])));
+			const FVec3x4 YawTorque = Scale(Up, VectorMultiply(VectorLoad(&Batch.YawInput[i]), VectorLoad(&Batch.YawRate[i])));
+
+			Store3(Scale(Add(Add(PitchTorque, RollTorque), YawTorque), Active), Batch.TorqueX, Batch.TorqueY, Batch.TorqueZ, i);
+		}
+	}
+
+	void IntegrateBody(FFlightBodyState& State, const FVector& Force, const FVector& AngularAcceleration, float Mass,
+		float LinearDamping, float AngularDamping, float GravityZ, float DeltaTime)
+	{
+		if (DeltaTime <= 0.0f || Mass <= 0.0f) return;
+
+		State.Velocity += (Force / Mass + FVector(0.0f, 0.0f, GravityZ)) * DeltaTime;
+		State.Velocity *= 1.0f / (1.0f + LinearDamping * DeltaTime);
+
+		State.AngularVelocity += AngularAcceleration * DeltaTime;
+		State.AngularVelocity *= 1.0f / (1.0f + AngularDamping * DeltaTime);
+
+		const FVector AngularVelocityRadians = State.AngularVelocity * (UE_PI / 180.0f);
+		const double AngularSpeed = AngularVelocityRadians.Size();
+		if (AngularSpeed > UE_KINDA_SMALL_NUMBER)
+		{
+			const FQuat Spin(AngularVelocityRadians / AngularSpeed, AngularSpeed * DeltaTime);
+			State.Rotation = (Spin * State.Rotation).GetNormalized();
+		}
+
+		State.Location += State.Velocity * DeltaTime;
+	}
+}
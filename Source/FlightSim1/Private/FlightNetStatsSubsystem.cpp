@@ -0,0 +1,107 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#include "FlightNetStatsSubsystem.h"
+#include "FlightSim1.h"
+#include "FighterJetPawn.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/FileManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+bool UFlightNetStatsSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return FParse::Param(FCommandLine::Get(), TEXT("FlightNetStats")) && Super::ShouldCreateSubsystem(Outer);
+}
+
+bool UFlightNetStatsSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UFlightNetStatsSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFlightNetStatsSubsystem, STATGROUP_Tickables);
+}
+
+void UFlightNetStatsSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const TCHAR* CommandLine = FCommandLine::Get();
+	FParse::Value(CommandLine, TEXT("NetStatsInterval="), ReportInterval);
+	ReportInterval = FMath::Max(ReportInterval, 0.5f);
+	TimeUntilReport = ReportInterval;
+
+	if (FParse::Value(CommandLine, TEXT("NetStatsOutput="), OutputPath))
+	{
+		OutputPath = FPaths::ConvertRelativePathToFull(OutputPath);
+		FFileHelper::SaveStringToFile(TEXT("time,role,connection,in_bytes_per_s,out_bytes_per_s,in_packets_per_s,out_packets_per_s,in_loss_pct,out_loss_pct,ping_ms,server_move_ms,corrections,game_thread_ms\n"), *OutputPath);
+	}
+}
+
+void UFlightNetStatsSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	GameThreadMilliseconds += FPlatformTime::ToMilliseconds(GGameThreadTime);
+	++FramesInInterval;
+
+	TimeUntilReport -= DeltaTime;
+	if (TimeUntilReport > 0.0f) return;
+
+	Report();
+	TimeUntilReport = ReportInterval;
+	GameThreadMilliseconds = 0.0;
+	FramesInInterval = 0;
+}
+
+void UFlightNetStatsSubsystem::Report()
+{
+	UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	if (!NetDriver) return;
+
+	const double AverageGameThread = FramesInInterval > 0 ? GameThreadMilliseconds / FramesInInterval : 0.0;
+
+	if (UNetConnection* ServerConnection = NetDriver->ServerConnection)
+	{
+		const APlayerController* PlayerController = ServerConnection->PlayerController;
+		const AFighterJetPawn* Fighter = PlayerController ? Cast<AFighterJetPawn>(PlayerController->GetPawn()) : nullptr;
+		ReportConnection(TEXT("client"), ServerConnection, 0.0, Fighter ? Fighter->GetNumCorrections() : 0, AverageGameThread);
+		return;
+	}
+
+	UE_LOG(LogFlightSim, Display, TEXT("Net stats: %d client connections, game thread %.2f ms"), NetDriver->ClientConnections.Num(), AverageGameThread);
+
+	for (UNetConnection* Connection : NetDriver->ClientConnections)
+	{
+		if (!Connection) continue;
+
+		// Per frame, so it compares directly with the game thread time
+		AFighterJetPawn* Fighter = Connection->PlayerController ? Cast<AFighterJetPawn>(Connection->PlayerController->GetPawn()) : nullptr;
+		const double ServerMove = Fighter && FramesInInterval > 0 ? Fighter->ConsumeServerMoveMilliseconds() / FramesInInterval : 0.0;
+		ReportConnection(TEXT("server"), Connection, ServerMove, 0, AverageGameThread);
+	}
+}
+
+void UFlightNetStatsSubsystem::ReportConnection(const TCHAR* Role, UNetConnection* Connection, double ServerMoveMilliseconds, int32 Corrections, double AverageGameThreadMilliseconds)
+{
+	const FString Address = Connection->LowLevelGetRemoteAddress(true);
+	const float InLoss = Connection->GetInLossPercentage().GetAvgLossPercentage() * 100.0f;
+	const float OutLoss = Connection->GetOutLossPercentage().GetAvgLossPercentage() * 100.0f;
+	const float PingMilliseconds = Connection->AvgLag * 1000.0f;
+
+	UE_LOG(LogFlightSim, Display, TEXT("Net stats %s %s: in %d B/s, out %d B/s, %d/%d pkt/s, loss %.1f%%/%.1f%%, ping %.0f ms, server move %.3f ms, corrections %d"),
+		Role, *Address, Connection->InBytesPerSecond, Connection->OutBytesPerSecond, Connection->InPacketsPerSecond, Connection->OutPacketsPerSecond,
+		InLoss, OutLoss, PingMilliseconds, ServerMoveMilliseconds, Corrections);
+
+	if (OutputPath.IsEmpty()) return;
+
+	const FString Row = FString::Printf(TEXT("%.2f,%s,%s,%d,%d,%d,%d,%.2f,%.2f,%.1f,%.4f,%d,%.3f\n"),
+		GetWorld()->GetTimeSeconds(), Role, *Address, Connection->InBytesPerSecond, Connection->OutBytesPerSecond,
+		Connection->InPacketsPerSecond, Connection->OutPacketsPerSecond, InLoss, OutLoss, PingMilliseconds,
+		ServerMoveMilliseconds, Corrections, AverageGameThreadMilliseconds);
+	FFileHelper::SaveStringToFile(Row, *OutputPath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+}
@@ -0,0 +1,72 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#include "FlightNetTypes.h"
+#include "Engine/NetSerialization.h"
+
+namespace
+{
+	void SerializeBool(FArchive& Ar, bool& bValue)
+	{
+		uint8 Bit = bValue ? 1 : 0;
+		Ar.SerializeBits(&Bit, 1);
+		bValue = Bit != 0;
+	}
+}
+
+void FFlightNetInput::Set(float InDeltaTime, float InThrottle, float InPitch, float InRoll, float InYaw, bool bInFiring)
+{
+	DeltaTime = static_cast<uint16>(FMath::Clamp(FMath::RoundToInt(InDeltaTime * 10000.0f), 1, MAX_uint16));
+	Throttle = static_cast<uint8>(FMath::RoundToInt(FMath::Clamp(InThrottle, 0.0f, 1.0f) * 255.0f));
+	Pitch = static_cast<int8>(FMath::RoundToInt(FMath::Clamp(InPitch, -1.0f, 1.0f) * 127.0f));
+	Roll = static_cast<int8>(FMath::RoundToInt(FMath::Clamp(InRoll, -1.0f, 1.0f) * 127.0f));
+	Yaw = static_cast<int8>(FMath::RoundToInt(FMath::Clamp(InYaw, -1.0f, 1.0f) * 127.0f));
+	bFiring = bInFiring;
+}
+
+bool FFlightNetInput::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	Ar << Sequence;
+	Ar << DeltaTime;
+	Ar << Throttle;
+	Ar << Pitch;
+	Ar << Roll;
+	Ar << Yaw;
+	SerializeBool(Ar, bFiring);
+
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
+
+void FFlightNetState::FromBody(const FFlightBodyState& Body)
+{
+	Location = Body.Location;
+	Rotation = Body.Rotation.Rotator();
+	Velocity = Body.Velocity;
+	AngularVelocity = Body.AngularVelocity;
+}
+
+FFlightBodyState FFlightNetState::ToBody() const
+{
+	FFlightBodyState Body;
+	Body.Location = Location;
+	Body.Rotation = Rotation.Quaternion();
+	Body.Velocity = Velocity;
+	Body.AngularVelocity = AngularVelocity;
+	return Body;
+}
+
+bool FFlightNetState::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	bOutSuccess = SerializePackedVector<1, 24>(Location, Ar);
+	bOutSuccess &= SerializePackedVector<1, 24>(Velocity, Ar);
+	bOutSuccess &= SerializePackedVector<10, 24>(AngularVelocity, Ar);
+	Rotation.SerializeCompressedShort(Ar);
+
+	Ar << ServerTime;
+	Ar << LastInputSequence;
+	Ar << Throttle;
+	SerializeBool(Ar, bFiring);
+
+	bOutSuccess &= !Ar.IsError();
+	return true;
+}
@@ -0,0 +1,342 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#include "FlightRecorderSubsystem.h"
+#include "FlightSim1.h"
+#include "FlightReplayGhost.h"
+#include "FighterJetPawn.h"
+#include "Missile.h"
+#include "AircraftRegistrySubsystem.h"
+#include "MissileGuidanceSubsystem.h"
+#include "FlightSimProfiling.h"
+#include "GenericTeamAgentInterface.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/AssetManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+
+bool UFlightRecorderSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UFlightRecorderSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	Registry = Collection.InitializeDependency<UAircraftRegistrySubsystem>();
+	MissileGuidance = Collection.InitializeDependency<UMissileGuidanceSubsystem>();
+	Damage = Collection.InitializeDependency<UDamageSubsystem>();
+}
+
+void UFlightRecorderSubsystem::Deinitialize()
+{
+	StopRecording();
+	StopPlayback();
+	Super::Deinitialize();
+}
+
+TStatId UFlightRecorderSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFlightRecorderSubsystem, STATGROUP_Tickables);
+}
+
+void UFlightRecorderSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	const TCHAR* CommandLine = FCommandLine::Get();
+
+	FString ReplayFile;
+	if (FParse::Value(CommandLine, TEXT("FlightReplay="), ReplayFile))
+	{
+		StartPlayback(ReplayFile);
+		return;
+	}
+
+	if ((bRecordOnBeginPlay || FParse::Param(CommandLine, TEXT("FlightRecord"))) && !FParse::Param(CommandLine, TEXT("NoFlightRecorder")))
+	{
+		const FString Filename = FString::Printf(TEXT("%s_%s.fsrec"), *UWorld::RemovePIEPrefix(InWorld.GetMapName()), *FDateTime::Now().ToString());
+		StartRecording(FPaths::ProjectSavedDir() / TEXT("FlightRecordings") / Filename);
+	}
+}
+
+void UFlightRecorderSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (Writer)
+	{
+		CaptureFrame();
+	}
+
+	if (Replay)
+	{
+		AdvancePlayback(DeltaTime);
+	}
+}
+
+// --- Recording ---
+
+bool UFlightRecorderSubsystem::StartRecording(const FString& Filename)
+{
+	StopRecording();
+
+	Writer = MakeUnique<FFlightRecordWriter>(FPaths::ConvertRelativePathToFull(Filename), FrameSlots, FramesPerBlock);
+	if (!Writer->Start())
+	{
+		UE_LOG(LogFlightSim, Warning, TEXT("Flight recorder could not open %s"), *Writer->GetFilename());
+		Writer.Reset();
+		return false;
+	}
+
+	// Entity ids are per file, so every actor gets re-described
+	RecordedActors.Reset();
+	NextEntityId = 1;
+	NextFrameNumber = 0;
+	DroppedFrames = 0;
+	RecordingStartTime = GetWorld()->GetTimeSeconds();
+
+	UE_LOG(LogFlightSim, Log, TEXT("Flight recorder writing %s"), *Writer->GetFilename());
+	return true;
+}
+
+void UFlightRecorderSubsystem::StopRecording()
+{
+	if (!Writer) return;
+
+	Writer->Finish();
+	UE_LOG(LogFlightSim, Log, TEXT("Flight recorder closed %s: %u frames, %u dropped"), *Writer->GetFilename(), NextFrameNumber, DroppedFrames);
+	Writer.Reset();
+}
+
+void UFlightRecorderSubsystem::CaptureFrame()
+{
+	FLIGHTSIM_STAT_SCOPE(RecordFrame);
+
+	FFlightRecordFrame* Frame = Writer->AcquireFrame();
+	if (!Frame)
+	{
+		++DroppedFrames;
+		return;
+	}
+
+	Frame->FrameNumber = NextFrameNumber++;
+	Frame->Time = static_cast<float>(GetWorld()->GetTimeSeconds() - RecordingStartTime);
+
+	if (Registry)
+	{
+		for (int32 Entry = 0; Entry < Registry->GetNumEntries(); ++Entry)
+		{
+			APawn* Aircraft = Registry->GetEntryAircraft(Entry);
+			if (!IsValid(Aircraft)) continue;
+
+			// AI aircraft have no throttle and always thrust
+			const AFighterJetPawn* Fighter = Cast<AFighterJetPawn>(Aircraft);
+			CaptureActor(Aircraft, EFlightRecordKind::Aircraft, Registry->GetEntryTeam(Entry), Fighter ? Fighter->GetThrottle() : 1.0f, *Frame);
+		}
+	}
+
+	if (MissileGuidance)
+	{
+		for (int32 i = 0; i < MissileGuidance->GetNumMissilesInFlight(); ++i)
+		{
+			CaptureActor(MissileGuidance->GetMissile(i), EFlightRecordKind::Missile, FGenericTeamId::NoTeam.GetId(), 1.0f, *Frame);
+		}
+	}
+
+	Writer->SubmitFrame(Frame);
+}
+
+void UFlightRecorderSubsystem::CaptureActor(AActor* Actor, EFlightRecordKind Kind, uint8 Team, float Throttle, FFlightRecordFrame& Frame)
+{
+	FRecordedActor* Recorded = RecordedActors.Find(Actor);
+	if (!Recorded)
+	{
+		Recorded = &RecordedActors.Add(Actor, { NextEntityId++, Damage ? Damage->FindHealth(Actor) : FHealthHandle() });
+
+		FFlightRecordEntity& Entity = Frame.NewEntities.AddDefaulted_GetRef();
+		Entity.EntityId = Recorded->EntityId;
+		Entity.Kind = Kind;
+		Entity.Team = Team;
+		if (const UStaticMeshComponent* Mesh = Actor->FindComponentByClass<UStaticMeshComponent>())
+		{
+			Entity.MeshPath = GetPathNameSafe(Mesh->GetStaticMesh());
+		}
+	}
+
+	const FTransform& Transform = Actor->GetActorTransform();
+
+	FFlightRecordSample& Sample = Frame.Samples.AddDefaulted_GetRef();
+	Sample.EntityId = Recorded->EntityId;
+	Sample.Location = FVector3f(Transform.GetLocation());
+	Sample.Velocity = FVector3f(Actor->GetVelocity());
+	Sample.Rotation = FRotator3f(Transform.Rotator());
+	Sample.Throttle = Throttle;
+	Sample.Health = Damage ? Damage->GetHealth(Recorded->Health) : 0.0f;
+}
+
+// --- Playback ---
+
+bool UFlightRecorderSubsystem::StartPlayback(const FString& Filename)
+{
+	StopPlayback();
+
+	Replay = MakeUnique<FFlightReplayReader>();
+	if (!Replay->Open(FPaths::ConvertRelativePathToFull(Filename)))
+	{
+		UE_LOG(LogFlightSim, Warning, TEXT("Flight recorder could not play %s"), *Filename);
+		Replay.Reset();
+		return false;
+	}
+
+	UE_LOG(LogFlightSim, Log, TEXT("Playing flight recording %s: %.1f s in %d blocks"), *Filename, Replay->GetDuration(), Replay->GetNumBlocks());
+	SeekPlayback(0.0f);
+	return true;
+}
+
+void UFlightRecorderSubsystem::StopPlayback()
+{
+	Replay.Reset();
+	bHasNextFrame = false;
+
+	for (const TPair<uint32, AFlightReplayGhost*>& Ghost : Ghosts)
+	{
+		if (IsValid(Ghost.Value))
+		{
+			Ghost.Value->Destroy();
+		}
+	}
+	Ghosts.Reset();
+}
+
+void UFlightRecorderSubsystem::SeekPlayback(float Time)
+{
+	if (!Replay) return;
+
+	Replay->Seek(Time);
+	PlaybackTime = Time;
+	bHasNextFrame = Replay->ReadFrame(NextFrame);
+	AdvancePlayback(0.0f);
+}
+
+void UFlightRecorderSubsystem::AdvancePlayback(float DeltaTime)
+{
+	FLIGHTSIM_STAT_SCOPE(ReplayPlayback);
+
+	PlaybackTime += DeltaTime * PlaybackRate;
+
+	// Only the latest due frame is shown; the ones skipped over still declare their entities to the reader
+	bool bAdvanced = false;
+	while (bHasNextFrame && NextFrame.Time <= PlaybackTime)
+	{
+		Swap(CurrentFrame, NextFrame);
+		bAdvanced = true;
+		bHasNextFrame = Replay->ReadFrame(NextFrame);
+	}
+
+	if (bAdvanced)
+	{
+		ApplyPlaybackFrame(CurrentFrame);
+	}
+
+	if (!bHasNextFrame && PlaybackTime > Replay->GetDuration())
+	{
+		UE_LOG(LogFlightSim, Log, TEXT("Flight recording finished"));
+		StopPlayback();
+	}
+}
+
+void UFlightRecorderSubsystem::ApplyPlaybackFrame(const FFlightRecordFrame& Frame)
+{
+	++PlaybackFrameCounter;
+
+	for (const FFlightRecordSample& Sample : Frame.Samples)
+	{
+		AFlightReplayGhost* Ghost = FindOrSpawnGhost(Sample.EntityId);
+		if (!Ghost) continue;
+
+		Ghost->SetActorLocationAndRotation(FVector(Sample.Location), FRotator(Sample.Rotation));
+		Ghost->ReplayVelocity = FVector(Sample.Velocity);
+		Ghost->Throttle = Sample.Throttle;
+		Ghost->Health = Sample.Health;
+		Ghost->LastSeenFrame = PlaybackFrameCounter;
+		Ghost->SetActorHiddenInGame(false);
+	}
+
+	// Entities missing from the frame were dead, pooled or not yet spawned at that time
+	for (const TPair<uint32, AFlightReplayGhost*>& Ghost : Ghosts)
+	{
+		if (Ghost.Value && Ghost.Value->LastSeenFrame != PlaybackFrameCounter)
+		{
+			Ghost.Value->SetActorHiddenInGame(true);
+		}
+	}
+}
+
+AFlightReplayGhost* UFlightRecorderSubsystem::FindOrSpawnGhost(uint32 EntityId)
+{
+	if (AFlightReplayGhost** Existing = Ghosts.Find(EntityId))
+	{
+		return *Existing;
+	}
+
+	const FFlightRecordEntity* Entity = Replay->FindEntity(EntityId);
+	if (!Entity) return nullptr;
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	AFlightReplayGhost* Ghost = GetWorld()->SpawnActor<AFlightReplayGhost>(AFlightReplayGhost::StaticClass(), FTransform::Identity, SpawnParams);
+	if (!Ghost) return nullptr;
+
+	Ghost->SetGhostMesh(RequestGhostMesh(Entity->MeshPath));
+	Ghost->Team = Entity->Team;
+	Ghost->bIsMissile = Entity->Kind == EFlightRecordKind::Missile;
+
+	Ghosts.Add(EntityId, Ghost);
+	return Ghost;
+}
+
+UStaticMesh* UFlightRecorderSubsystem::RequestGhostMesh(const FString& Path)
+{
+	if (Path.IsEmpty()) return nullptr;
+
+	if (UStaticMesh** Mesh = GhostMeshes.Find(Path))
+	{
+		return *Mesh;
+	}
+
+	// Meshes of aircraft still in the level are already in memory
+	const FSoftObjectPath MeshPath(Path);
+	UStaticMesh* Mesh = Cast<UStaticMesh>(MeshPath.ResolveObject());
+	GhostMeshes.Add(Path, Mesh);
+	if (!Mesh)
+	{
+		// The handle keeps the mesh loaded for as long as the subsystem lives
+		GhostMeshLoads.Add(Path, UAssetManager::GetStreamableManager().RequestAsyncLoad(MeshPath,
+			FStreamableDelegate::CreateUObject(this, &UFlightRecorderSubsystem::OnGhostMeshLoaded, Path)));
+	}
+	return Mesh;
+}
+
+void UFlightRecorderSubsystem::OnGhostMeshLoaded(FString Path)
+{
+	UStaticMesh* Mesh = Cast<UStaticMesh>(FSoftObjectPath(Path).ResolveObject());
+	if (!Mesh)
+	{
+		UE_LOG(LogFlightSim, Warning, TEXT("Flight recorder could not load ghost mesh %s"), *Path);
+		return;
+	}
+	GhostMeshes.Add(Path, Mesh);
+
+	// Ghosts spawned while the mesh was loading
+	if (!Replay) return;
+	for (const TPair<uint32, AFlightReplayGhost*>& Ghost : Ghosts)
+	{
+		const FFlightRecordEntity* Entity = Replay->FindEntity(Ghost.Key);
+		if (IsValid(Ghost.Value) && Entity && Entity->MeshPath == Path)
+		{
+			Ghost.Value->SetGhostMesh(Mesh);
+		}
+	}
+}
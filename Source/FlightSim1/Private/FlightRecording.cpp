@@ -0,0 +1,525 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#include "FlightRecording.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/Compression.h"
+#include "Misc/Paths.h"
+
+using namespace FlightRecording;
+
+namespace
+{
+	// --- Varints ---
+	void WriteVarUInt(TArray<uint8>& Out, uint32 Value)
+	{
+		while (Value >= 0x80)
+		{
+			Out.Add(static_cast<uint8>(Value | 0x80));
+			Value >>= 7;
+		}
+		Out.Add(static_cast<uint8>(Value));
+	}
+
+	bool ReadVarUInt(const uint8*& Cursor, const uint8* End, uint32& OutValue)
+	{
+		OutValue = 0;
+		for (int32 Shift = 0; Shift < 35; Shift += 7)
+		{
+			if (Cursor >= End) return false;
+			const uint8 Byte = *Cursor++;
+			OutValue |= static_cast<uint32>(Byte & 0x7F) << Shift;
+			if (!(Byte & 0x80)) return true;
+		}
+		return false;
+	}
+
+	// Maps small negative and positive residuals to small unsigned values
+	uint32 ZigZag(int32 Value) { return (static_cast<uint32>(Value) << 1) ^ static_cast<uint32>(Value >> 31); }
+	int32 UnZigZag(uint32 Value) { return static_cast<int32>(Value >> 1) ^ -static_cast<int32>(Value & 1); }
+
+	void WriteBytes(TArray<uint8>& Out, const void* Data, int32 Size)
+	{
+		Out.Append(static_cast<const uint8*>(Data), Size);
+	}
+
+	bool ReadBytes(const uint8*& Cursor, const uint8* End, void* Data, int32 Size)
+	{
+		if (End - Cursor < Size) return false;
+		FMemory::Memcpy(Data, Cursor, Size);
+		Cursor += Size;
+		return true;
+	}
+
+	// --- Quantization ---
+	bool IsPositionField(int32 Field) { return Field < 3; }
+	bool IsRotationField(int32 Field) { return Field >= 6 && Field < 9; }
+
+	void Quantize(const FFlightRecordSample& Sample, int32 (&Out)[NumFields])
+	{
+		Out[0] = FMath::RoundToInt(Sample.Location.X / PositionStep);
+		Out[1] = FMath::RoundToInt(Sample.Location.Y / PositionStep);
+		Out[2] = FMath::RoundToInt(Sample.Location.Z / PositionStep);
+		Out[3] = FMath::RoundToInt(Sample.Velocity.X / VelocityStep);
+		Out[4] = FMath::RoundToInt(Sample.Velocity.Y / VelocityStep);
+		Out[5] = FMath::RoundToInt(Sample.Velocity.Z / VelocityStep);
+		Out[6] = FRotator3f::CompressAxisToShort(Sample.Rotation.Pitch);
+		Out[7] = FRotator3f::CompressAxisToShort(Sample.Rotation.Yaw);
+		Out[8] = FRotator3f::CompressAxisToShort(Sample.Rotation.Roll);
+		Out[9] = FMath::RoundToInt(FMath::Clamp(Sample.Throttle, 0.0f, 1.0f) * 255.0f);
+		Out[10] = FMath::RoundToInt(Sample.Health / HealthStep);
+	}
+
+	void Dequantize(const int32 (&In)[NumFields], FFlightRecordSample& Sample)
+	{
+		Sample.Location = FVector3f(static_cast<float>(In[0]), static_cast<float>(In[1]), static_cast<float>(In[2])) * PositionStep;
+		Sample.Velocity = FVector3f(static_cast<float>(In[3]), static_cast<float>(In[4]), static_cast<float>(In[5])) * VelocityStep;
+		Sample.Rotation.Pitch = FRotator3f::DecompressAxisFromShort(static_cast<uint16>(In[6]));
+		Sample.Rotation.Yaw = FRotator3f::DecompressAxisFromShort(static_cast<uint16>(In[7]));
+		Sample.Rotation.Roll = FRotator3f::DecompressAxisFromShort(static_cast<uint16>(In[8]));
+		Sample.Throttle = In[9] / 255.0f;
+		Sample.Health = static_cast<float>(In[10]) * HealthStep;
+	}
+
+	// Encoder and decoder must predict identically
+	int32 Predict(const FEntityHistory* History, int32 Field)
+	{
+		if (!History) return 0;
+		if (IsPositionField(Field) && History->NumFrames >= 2)
+		{
+			return 2 * History->Previous[Field] - History->BeforePrevious[Field];
+		}
+		return History->Previous[Field];
+	}
+
+	void PushHistory(FEntityHistory& History, const int32 (&Values)[NumFields])
+	{
+		FMemory::Memcpy(History.BeforePrevious, History.Previous, sizeof(History.Previous));
+		FMemory::Memcpy(History.Previous, Values, sizeof(History.Previous));
+		++History.NumFrames;
+	}
+}
+
+// --- Encoder ---
+
+void FFlightRecordEncoder::EncodeFrame(const FFlightRecordFrame& Frame, const TMap<uint32, FFlightRecordEntity>& Entities, TArray<uint8>& Out)
+{
+	WriteVarUInt(Out, Frame.FrameNumber);
+	WriteBytes(Out, &Frame.Time, sizeof(Frame.Time));
+
+	// Entities new to this block are described before their first sample
+	Declarations.Reset();
+	for (const FFlightRecordSample& Sample : Frame.Samples)
+	{
+		if (!History.Contains(Sample.EntityId))
+		{
+			Declarations.Add(Sample.EntityId);
+		}
+	}
+
+	WriteVarUInt(Out, Declarations.Num());
+	for (uint32 EntityId : Declarations)
+	{
+		const FFlightRecordEntity* Entity = Entities.Find(EntityId);
+		const FTCHARToUTF8 MeshPath(Entity ? *Entity->MeshPath : TEXT(""));
+
+		WriteVarUInt(Out, EntityId);
+		Out.Add(static_cast<uint8>(Entity ? Entity->Kind : EFlightRecordKind::Aircraft));
+		Out.Add(Entity ? Entity->Team : 0);
+		WriteVarUInt(Out, MeshPath.Length());
+		WriteBytes(Out, MeshPath.Get(), MeshPath.Length());
+	}
+
+	WriteVarUInt(Out, Frame.Samples.Num());
+	uint32 PreviousId = 0;
+	for (const FFlightRecordSample& Sample : Frame.Samples)
+	{
+		WriteVarUInt(Out, Sample.EntityId - PreviousId);
+		PreviousId = Sample.EntityId;
+
+		int32 Values[NumFields];
+		Quantize(Sample, Values);
+
+		FEntityHistory* EntityHistory = History.Find(Sample.EntityId);
+		int32 Residuals[NumFields];
+		uint32 Mask = 0;
+		for (int32 Field = 0; Field < NumFields; ++Field)
+		{
+			int32 Residual = Values[Field] - Predict(EntityHistory, Field);
+			if (IsRotationField(Field))
+			{
+				// Angles wrap at 16 bits, so take the short way round
+				Residual = static_cast<int16>(static_cast<uint16>(Residual));
+			}
+			Residuals[Field] = Residual;
+			Mask |= Residual != 0 ? 1u << Field : 0u;
+		}
+
+		WriteVarUInt(Out, Mask);
+		for (int32 Field = 0; Field < NumFields; ++Field)
+		{
+			if (Mask & (1u << Field))
+			{
+				WriteVarUInt(Out, ZigZag(Residuals[Field]));
+			}
+		}
+
+		PushHistory(EntityHistory ? *EntityHistory : History.Add(Sample.EntityId), Values);
+	}
+}
+
+// --- Decoder ---
+
+bool FFlightRecordDecoder::DecodeFrame(const uint8*& Cursor, const uint8* End, FFlightRecordFrame& OutFrame)
+{
+	OutFrame.Reset();
+
+	uint32 Count;
+	if (!ReadVarUInt(Cursor, End, OutFrame.FrameNumber) || !ReadBytes(Cursor, End, &OutFrame.Time, sizeof(OutFrame.Time))) return false;
+
+	// Every entry takes at least a byte, which bounds the counts of a corrupt frame
+	if (!ReadVarUInt(Cursor, End, Count) || Count > static_cast<uint32>(End - Cursor)) return false;
+	for (uint32 i = 0; i < Count; ++i)
+	{
+		FFlightRecordEntity& Entity = OutFrame.NewEntities.AddDefaulted_GetRef();
+		uint8 KindAndTeam[2];
+		uint32 PathLength;
+		if (!ReadVarUInt(Cursor, End, Entity.EntityId) || !ReadBytes(Cursor, End, KindAndTeam, 2) || !ReadVarUInt(Cursor, End, PathLength)) return false;
+		if (static_cast<uint32>(End - Cursor) < PathLength) return false;
+
+		Entity.Kind = static_cast<EFlightRecordKind>(KindAndTeam[0]);
+		Entity.Team = KindAndTeam[1];
+		Entity.MeshPath = FString(FUTF8ToTCHAR(reinterpret_cast<const ANSICHAR*>(Cursor), PathLength));
+		Cursor += PathLength;
+	}
+
+	if (!ReadVarUInt(Cursor, End, Count) || Count > static_cast<uint32>(End - Cursor)) return false;
+	OutFrame.Samples.SetNum(Count);
+	uint32 EntityId = 0;
+	for (FFlightRecordSample& Sample : OutFrame.Samples)
+	{
+		uint32 IdDelta, Mask;
+		if (!ReadVarUInt(Cursor, End, IdDelta) || !ReadVarUInt(Cursor, End, Mask)) return false;
+		EntityId += IdDelta;
+		Sample.EntityId = EntityId;
+
+		FEntityHistory* EntityHistory = History.Find(EntityId);
+		int32 Values[NumFields];
+		for (int32 Field = 0; Field < NumFields; ++Field)
+		{
+			uint32 Encoded = 0;
+			if ((Mask & (1u << Field)) && !ReadVarUInt(Cursor, End, Encoded)) return false;
+
+			const int32 Value = Predict(EntityHistory, Field) + UnZigZag(Encoded);
+			Values[Field] = IsRotationField(Field) ? static_cast<uint16>(Value) : Value;
+		}
+
+		Dequantize(Values, Sample);
+		PushHistory(EntityHistory ? *EntityHistory : History.Add(EntityId), Values);
+	}
+
+	return true;
+}
+
+// --- Writer ---
+
+FFlightRecordWriter::FFlightRecordWriter(const FString& InFilename, int32 NumFrameSlots, int32 InFramesPerBlock)
+	: Filename(InFilename)
+	, FreeSlots(FMath::Max(NumFrameSlots, 2) + 1)
+	, FilledSlots(FMath::Max(NumFrameSlots, 2) + 1)
+	, FramesPerBlock(FMath::Max(InFramesPerBlock, 1))
+{
+	Slots.SetNum(FMath::Max(NumFrameSlots, 2));
+	for (int32 i = 0; i < Slots.Num(); ++i)
+	{
+		FreeSlots.Enqueue(i);
+	}
+}
+
+FFlightRecordWriter::~FFlightRecordWriter()
+{
+	Finish();
+}
+
+bool FFlightRecordWriter::Start()
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(Filename));
+	File.Reset(PlatformFile.OpenWrite(*Filename));
+	if (!File) return false;
+
+	const FFileHeader Header { Magic, Version };
+	File->Write(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+
+	WorkEvent = FPlatformProcess::GetSynchEventFromPool();
+	Thread = FRunnableThread::Create(this, TEXT("FlightRecordWriter"), 0, TPri_BelowNormal);
+	return Thread != nullptr;
+}
+
+void FFlightRecordWriter::Finish()
+{
+	if (Thread)
+	{
+		bStopping = true;
+		WorkEvent->Trigger();
+		Thread->WaitForCompletion();
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	if (WorkEvent)
+	{
+		FPlatformProcess::ReturnSynchEventToPool(WorkEvent);
+		WorkEvent = nullptr;
+	}
+
+	File.Reset();
+}
+
+FFlightRecordFrame* FFlightRecordWriter::AcquireFrame()
+{
+	int32 Slot;
+	if (!FreeSlots.Dequeue(Slot)) return nullptr;
+
+	FFlightRecordFrame& Frame = Slots[Slot];
+	Frame.Reset();
+	return &Frame;
+}
+
+void FFlightRecordWriter::SubmitFrame(FFlightRecordFrame* Frame)
+{
+	FilledSlots.Enqueue(static_cast<int32>(Frame - Slots.GetData()));
+	WorkEvent->Trigger();
+}
+
+uint32 FFlightRecordWriter::Run()
+{
+	while (true)
+	{
+		int32 Slot;
+		if (FilledSlots.Dequeue(Slot))
+		{
+			WriteFrame(Slots[Slot]);
+			FreeSlots.Enqueue(Slot);
+			continue;
+		}
+
+		// Only stop once the queue has drained
+		if (bStopping) break;
+
+		WorkEvent->Wait(10);
+	}
+
+	FlushBlock();
+	if (File)
+	{
+		File->Flush();
+	}
+	return 0;
+}
+
+void FFlightRecordWriter::Stop()
+{
+	bStopping = true;
+	if (WorkEvent)
+	{
+		WorkEvent->Trigger();
+	}
+}
+
+void FFlightRecordWriter::WriteFrame(FFlightRecordFrame& Frame)
+{
+	for (FFlightRecordEntity& Entity : Frame.NewEntities)
+	{
+		Entities.Add(Entity.EntityId, MoveTemp(Entity));
+	}
+
+	// Captured in registry order; sorted ids keep the id deltas at one byte
+	Frame.Samples.Sort([](const FFlightRecordSample& A, const FFlightRecordSample& B) { return A.EntityId < B.EntityId; });
+
+	if (FramesInBlock == 0)
+	{
+		Encoder.BeginBlock();
+		BlockStartTime = Frame.Time;
+	}
+
+	Encoder.EncodeFrame(Frame, Entities, RawBlock);
+	BlockEndTime = Frame.Time;
+
+	if (++FramesInBlock >= FramesPerBlock)
+	{
+		FlushBlock();
+	}
+}
+
+void FFlightRecordWriter::FlushBlock()
+{
+	if (FramesInBlock == 0 || !File) return;
+
+	FBlockHeader Header;
+	Header.RawSize = RawBlock.Num();
+	Header.NumFrames = FramesInBlock;
+	Header.StartTime = BlockStartTime;
+	Header.EndTime = BlockEndTime;
+
+	int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, RawBlock.Num());
+	CompressedBlock.SetNumUninitialized(CompressedSize, EAllowShrinking::No);
+
+	const uint8* Payload = RawBlock.GetData();
+	Header.CompressedSize = RawBlock.Num();
+	if (FCompression::CompressMemory(NAME_Zlib, CompressedBlock.GetData(), CompressedSize, RawBlock.GetData(), RawBlock.Num())
+		&& CompressedSize < RawBlock.Num())
+	{
+		Payload = CompressedBlock.GetData();
+		Header.CompressedSize = CompressedSize;
+	}
+
+	File->Write(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+	File->Write(Payload, Header.CompressedSize);
+
+	RawBlock.Reset();
+	FramesInBlock = 0;
+}
+
+// --- Reader ---
+
+FFlightReplayReader::FFlightReplayReader() = default;
+
+FFlightReplayReader::~FFlightReplayReader()
+{
+	Close();
+}
+
+bool FFlightReplayReader::Open(const FString& Filename)
+{
+	Close();
+
+	MappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+	if (!MappedFile || MappedFile->GetFileSize() < static_cast<int64>(sizeof(FFileHeader)))
+	{
+		Close();
+		return false;
+	}
+
+	MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+	if (!MappedRegion)
+	{
+		Close();
+		return false;
+	}
+
+	const uint8* Data = MappedRegion->GetMappedPtr();
+	const int64 Size = MappedRegion->GetMappedSize();
+
+	FFileHeader FileHeader;
+	FMemory::Memcpy(&FileHeader, Data, sizeof(FileHeader));
+	if (FileHeader.Magic != Magic || FileHeader.Version != Version)
+	{
+		Close();
+		return false;
+	}
+
+	// Index the blocks. A block cut short by a crash ends the file.
+	int64 Offset = sizeof(FFileHeader);
+	while (Offset + static_cast<int64>(sizeof(FBlockHeader)) <= Size)
+	{
+		FBlockInfo& Block = Blocks.AddDefaulted_GetRef();
+		FMemory::Memcpy(&Block.Header, Data + Offset, sizeof(FBlockHeader));
+		Block.PayloadOffset = Offset + sizeof(FBlockHeader);
+
+		if (Block.PayloadOffset + Block.Header.CompressedSize > Size)
+		{
+			Blocks.Pop();
+			break;
+		}
+		Offset = Block.PayloadOffset + Block.Header.CompressedSize;
+	}
+
+	return true;
+}
+
+void FFlightReplayReader::Close()
+{
+	MappedRegion.Reset();
+	MappedFile.Reset();
+	Blocks.Reset();
+	Entities.Reset();
+	CurrentBlock = INDEX_NONE;
+	FramesLeftInBlock = 0;
+	Cursor = BlockEnd = nullptr;
+}
+
+bool FFlightReplayReader::LoadBlock(int32 BlockIndex)
+{
+	CurrentBlock = BlockIndex;
+	FramesLeftInBlock = 0;
+	if (!Blocks.IsValidIndex(BlockIndex)) return false;
+
+	const FBlockInfo& Block = Blocks[BlockIndex];
+	const uint8* Payload = MappedRegion->GetMappedPtr() + Block.PayloadOffset;
+
+	if (Block.Header.CompressedSize == Block.Header.RawSize)
+	{
+		Cursor = Payload;
+	}
+	else
+	{
+		InflatedBlock.SetNumUninitialized(Block.Header.RawSize, EAllowShrinking::No);
+		if (!FCompression::UncompressMemory(NAME_Zlib, InflatedBlock.GetData(), Block.Header.RawSize, Payload, Block.Header.CompressedSize))
+		{
+			return false;
+		}
+		Cursor = InflatedBlock.GetData();
+	}
+
+	BlockEnd = Cursor + Block.Header.RawSize;
+	FramesLeftInBlock = Block.Header.NumFrames;
+	Decoder.BeginBlock();
+	return true;
+}
+
+bool FFlightReplayReader::ReadFrame(FFlightRecordFrame& OutFrame)
+{
+	if (!IsOpen()) return false;
+
+	while (FramesLeftInBlock == 0)
+	{
+		if (CurrentBlock + 1 >= Blocks.Num()) return false;
+		LoadBlock(CurrentBlock + 1);
+	}
+
+	if (!Decoder.DecodeFrame(Cursor, BlockEnd, OutFrame))
+	{
+		// Skip the rest of a corrupt block
+		FramesLeftInBlock = 0;
+		return ReadFrame(OutFrame);
+	}
+	--FramesLeftInBlock;
+
+	for (const FFlightRecordEntity& Entity : OutFrame.NewEntities)
+	{
+		Entities.Add(Entity.EntityId, Entity);
+	}
+	return true;
+}
+
+void FFlightReplayReader::Seek(float Time)
+{
+	int32 Block = 0;
+	while (Block + 1 < Blocks.Num() && Blocks[Block + 1].Header.StartTime <= Time)
+	{
+		++Block;
+	}
+
+	// ReadFrame loads the block after CurrentBlock
+	CurrentBlock = Block - 1;
+	FramesLeftInBlock = 0;
+}
+
+float FFlightReplayReader::GetDuration() const
+{
+	return Blocks.Num() > 0 ? Blocks.Last().Header.EndTime : 0.0f;
+}
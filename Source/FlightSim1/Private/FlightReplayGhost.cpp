@@ -0,0 +1,27 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#include "FlightReplayGhost.h"
+#include "Components/StaticMeshComponent.h"
+
+AFlightReplayGhost::AFlightReplayGhost()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	GhostMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("GhostMesh"));
+	RootComponent = GhostMesh;
+	GhostMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	GhostMesh->SetGenerateOverlapEvents(false);
+	GhostMesh->SetMobility(EComponentMobility::Movable);
+
+	Team = 0;
+	bIsMissile = false;
+	ReplayVelocity = FVector::ZeroVector;
+	Throttle = 0.0f;
+	Health = 0.0f;
+	LastSeenFrame = 0;
+}
+
+void AFlightReplayGhost::SetGhostMesh(UStaticMesh* Mesh)
+{
+	GhostMesh->SetStaticMesh(Mesh);
+}
@@ -0,0 +1,190 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#include "FlightSimBenchmarkSubsystem.h"
+#include "FlightSim1.h"
+#include "DogfightGameModeBase.h"
+#include "FighterJetPawn.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/PlatformMisc.h"
+
+namespace
+{
+	// Nearest-rank percentile of an already sorted array
+	float Percentile(const TArray<float>& Sorted, float Fraction)
+	{
+		if (Sorted.Num() == 0) return 0.0f;
+		const int32 Rank = FMath::Clamp(FMath::CeilToInt(Fraction * Sorted.Num()) - 1, 0, Sorted.Num() - 1);
+		return Sorted[Rank];
+	}
+
+	FString PercentilesToJson(TArray<float> Samples)
+	{
+		Samples.Sort();
+		double Sum = 0.0;
+		for (float Sample : Samples)
+		{
+			Sum += Sample;
+		}
+		const double Mean = Samples.Num() > 0 ? Sum / Samples.Num() : 0.0;
+
+		return FString::Printf(TEXT("{ \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"mean\": %.4f, \"max\": %.4f }"),
+			Percentile(Samples, 0.50f), Percentile(Samples, 0.95f), Percentile(Samples, 0.99f), Mean, Samples.Num() > 0 ? Samples.Last() : 0.0f);
+	}
+}
+
+bool UFlightSimBenchmarkSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return FParse::Param(FCommandLine::Get(), TEXT("FlightSimBenchmark")) && Super::ShouldCreateSubsystem(Outer);
+}
+
+bool UFlightSimBenchmarkSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UFlightSimBenchmarkSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFlightSimBenchmarkSubsystem, STATGROUP_Tickables);
+}
+
+void UFlightSimBenchmarkSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const TCHAR* CommandLine = FCommandLine::Get();
+	FParse::Value(CommandLine, TEXT("BenchmarkEnemies="), EnemyCount);
+	FParse::Value(CommandLine, TEXT("BenchmarkAllies="), AllyCount);
+	FParse::Value(CommandLine, TEXT("BenchmarkDrones="), DroneCount);
+	FParse::Value(CommandLine, TEXT("BenchmarkWarmup="), WarmupFrames);
+	FParse::Value(CommandLine, TEXT("BenchmarkFrames="), MeasuredFrames);
+	WarmupFrames = FMath::Max(WarmupFrames, 0);
+	MeasuredFrames = FMath::Max(MeasuredFrames, 1);
+
+	if (!FParse::Value(CommandLine, TEXT("BenchmarkOutput="), OutputPath))
+	{
+		OutputPath = FPaths::ProjectSavedDir() / TEXT("Benchmark") / TEXT("FlightSimBenchmark.json");
+	}
+	OutputPath = FPaths::ConvertRelativePathToFull(OutputPath);
+
+	GameThreadSamples.Reserve(MeasuredFrames);
+	for (TArray<float>& Samples : TimerSamples)
+	{
+		Samples.Reserve(MeasuredFrames);
+	}
+
+	FFlightSimFrameTimers::bEnabled = true;
+	FFlightSimFrameTimers::Reset();
+}
+
+void UFlightSimBenchmarkSubsystem::Deinitialize()
+{
+	FFlightSimFrameTimers::bEnabled = false;
+	Super::Deinitialize();
+}
+
+void UFlightSimBenchmarkSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Runs before the game mode's BeginPlay spawns the AI
+	if (ADogfightGameModeBase* GameMode = InWorld.GetAuthGameMode<ADogfightGameModeBase>())
+	{
+		if (EnemyCount >= 0)
+		{
+			GameMode->NumberOfEnemiesToSpawn = EnemyCount;
+		}
+		if (AllyCount >= 0)
+		{
+			GameMode->NumberOfAlliesToSpawn = AllyCount;
+		}
+		if (DroneCount >= 0)
+		{
+			GameMode->NumberOfDronesToSpawn = DroneCount;
+		}
+	}
+
+	UE_LOG(LogFlightSim, Display, TEXT("Benchmark: %d warmup + %d measured frames, results to %s"), WarmupFrames, MeasuredFrames, *OutputPath);
+}
+
+void UFlightSimBenchmarkSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (bFinished) return;
+
+	ElapsedTime += DeltaTime;
+	FlyPlayer(DeltaTime);
+
+	// Timers accumulated since the previous tick cover one full frame
+	if (FrameCounter >= WarmupFrames)
+	{
+		RecordFrame();
+	}
+	FFlightSimFrameTimers::Reset();
+
+	if (++FrameCounter >= WarmupFrames + MeasuredFrames)
+	{
+		bFinished = true;
+		WriteResults();
+		FPlatformMisc::RequestExit(false, TEXT("FlightSimBenchmark"));
+	}
+}
+
+void UFlightSimBenchmarkSubsystem::FlyPlayer(float DeltaTime)
+{
+	AFighterJetPawn* Player = Cast<AFighterJetPawn>(UGameplayStatics::GetPlayerPawn(this, 0));
+	if (!Player) return;
+
+	// Full throttle, a slow rolling weave and bursts of gunfire so every player system gets exercised
+	const float Pitch = 0.3f + 0.2f * FMath::Sin(ElapsedTime * 0.7f);
+	const float Roll = 0.5f * FMath::Sin(ElapsedTime * 0.4f);
+	const bool bFireGun = FMath::Fmod(ElapsedTime, 4.0f) < 1.5f;
+	const bool bLaunchMissile = Player->LockedTarget != nullptr && FMath::Fmod(ElapsedTime, 10.0f) < DeltaTime;
+
+	Player->SetAutopilotInput(1.0f, Pitch, Roll, 0.0f, bFireGun, bLaunchMissile);
+}
+
+void UFlightSimBenchmarkSubsystem::RecordFrame()
+{
+	GameThreadSamples.Add(FPlatformTime::ToMilliseconds(GGameThreadTime));
+
+	for (int32 Timer = 0; Timer < static_cast<int32>(EFlightSimTimer::Num); ++Timer)
+	{
+		TimerSamples[Timer].Add(static_cast<float>(FFlightSimFrameTimers::GetMilliseconds(static_cast<EFlightSimTimer>(Timer))));
+	}
+}
+
+void UFlightSimBenchmarkSubsystem::WriteResults() const
+{
+	const ADogfightGameModeBase* GameMode = GetWorld()->GetAuthGameMode<ADogfightGameModeBase>();
+
+	FString Json = TEXT("{\n");
+	Json += FString::Printf(TEXT("\t\"map\": \"%s\",\n"), *GetWorld()->GetMapName());
+	Json += FString::Printf(TEXT("\t\"build\": \"%s\",\n"), LexToString(FApp::GetBuildConfiguration()));
+	Json += FString::Printf(TEXT("\t\"enemies\": %d,\n"), GameMode ? GameMode->NumberOfEnemiesToSpawn : 0);
+	Json += FString::Printf(TEXT("\t\"allies\": %d,\n"), GameMode ? GameMode->NumberOfAlliesToSpawn : 0);
+	Json += FString::Printf(TEXT("\t\"drones\": %d,\n"), GameMode ? GameMode->NumberOfDronesToSpawn : 0);
+	Json += FString::Printf(TEXT("\t\"warmup_frames\": %d,\n"), WarmupFrames);
+	Json += FString::Printf(TEXT("\t\"frames\": %d,\n"), GameThreadSamples.Num());
+	Json += FString::Printf(TEXT("\t\"game_thread_ms\": %s,\n"), *PercentilesToJson(GameThreadSamples));
+	Json += TEXT("\t\"systems_ms\": {\n");
+	for (int32 Timer = 0; Timer < static_cast<int32>(EFlightSimTimer::Num); ++Timer)
+	{
+		Json += FString::Printf(TEXT("\t\t\"%s\": %s%s\n"), FFlightSimFrameTimers::GetName(static_cast<EFlightSimTimer>(Timer)),
+			*PercentilesToJson(TimerSamples[Timer]), Timer + 1 < static_cast<int32>(EFlightSimTimer::Num) ? TEXT(",") : TEXT(""));
+	}
+	Json += TEXT("\t}\n}\n");
+
+	if (FFileHelper::SaveStringToFile(Json, *OutputPath))
+	{
+		UE_LOG(LogFlightSim, Display, TEXT("Benchmark results written to %s\n%s"), *OutputPath, *Json);
+	}
+	else
+	{
+		UE_LOG(LogFlightSim, Error, TEXT("Benchmark could not write %s\n%s"), *OutputPath, *Json);
+	}
+}
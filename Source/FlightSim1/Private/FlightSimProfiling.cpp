@@ -0,0 +1,105 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#include "FlightSimProfiling.h"
+
+DEFINE_STAT(STAT_FlightSim_ApplyAerodynamics);
+DEFINE_STAT(STAT_FlightSim_BasicAerodynamics);
+DEFINE_STAT(STAT_FlightSim_CheckIfOnGround);
+DEFINE_STAT(STAT_FlightSim_UpdateHUD);
+DEFINE_STAT(STAT_FlightSim_UpdateContactMarkers);
+DEFINE_STAT(STAT_FlightSim_UpdateLockedTarget);
+DEFINE_STAT(STAT_FlightSim_FireWeapon);
+DEFINE_STAT(STAT_FlightSim_FireMissile);
+DEFINE_STAT(STAT_FlightSim_AITick);
+DEFINE_STAT(STAT_FlightSim_AssignTargets);
+DEFINE_STAT(STAT_FlightSim_AIDecide);
+DEFINE_STAT(STAT_FlightSim_AIApply);
+DEFINE_STAT(STAT_FlightSim_RegistryRebuild);
+DEFINE_STAT(STAT_FlightSim_WeaponFireTick);
+DEFINE_STAT(STAT_FlightSim_StepRounds);
+DEFINE_STAT(STAT_FlightSim_CollideRounds);
+DEFINE_STAT(STAT_FlightSim_MissileGuidanceTick);
+DEFINE_STAT(STAT_FlightSim_MissileLaunch);
+DEFINE_STAT(STAT_FlightSim_ResolveDamage);
+DEFINE_STAT(STAT_FlightSim_SpawnEnemies);
+DEFINE_STAT(STAT_FlightSim_RecordFrame);
+DEFINE_STAT(STAT_FlightSim_ReplayPlayback);
+DEFINE_STAT(STAT_FlightSim_NetServerMove);
+DEFINE_STAT(STAT_FlightSim_NetReconcile);
+DEFINE_STAT(STAT_FlightSim_SensorTick);
+DEFINE_STAT(STAT_FlightSim_DroneSwarmTick);
+DEFINE_STAT(STAT_FlightSim_EffectsTick);
+DEFINE_STAT(STAT_FlightSim_TerrainBake);
+
+DEFINE_STAT(STAT_FlightSim_LiveAircraft);
+DEFINE_STAT(STAT_FlightSim_Drones);
+DEFINE_STAT(STAT_FlightSim_MissilesInFlight);
+DEFINE_STAT(STAT_FlightSim_RoundsInFlight);
+DEFINE_STAT(STAT_FlightSim_TracesPerFrame);
+DEFINE_STAT(STAT_FlightSim_PendingLineOfSightChecks);
+DEFINE_STAT(STAT_FlightSim_ActiveEffects);
+DEFINE_STAT(STAT_FlightSim_EffectsSpawned);
+DEFINE_STAT(STAT_FlightSim_EffectsCulled);
+
+CSV_DEFINE_CATEGORY_MODULE(FLIGHTSIM1_API, FlightSim, true);
+
+bool FFlightSimFrameTimers::bEnabled = false;
+uint64 FFlightSimFrameTimers::Cycles[static_cast<int32>(EFlightSimTimer::Num)] = {};
+EFlightSimTimer* FFlightSimFrameTimers::ActiveTimer = nullptr;
+uint64 FFlightSimFrameTimers::ActiveStart = 0;
+
+void FFlightSimFrameTimers::Reset()
+{
+	FMemory::Memzero(Cycles);
+}
+
+double FFlightSimFrameTimers::GetMilliseconds(EFlightSimTimer Timer)
+{
+	return FPlatformTime::ToMilliseconds64(Cycles[static_cast<int32>(Timer)]);
+}
+
+const TCHAR* FFlightSimFrameTimers::GetName(EFlightSimTimer Timer)
+{
+	switch (Timer)
+	{
+	case EFlightSimTimer::Aerodynamics: return TEXT("aerodynamics");
+	case EFlightSimTimer::AI: return TEXT("ai");
+	case EFlightSimTimer::Weapons: return TEXT("weapons");
+	case EFlightSimTimer::Missiles: return TEXT("missiles");
+	case EFlightSimTimer::HUD: return TEXT("hud");
+	case EFlightSimTimer::Sensors: return TEXT("sensors");
+	default: return TEXT("unknown");
+	}
+}
+
+FFlightSimScopeTimer::FFlightSimScopeTimer(EFlightSimTimer InTimer)
+	: Timer(InTimer)
+	, Enclosing(nullptr)
+	, bActive(FFlightSimFrameTimers::bEnabled)
+{
+	if (!bActive) return;
+
+	const uint64 Now = FPlatformTime::Cycles64();
+
+	// Charge the enclosing scope up to here and pause it
+	Enclosing = FFlightSimFrameTimers::ActiveTimer;
+	if (Enclosing)
+	{
+		FFlightSimFrameTimers::Cycles[static_cast<int32>(*Enclosing)] += Now - FFlightSimFrameTimers::ActiveStart;
+	}
+
+	FFlightSimFrameTimers::ActiveTimer = &Timer;
+	FFlightSimFrameTimers::ActiveStart = Now;
+}
+
+FFlightSimScopeTimer::~FFlightSimScopeTimer()
+{
+	if (!bActive) return;
+
+	const uint64 Now = FPlatformTime::Cycles64();
+	FFlightSimFrameTimers::Cycles[static_cast<int32>(Timer)] += Now - FFlightSimFrameTimers::ActiveStart;
+
+	// Resume the enclosing scope
+	FFlightSimFrameTimers::ActiveTimer = Enclosing;
+	FFlightSimFrameTimers::ActiveStart = Now;
+}
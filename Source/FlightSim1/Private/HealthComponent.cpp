@@ -4,33 +4,100 @@
 #include "Kismet/GameplayStatics.h"
 #include "Particles/ParticleSystem.h"
 #include "DogfightGameModeBase.h"
+#include "Net/UnrealNetwork.h"
 
 UHealthComponent::UHealthComponent()
 {
 	PrimaryComponentTick.bCanEverTick = false;
+	SetIsReplicatedByDefault(true);
 	MaxHealth = 100.0f;
 }
 
 void UHealthComponent::BeginPlay()
 {
 	Super::BeginPlay();
-	CurrentHealth = MaxHealth;
+
+	// Clients may already have the server's value
+	if (GetOwner()->HasAuthority())
+	{
+		CurrentHealth = MaxHealth;
+	}
+
+	if (UDamageSubsystem* DamageSubsystem = GetWorld()->GetSubsystem<UDamageSubsystem>())
+	{
+		HealthHandle = DamageSubsystem->RegisterHealth(this);
+	}
 }
 
-void UHealthComponent::TakeDamage(float Damage)
+void UHealthComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	if (IsDead()) return;
+	if (UDamageSubsystem* DamageSubsystem = GetWorld()->GetSubsystem<UDamageSubsystem>())
+	{
+		DamageSubsystem->UnregisterHealth(HealthHandle);
+	}
+	HealthHandle = FHealthHandle();
 
-	CurrentHealth = FMath::Clamp(CurrentHealth - Damage, 0.0f, MaxHealth);
+	Super::EndPlay(EndPlayReason);
+}
 
+void UHealthComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(UHealthComponent, CurrentHealth);
+}
+
+void UHealthComponent::OnRep_CurrentHealth(float OldHealth)
+{
 	OnHealthChanged.Broadcast(GetOwner(), CurrentHealth);
 
+	// The server destroys the owner right after, so only the event is needed here
+	if (OldHealth > 0.0f && IsDead())
+	{
+		OnDeath.Broadcast();
+	}
+}
+
+void UHealthComponent::TakeDamage(float Damage)
+{
+	if (IsDead() || !GetOwner()->HasAuthority()) return;
+
+	UDamageSubsystem* DamageSubsystem = GetWorld()->GetSubsystem<UDamageSubsystem>();
+	if (DamageSubsystem && HealthHandle.IsValid())
+	{
+		DamageSubsystem->QueueDamage(HealthHandle, Damage, nullptr, EFlightDamageType::Generic);
+		return;
+	}
+
+	// Not registered (e.g. an editor preview world), apply straight away
+	ApplyResolvedDamage(Damage);
 	if (IsDead())
 	{
+		if (ADogfightGameModeBase* DogfightGameMode = Cast<ADogfightGameModeBase>(UGameplayStatics::GetGameMode(GetWorld())))
+		{
+			DogfightGameMode->AircraftDied(Cast<APawn>(GetOwner()));
+		}
 		Die();
 	}
 }
 
+void UHealthComponent::SetCurrentHealth(float NewHealth)
+{
+	if (IsDead() || !GetOwner()->HasAuthority()) return;
+
+	// Handing over a live aircraft, so never kill it here
+	CurrentHealth = FMath::Clamp(NewHealth, KINDA_SMALL_NUMBER, MaxHealth);
+}
+
+void UHealthComponent::ApplyResolvedDamage(float TotalDamage)
+{
+	if (IsDead()) return;
+
+	CurrentHealth = FMath::Clamp(CurrentHealth - TotalDamage, 0.0f, MaxHealth);
+
+	OnHealthChanged.Broadcast(GetOwner(), CurrentHealth);
+}
+
 bool UHealthComponent::IsDead() const
 {
 	return CurrentHealth <= 0.0f;
@@ -38,21 +105,7 @@ bool UHealthComponent::IsDead() const
 
 void UHealthComponent::Die()
 {
-	// Notify the Game Mode
-	AGameModeBase* GameMode = UGameplayStatics::GetGameMode(GetWorld());
-	if (ADogfightGameModeBase* DogfightGameMode = Cast<ADogfightGameModeBase>(GameMode))
-	{
-		APawn* OwnerPawn = Cast<APawn>(GetOwner());
-		if (OwnerPawn && OwnerPawn->IsPlayerControlled())
-		{
-			DogfightGameMode->PlayerDied();
-		}
-		else
-		{
-			DogfightGameMode->EnemyDied();
-		}
-	}
-
+	// The game mode has already been told by whoever resolved the killing blow
 	OnDeath.Broadcast();
 
 	AActor* Owner = GetOwner();
@@ -4,15 +4,21 @@
 #include "Components/StaticMeshComponent.h"
 #include "Particles/ParticleSystemComponent.h"
 #include "GameFramework/ProjectileMovementComponent.h"
-#include "Kismet/GameplayStatics.h"
-#include "HealthComponent.h"
+#include "DamageSubsystem.h"
 #include "Particles/ParticleSystem.h"
+#include "MissilePoolSubsystem.h"
+#include "MissileGuidanceSubsystem.h"
+#include "FlightEffectsSubsystem.h"
+#include "Net/UnrealNetwork.h"
 
 // Sets default values
 AMissile::AMissile()
 {
-	// Set this actor to call Tick() every frame.
-	PrimaryActorTick.bCanEverTick = true;
+	// Guidance runs in UMissileGuidanceSubsystem
+	PrimaryActorTick.bCanEverTick = false;
+
+	bReplicates = true;
+	SetReplicatingMovement(true);
 
 	MissileMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("MissileMesh"));
 	RootComponent = MissileMesh;
@@ -25,11 +31,21 @@ AMissile::AMissile()
 	ProjectileMovement->InitialSpeed = 8000.0f;
 	ProjectileMovement->MaxSpeed = 20000.0f;
 	ProjectileMovement->bRotationFollowsVelocity = true;
-	ProjectileMovement->bIsHomingProjectile = true;
-	ProjectileMovement->HomingAccelerationMagnitude = 15000.0f;
+	// Velocity is commanded by the guidance system, the component only integrates and sweeps
+	ProjectileMovement->bIsHomingProjectile = false;
+	ProjectileMovement->ProjectileGravityScale = 0.0f;
 
 	Damage = 100.0f;
+	MaxFlightTime = 20.0f;
 	TargetActor = nullptr;
+	bInFlight = true;
+	GuidanceIndex = INDEX_NONE;
+
+	NavigationConstant = 4.0f;
+	MaxLateralAcceleration = 30000.0f;
+	MotorBurnTime = 3.0f;
+	MotorAcceleration = 15000.0f;
+	AirDragCoefficient = 0.00002f;
 }
 
 // Called when the game starts or when spawned
@@ -37,41 +53,136 @@ void AMissile::BeginPlay()
 {
 	Super::BeginPlay();
 	MissileMesh->OnComponentHit.AddDynamic(this, &AMissile::OnMissileHit);
+
+	// Clients only draw the missile where the server says it is
+	if (!HasAuthority())
+	{
+		ProjectileMovement->Deactivate();
+		SetActorEnableCollision(false);
+	}
+}
+
+void AMissile::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AMissile, bInFlight);
+}
+
+void AMissile::OnRep_InFlight()
+{
+	if (bInFlight)
+	{
+		TrailEffect->ResetParticles();
+		TrailEffect->Activate(true);
+	}
+	else
+	{
+		TrailEffect->DeactivateImmediate();
+	}
+}
+
+void AMissile::MulticastExplode_Implementation(FVector_NetQuantize Location)
+{
+	if (GetNetMode() == NM_DedicatedServer) return;
+
+	if (UFlightEffectsSubsystem* Effects = GetWorld()->GetSubsystem<UFlightEffectsSubsystem>())
+	{
+		Effects->SpawnEffect(EFlightEffectCategory::Explosion, ExplosionEffect, Location, GetActorRotation());
+	}
+}
+
+void AMissile::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UMissileGuidanceSubsystem* Guidance = GetWorld()->GetSubsystem<UMissileGuidanceSubsystem>())
+	{
+		Guidance->UnregisterMissile(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AMissile::OnMissileHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
 {
+	if (!HasAuthority()) return;
+
 	if (OtherActor && OtherActor != this)
 	{
-		UHealthComponent* HealthComponent = OtherActor->FindComponentByClass<UHealthComponent>();
-		if (HealthComponent)
+		if (UDamageSubsystem* DamageSubsystem = GetWorld()->GetSubsystem<UDamageSubsystem>())
 		{
-			HealthComponent->TakeDamage(Damage);
+			DamageSubsystem->QueueDamage(OtherActor, Damage, GetInstigator(), EFlightDamageType::Missile);
 		}
 	}
 
-	if (ExplosionEffect)
+	MulticastExplode(GetActorLocation());
+
+	if (UMissilePoolSubsystem* MissilePool = GetWorld()->GetSubsystem<UMissilePoolSubsystem>())
+	{
+		MissilePool->Release(this);
+	}
+	else
 	{
-		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ExplosionEffect, GetActorLocation(), GetActorRotation());
+		Destroy();
 	}
+}
 
-	Destroy();
+void AMissile::SetTarget(AActor* NewTarget)
+{
+	TargetActor = NewTarget;
 }
 
+FMissileGuidanceBatch::FMissileParams AMissile::GetGuidanceParams() const
+{
+	FMissileGuidanceBatch::FMissileParams Params;
+	Params.NavigationConstant = NavigationConstant;
+	Params.MaxLateralAcceleration = MaxLateralAcceleration;
+	Params.MotorBurnTime = MotorBurnTime;
+	Params.MotorAcceleration = MotorAcceleration;
+	Params.DragCoefficient = AirDragCoefficient;
+	Params.MaxSpeed = ProjectileMovement->MaxSpeed;
+	return Params;
+}
 
-// Called every frame
-void AMissile::Tick(float DeltaTime)
+void AMissile::LaunchFromPool(const FVector& Location, const FRotator& Rotation, AActor* NewTarget)
 {
-	Super::Tick(DeltaTime);
+	bInFlight = true;
+	SetTarget(NewTarget);
 
-	if (TargetActor && ProjectileMovement)
+	SetActorLocationAndRotation(Location, Rotation, false, nullptr, ETeleportType::ResetPhysics);
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+
+	// The projectile component detaches from its updated component when it stops on a hit
+	ProjectileMovement->SetUpdatedComponent(MissileMesh);
+	ProjectileMovement->Velocity = Rotation.Vector() * ProjectileMovement->InitialSpeed;
+	ProjectileMovement->Activate(true);
+	ProjectileMovement->UpdateComponentVelocity();
+
+	TrailEffect->ResetParticles();
+	TrailEffect->Activate(true);
+
+	if (UMissileGuidanceSubsystem* Guidance = GetWorld()->GetSubsystem<UMissileGuidanceSubsystem>())
 	{
-		ProjectileMovement->HomingTargetComponent = TargetActor->GetRootComponent();
+		Guidance->RegisterMissile(this, TargetActor);
 	}
 }
 
-void AMissile::SetTarget(AActor* NewTarget)
+void AMissile::DeactivateForPool()
 {
-	TargetActor = NewTarget;
+	bInFlight = false;
+	TargetActor = nullptr;
+
+	if (UMissileGuidanceSubsystem* Guidance = GetWorld()->GetSubsystem<UMissileGuidanceSubsystem>())
+	{
+		Guidance->UnregisterMissile(this);
+	}
+
+	ProjectileMovement->StopMovementImmediately();
+	ProjectileMovement->Deactivate();
+
+	TrailEffect->DeactivateImmediate();
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
 }
 
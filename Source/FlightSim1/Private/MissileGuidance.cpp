@@ -0,0 +1,135 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#include "MissileGuidance.h"
+
+int32 FMissileGuidanceBatch::Add(const FVector& Position, const FVector& Velocity, const FMissileParams& Params)
+{
+	const int32 Index = PosX.Add(0.0f);
+	PosY.Add(0.0f); PosZ.Add(0.0f);
+	VelX.Add(0.0f); VelY.Add(0.0f); VelZ.Add(0.0f);
+	TargetPosX.Add(0.0f); TargetPosY.Add(0.0f); TargetPosZ.Add(0.0f);
+	TargetVelX.Add(0.0f); TargetVelY.Add(0.0f); TargetVelZ.Add(0.0f);
+	HasTarget.Add(0.0f);
+	FlightTime.Add(0.0f);
+
+	NavigationConstant.Add(Params.NavigationConstant);
+	MaxLateralAcceleration.Add(Params.MaxLateralAcceleration);
+	MotorBurnTime.Add(Params.MotorBurnTime);
+	MotorAcceleration.Add(Params.MotorAcceleration);
+	DragCoefficient.Add(Params.DragCoefficient);
+	MaxSpeed.Add(Params.MaxSpeed);
+
+	SetState(Index, Position, Velocity);
+	return Index;
+}
+
+void FMissileGuidanceBatch::RemoveAtSwap(int32 Index)
+{
+	for (TArray<float>* Column : { &PosX, &PosY, &PosZ, &VelX, &VelY, &VelZ,
+		&TargetPosX, &TargetPosY, &TargetPosZ, &TargetVelX, &TargetVelY, &TargetVelZ,
+		&HasTarget, &FlightTime, &NavigationConstant, &MaxLateralAcceleration,
+		&MotorBurnTime, &MotorAcceleration, &DragCoefficient, &MaxSpeed })
+	{
+		Column->RemoveAtSwap(Index, EAllowShrinking::No);
+	}
+}
+
+void FMissileGuidanceBatch::SetState(int32 Index, const FVector& Position, const FVector& Velocity)
+{
+	PosX[Index] = Position.X; PosY[Index] = Position.Y; PosZ[Index] = Position.Z;
+	VelX[Index] = Velocity.X; VelY[Index] = Velocity.Y; VelZ[Index] = Velocity.Z;
+}
+
+void FMissileGuidanceBatch::SetTarget(int32 Index, const FVector& Position, const FVector& Velocity)
+{
+	TargetPosX[Index] = Position.X; TargetPosY[Index] = Position.Y; TargetPosZ[Index] = Position.Z;
+	TargetVelX[Index] = Velocity.X; TargetVelY[Index] = Velocity.Y; TargetVelZ[Index] = Velocity.Z;
+	HasTarget[Index] = 1.0f;
+}
+
+void FMissileGuidanceBatch::ClearTarget(int32 Index)
+{
+	HasTarget[Index] = 0.0f;
+}
+
+void MissileGuidance::Step(FMissileGuidanceBatch& Batch, float DeltaTime)
+{
+	const int32 Count = Batch.Num();
+
+	float* RESTRICT PX = Batch.PosX.GetData();
+	float* RESTRICT PY = Batch.PosY.GetData();
+	float* RESTRICT PZ = Batch.PosZ.GetData();
+	float* RESTRICT VX = Batch.VelX.GetData();
+	float* RESTRICT VY = Batch.VelY.GetData();
+	float* RESTRICT VZ = Batch.VelZ.GetData();
+	float* RESTRICT Time = Batch.FlightTime.GetData();
+	const float* RESTRICT TPX = Batch.TargetPosX.GetData();
+	const float* RESTRICT TPY = Batch.TargetPosY.GetData();
+	const float* RESTRICT TPZ = Batch.TargetPosZ.GetData();
+	const float* RESTRICT TVX = Batch.TargetVelX.GetData();
+	const float* RESTRICT TVY = Batch.TargetVelY.GetData();
+	const float* RESTRICT TVZ = Batch.TargetVelZ.GetData();
+	const float* RESTRICT Guided = Batch.HasTarget.GetData();
+	const float* RESTRICT Gain = Batch.NavigationConstant.GetData();
+	const float* RESTRICT MaxAccel = Batch.MaxLateralAcceleration.GetData();
+	const float* RESTRICT BurnTime = Batch.MotorBurnTime.GetData();
+	const float* RESTRICT MotorAccel = Batch.MotorAcceleration.GetData();
+	const float* RESTRICT Drag = Batch.DragCoefficient.GetData();
+	const float* RESTRICT SpeedCap = Batch.MaxSpeed.GetData();
+
+	// Every branch is written as a select or a multiply by a 0/1 mask so this loop stays vectorizable
+	for (int32 i = 0; i < Count; ++i)
+	{
+		// Relative geometry
+		const float RX = TPX[i] - PX[i];
+		const float RY = TPY[i] - PY[i];
+		const float RZ = TPZ[i] - PZ[i];
+		const float RVX = TVX[i] - VX[i];
+		const float RVY = TVY[i] - VY[i];
+		const float RVZ = TVZ[i] - VZ[i];
+		const float InvRangeSquared = 1.0f / (RX * RX + RY * RY + RZ * RZ + 1.0f);
+
+		// Line-of-sight rotation rate: (R x Vr) / |R|^2
+		const float OmegaX = (RY * RVZ - RZ * RVY) * InvRangeSquared;
+		const float OmegaY = (RZ * RVX - RX * RVZ) * InvRangeSquared;
+		const float OmegaZ = (RX * RVY - RY * RVX) * InvRangeSquared;
+
+		// Pure PN: turn the velocity vector N times as fast as the line of sight rotates
+		float AX = Gain[i] * (OmegaY * VZ[i] - OmegaZ * VY[i]);
+		float AY = Gain[i] * (OmegaZ * VX[i] - OmegaX * VZ[i]);
+		float AZ = Gain[i] * (OmegaX * VY[i] - OmegaY * VX[i]);
+
+		const float CommandMagnitude = FMath::Sqrt(AX * AX + AY * AY + AZ * AZ);
+		const float Limit = Guided[i] * FMath::Min(1.0f, MaxAccel[i] / (CommandMagnitude + 1.0f));
+		AX *= Limit;
+		AY *= Limit;
+		AZ *= Limit;
+
+		// Burn/coast along the flight path, minus quadratic drag
+		const float Speed = FMath::Sqrt(VX[i] * VX[i] + VY[i] * VY[i] + VZ[i] * VZ[i]);
+		const float InvSpeed = 1.0f / (Speed + 1.0f);
+		const float Thrust = Time[i] < BurnTime[i] ? MotorAccel[i] : 0.0f;
+		const float AlongPath = (Thrust - Drag[i] * Speed * Speed) * InvSpeed;
+		AX += VX[i] * AlongPath;
+		AY += VY[i] * AlongPath;
+		AZ += VZ[i] * AlongPath;
+
+		float NewVX = VX[i] + AX * DeltaTime;
+		float NewVY = VY[i] + AY * DeltaTime;
+		float NewVZ = VZ[i] + AZ * DeltaTime;
+
+		const float NewSpeed = FMath::Sqrt(NewVX * NewVX + NewVY * NewVY + NewVZ * NewVZ);
+		const float SpeedScale = FMath::Min(1.0f, SpeedCap[i] / (NewSpeed + KINDA_SMALL_NUMBER));
+		NewVX *= SpeedScale;
+		NewVY *= SpeedScale;
+		NewVZ *= SpeedScale;
+
+		VX[i] = NewVX;
+		VY[i] = NewVY;
+		VZ[i] = NewVZ;
+		PX[i] += NewVX * DeltaTime;
+		PY[i] += NewVY * DeltaTime;
+		PZ[i] += NewVZ * DeltaTime;
+		Time[i] += DeltaTime;
+	}
+}
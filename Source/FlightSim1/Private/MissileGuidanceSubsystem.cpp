@@ -0,0 +1,99 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#include "MissileGuidanceSubsystem.h"
+#include "Missile.h"
+#include "MissilePoolSubsystem.h"
+#include "FlightSimProfiling.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+
+bool UMissileGuidanceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UMissileGuidanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMissileGuidanceSubsystem, STATGROUP_Tickables);
+}
+
+void UMissileGuidanceSubsystem::RegisterMissile(AMissile* Missile, AActor* Target)
+{
+	if (!Missile || Missile->GuidanceIndex != INDEX_NONE) return;
+
+	Missile->GuidanceIndex = Missiles.Add(Missile);
+	Targets.Add(Target);
+	MaxFlightTimes.Add(Missile->MaxFlightTime);
+	Batch.Add(Missile->GetActorLocation(), Missile->ProjectileMovement->Velocity, Missile->GetGuidanceParams());
+}
+
+void UMissileGuidanceSubsystem::UnregisterMissile(AMissile* Missile)
+{
+	if (!Missile || !Missiles.IsValidIndex(Missile->GuidanceIndex) || Missiles[Missile->GuidanceIndex] != Missile) return;
+
+	const int32 Index = Missile->GuidanceIndex;
+	Missiles.RemoveAtSwap(Index, EAllowShrinking::No);
+	Targets.RemoveAtSwap(Index, EAllowShrinking::No);
+	MaxFlightTimes.RemoveAtSwap(Index, EAllowShrinking::No);
+	Batch.RemoveAtSwap(Index);
+	Missile->GuidanceIndex = INDEX_NONE;
+
+	// The last missile now lives in the freed slot
+	if (Missiles.IsValidIndex(Index))
+	{
+		Missiles[Index]->GuidanceIndex = Index;
+	}
+}
+
+void UMissileGuidanceSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	FLIGHTSIM_SCOPE(Missiles, MissileGuidanceTick);
+	FLIGHTSIM_SET_COUNTER(MissilesInFlight, Missiles.Num());
+
+	if (Missiles.Num() == 0) return;
+
+	// Gather: the projectile component owns the swept position, the batch owns the velocity
+	for (int32 i = 0; i < Missiles.Num(); ++i)
+	{
+		Batch.SetState(i, Missiles[i]->GetActorLocation(), Missiles[i]->ProjectileMovement->Velocity);
+
+		if (const AActor* Target = Targets[i].Get())
+		{
+			Batch.SetTarget(i, Target->GetActorLocation(), Target->GetVelocity());
+		}
+		else
+		{
+			Batch.ClearTarget(i);
+		}
+	}
+
+	MissileGuidance::Step(Batch, DeltaTime);
+
+	// Scatter
+	ExpiredMissiles.Reset();
+	for (int32 i = 0; i < Missiles.Num(); ++i)
+	{
+		Missiles[i]->ProjectileMovement->Velocity = Batch.GetVelocity(i);
+
+		if (Batch.FlightTime[i] > MaxFlightTimes[i])
+		{
+			ExpiredMissiles.Add(Missiles[i]);
+		}
+	}
+
+	if (ExpiredMissiles.Num() > 0)
+	{
+		UMissilePoolSubsystem* MissilePool = GetWorld()->GetSubsystem<UMissilePoolSubsystem>();
+		for (AMissile* Missile : ExpiredMissiles)
+		{
+			if (MissilePool)
+			{
+				MissilePool->Release(Missile);
+			}
+			else
+			{
+				Missile->Destroy();
+			}
+		}
+	}
+}
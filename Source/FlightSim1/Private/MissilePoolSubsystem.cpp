@@ -0,0 +1,76 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#include "MissilePoolSubsystem.h"
+#include "Missile.h"
+#include "FlightSimProfiling.h"
+#include "Engine/World.h"
+
+bool UMissilePoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+AMissile* UMissilePoolSubsystem::SpawnDormant(TSubclassOf<AMissile> MissileClass)
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	AMissile* Missile = GetWorld()->SpawnActor<AMissile>(MissileClass, FVector::ZeroVector, FRotator::ZeroRotator, SpawnParams);
+	if (Missile)
+	{
+		Missile->DeactivateForPool();
+	}
+	return Missile;
+}
+
+void UMissilePoolSubsystem::Prewarm(TSubclassOf<AMissile> MissileClass, int32 Count)
+{
+	if (!MissileClass) return;
+
+	FMissilePool& Pool = Pools.FindOrAdd(MissileClass);
+	Pool.Free.Reserve(Count);
+	while (Pool.Free.Num() < Count)
+	{
+		AMissile* Missile = SpawnDormant(MissileClass);
+		if (!Missile) break;
+		Pool.Free.Add(Missile);
+	}
+}
+
+AMissile* UMissilePoolSubsystem::Launch(TSubclassOf<AMissile> MissileClass, const FVector& Location, const FRotator& Rotation, AActor* Target, APawn* InstigatorPawn)
+{
+	FLIGHTSIM_SCOPE(Missiles, MissileLaunch);
+
+	if (!MissileClass) return nullptr;
+
+	FMissilePool& Pool = Pools.FindOrAdd(MissileClass);
+
+	AMissile* Missile = nullptr;
+	while (!Missile && Pool.Free.Num() > 0)
+	{
+		Missile = Pool.Free.Pop(EAllowShrinking::No);
+		if (!IsValid(Missile))
+		{
+			Missile = nullptr;
+		}
+	}
+
+	// Pool ran dry, grow it
+	if (!Missile)
+	{
+		Missile = SpawnDormant(MissileClass);
+		if (!Missile) return nullptr;
+	}
+
+	Missile->SetInstigator(InstigatorPawn);
+	Missile->LaunchFromPool(Location, Rotation, Target);
+	return Missile;
+}
+
+void UMissilePoolSubsystem::Release(AMissile* Missile)
+{
+	if (!Missile || !Missile->IsInFlight()) return;
+
+	Missile->DeactivateForPool();
+	Pools.FindOrAdd(Missile->GetClass()).Free.Add(Missile);
+}
@@ -0,0 +1,48 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#include "SContactMarkerLayer.h"
+#include "Rendering/DrawElements.h"
+
+void SContactMarkerLayer::Construct(const FArguments& InArgs)
+{
+	LineThickness = InArgs._LineThickness;
+	SetVisibility(EVisibility::HitTestInvisible);
+	Outline.SetNumUninitialized(5);
+}
+
+void SContactMarkerLayer::MarkersChanged()
+{
+	Invalidate(EInvalidateWidgetReason::Paint);
+}
+
+int32 SContactMarkerLayer::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect,
+	FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	// Marker positions are in viewport pixels, the geometry is in DPI-scaled slate units
+	const float InvScale = 1.0f / AllottedGeometry.Scale;
+	const FPaintGeometry PaintGeometry = AllottedGeometry.ToPaintGeometry();
+
+	// Every box is drawn on the same layer with the same effect, so Slate batches them together
+	for (const FContactMarker& Marker : Markers)
+	{
+		const FVector2f Center = Marker.ScreenPosition * InvScale;
+		const float HalfSize = Marker.HalfSize * InvScale;
+
+		Outline[0] = Center + FVector2f(-HalfSize, -HalfSize);
+		Outline[1] = Center + FVector2f(HalfSize, -HalfSize);
+		Outline[2] = Center + FVector2f(HalfSize, HalfSize);
+		Outline[3] = Center + FVector2f(-HalfSize, HalfSize);
+		Outline[4] = Outline[0];
+
+		FSlateDrawElement::MakeLines(OutDrawElements, LayerId, PaintGeometry, Outline, ESlateDrawEffect::None,
+			Marker.Color * InWidgetStyle.GetColorAndOpacityTint(), true, LineThickness);
+	}
+
+	return LayerId;
+}
+
+FVector2D SContactMarkerLayer::ComputeDesiredSize(float LayoutScaleMultiplier) const
+{
+	// Stretches to whatever the viewport gives it
+	return FVector2D::ZeroVector;
+}
@@ -0,0 +1,303 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#include "SensorSubsystem.h"
+#include "AircraftRegistrySubsystem.h"
+#include "FlightSimProfiling.h"
+#include "GameFramework/Pawn.h"
+#include "Engine/World.h"
+
+bool USensorSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void USensorSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	Registry = Collection.InitializeDependency<UAircraftRegistrySubsystem>();
+}
+
+TStatId USensorSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USensorSubsystem, STATGROUP_Tickables);
+}
+
+double USensorSubsystem::GetTime() const
+{
+	return GetWorld()->GetTimeSeconds();
+}
+
+void USensorSubsystem::RegisterSensor(APawn* Owner, const FFlightSensorModel& Model)
+{
+	if (!Owner || SensorLookup.Contains(Owner)) return;
+
+	const int32 Index = Owners.Add(Owner);
+	Models.Add(Model);
+	// Stagger the beams so sensors registered together do not all look the same way
+	ScanPositions.Add(FMath::FRandRange(0.0f, 2.0f * Model.AzimuthHalfAngle));
+	PendingScanTime.Add(0.0f);
+	TrackFiles.AddDefaulted();
+	SensorLookup.Add(Owner, Index);
+}
+
+void USensorSubsystem::UnregisterSensor(APawn* Owner)
+{
+	int32 Index;
+	if (!SensorLookup.RemoveAndCopyValue(Owner, Index)) return;
+
+	Owners.RemoveAtSwap(Index, EAllowShrinking::No);
+	Models.RemoveAtSwap(Index, EAllowShrinking::No);
+	ScanPositions.RemoveAtSwap(Index, EAllowShrinking::No);
+	PendingScanTime.RemoveAtSwap(Index, EAllowShrinking::No);
+	TrackFiles.RemoveAtSwap(Index, EAllowShrinking::No);
+
+	// The last sensor moved into the freed slot
+	if (Owners.IsValidIndex(Index))
+	{
+		SensorLookup[Owners[Index]] = Index;
+	}
+}
+
+const TArray<FSensorTrack>* USensorSubsystem::FindTracks(const APawn* Owner) const
+{
+	const int32* Index = SensorLookup.Find(Owner);
+	return Index ? &TrackFiles[*Index] : nullptr;
+}
+
+const FSensorTrack* USensorSubsystem::FindTrack(const APawn* Owner, const APawn* Target) const
+{
+	const TArray<FSensorTrack>* Tracks = FindTracks(Owner);
+	if (!Tracks) return nullptr;
+
+	const FSensorTrack* Track = Tracks->FindByPredicate([Target](const FSensorTrack& Candidate) { return Candidate.Target.Get() == Target; });
+	return Track && Track->IsValid() ? Track : nullptr;
+}
+
+bool USensorSubsystem::GetTrackedLocation(const APawn* Owner, const APawn* Target, FVector& OutLocation) const
+{
+	const FSensorTrack* Track = FindTrack(Owner, Target);
+	if (!Track) return false;
+
+	OutLocation = Track->PredictLocation(GetTime());
+	return true;
+}
+
+FSensorTrack* USensorSubsystem::FindMutableTrack(int32 Index, const APawn* Target)
+{
+	return TrackFiles[Index].FindByPredicate([Target](const FSensorTrack& Candidate) { return Candidate.Target.Get() == Target; });
+}
+
+void USensorSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	FLIGHTSIM_SCOPE(Sensors, SensorTick);
+
+	// Traces sent last frame first, so their detections are in the tracks before this frame's scans read them
+	ApplyLineOfSightResults();
+
+	for (float& Pending : PendingScanTime)
+	{
+		Pending += DeltaTime;
+	}
+
+	const int32 NumScans = FMath::Min(MaxScansPerFrame, Owners.Num());
+	for (int32 Scanned = 0; Scanned < NumScans; ++Scanned)
+	{
+		if (NextSensorToScan >= Owners.Num())
+		{
+			NextSensorToScan = 0;
+		}
+
+		const int32 Index = NextSensorToScan++;
+		Scan(Index, PendingScanTime[Index]);
+		PendingScanTime[Index] = 0.0f;
+	}
+
+	SubmitLineOfSightChecks();
+	FLIGHTSIM_SET_COUNTER(PendingLineOfSightChecks, QueuedChecks.Num() - FirstQueuedCheck);
+}
+
+void USensorSubsystem::Scan(int32 Index, float ElapsedTime)
+{
+	APawn* Owner = Owners[Index];
+	if (!IsValid(Owner) || !Registry) return;
+
+	const double Now = GetTime();
+	const FFlightSensorModel& Model = Models[Index];
+
+	// Forget contacts that have gone unseen for too long, including ones whose line of sight never cleared
+	TArray<FSensorTrack>& Tracks = TrackFiles[Index];
+	for (int32 t = Tracks.Num() - 1; t >= 0; --t)
+	{
+		if (!Tracks[t].Target.IsValid() || Now - Tracks[t].UpdateTime > TrackTimeout)
+		{
+			Tracks.RemoveAtSwap(t, EAllowShrinking::No);
+		}
+	}
+
+	// Azimuth sector the beam swept since the last scan, measured from the left edge of the volume
+	const float Width = 2.0f * Model.AzimuthHalfAngle;
+	const float SweepStart = ScanPositions[Index];
+	const float SweepEnd = SweepStart + Model.ScanRate * ElapsedTime;
+	const bool bWholeVolume = Model.ScanRate <= 0.0f || SweepEnd - SweepStart >= Width;
+	ScanPositions[Index] = Width > 0.0f ? FMath::Fmod(SweepEnd, Width) : 0.0f;
+
+	const FTransform& Transform = Owner->GetActorTransform();
+	const FVector Origin = Transform.GetLocation();
+
+	ScanCandidates.Reset();
+	Registry->QueryRadius(Origin, Model.Range, ScanCandidates);
+
+	for (int32 Entry : ScanCandidates)
+	{
+		APawn* Target = Registry->GetEntryAircraft(Entry);
+		if (!Target || Target == Owner) continue;
+
+		const FVector& Location = Registry->GetEntryLocation(Entry);
+		const FVector Local = Transform.InverseTransformVectorNoScale(Location - Origin);
+
+		const float Azimuth = FMath::RadiansToDegrees(FMath::Atan2(Local.Y, Local.X));
+		if (FMath::Abs(Azimuth) > Model.AzimuthHalfAngle) continue;
+
+		const float Elevation = FMath::RadiansToDegrees(FMath::Atan2(Local.Z, Local.Size2D()));
+		if (FMath::Abs(Elevation) > Model.ElevationHalfAngle) continue;
+
+		if (!bWholeVolume)
+		{
+			// The sweep may have wrapped past the right edge back to the left
+			const float Offset = Azimuth + Model.AzimuthHalfAngle;
+			const bool bSwept = SweepEnd <= Width ? (Offset >= SweepStart && Offset <= SweepEnd) : (Offset >= SweepStart || Offset <= SweepEnd - Width);
+			if (!bSwept) continue;
+		}
+
+		Detect(Index, Target, Registry->GetEntryTeam(Entry), Origin, Location, Now);
+	}
+}
+
+void USensorSubsystem::Detect(int32 Index, APawn* Target, uint8 Team, const FVector& Origin, const FVector& Location, double Time)
+{
+	FSensorTrack* Track = FindMutableTrack(Index, Target);
+	if (!Track)
+	{
+		// Tentative until the first line-of-sight check clears
+		Track = &TrackFiles[Index].AddDefaulted_GetRef();
+		Track->Target = Target;
+		Track->Team = Team;
+		Track->UpdateTime = Time;
+	}
+
+	if (Time - Track->LineOfSightTime <= LineOfSightReuseTime)
+	{
+		UpdateTrack(*Track, Location, Time);
+		return;
+	}
+
+	if (Track->bLineOfSightPending || QueuedChecks.Num() - FirstQueuedCheck >= MaxPendingLineOfSightChecks) return;
+
+	QueuedChecks.Add({ Owners[Index], Target, Origin, Location, Time });
+	Track->bLineOfSightPending = true;
+}
+
+void USensorSubsystem::UpdateTrack(FSensorTrack& Track, const FVector& MeasuredLocation, double Time) const
+{
+	const float DeltaTime = static_cast<float>(Time - Track.UpdateTime);
+
+	if (Track.NumUpdates == 0)
+	{
+		Track.Location = MeasuredLocation;
+		Track.Velocity = FVector::ZeroVector;
+	}
+	else if (DeltaTime <= UE_KINDA_SMALL_NUMBER)
+	{
+		// Same instant, or older than the estimate (a trace result overtaken by a reused line of sight)
+		return;
+	}
+	else if (Track.NumUpdates == 1)
+	{
+		// Two fixes give the first velocity; filtering starts from the third
+		Track.Velocity = (MeasuredLocation - Track.Location) / DeltaTime;
+		Track.Location = MeasuredLocation;
+	}
+	else
+	{
+		const FVector Predicted = Track.Location + Track.Velocity * DeltaTime;
+		const FVector Residual = MeasuredLocation - Predicted;
+		Track.Location = Predicted + TrackAlpha * Residual;
+		Track.Velocity += (TrackBeta / DeltaTime) * Residual;
+	}
+
+	Track.UpdateTime = Time;
+	++Track.NumUpdates;
+}
+
+void USensorSubsystem::SubmitLineOfSightChecks()
+{
+	const int32 NumQueued = QueuedChecks.Num() - FirstQueuedCheck;
+	const int32 NumToSend = FMath::Min(NumQueued, LineOfSightTracesPerFrame);
+	if (NumToSend > 0)
+	{
+		FLIGHTSIM_ADD_COUNTER(TracesPerFrame, NumToSend);
+
+		if (!LineOfSightDelegate.IsBound())
+		{
+			LineOfSightDelegate.BindUObject(this, &USensorSubsystem::OnLineOfSightTraceComplete);
+		}
+
+		// Only static geometry masks; other aircraft do not
+		const FCollisionObjectQueryParams ObjectParams(ECC_WorldStatic);
+		UWorld* World = GetWorld();
+		for (int32 i = FirstQueuedCheck; i < FirstQueuedCheck + NumToSend; ++i)
+		{
+			FLineOfSightCheck& Check = QueuedChecks[i];
+
+			FCollisionQueryParams CollisionParams(SCENE_QUERY_STAT(SensorLineOfSight));
+			CollisionParams.AddIgnoredActor(Check.Owner.Get());
+			CollisionParams.AddIgnoredActor(Check.Target.Get());
+
+			const FVector Start = Check.Start;
+			const FVector End = Check.End;
+			const int32 CheckIndex = InFlightChecks.Add(MoveTemp(Check));
+			World->AsyncLineTraceByObjectType(EAsyncTraceType::Single, Start, End, ObjectParams, CollisionParams,
+				&LineOfSightDelegate, static_cast<uint32>(CheckIndex));
+		}
+		FirstQueuedCheck += NumToSend;
+	}
+
+	// Compact once the sent prefix outweighs what is still waiting
+	if (FirstQueuedCheck > 0 && FirstQueuedCheck >= QueuedChecks.Num() - FirstQueuedCheck)
+	{
+		QueuedChecks.RemoveAt(0, FirstQueuedCheck, EAllowShrinking::No);
+		FirstQueuedCheck = 0;
+	}
+}
+
+void USensorSubsystem::OnLineOfSightTraceComplete(const FTraceHandle& Handle, FTraceDatum& Data)
+{
+	FLineOfSightResult& Result = CompletedChecks.AddDefaulted_GetRef();
+	Result.CheckIndex = static_cast<int32>(Data.UserData);
+	Result.bClear = !Data.OutHits.ContainsByPredicate([](const FHitResult& Hit) { return Hit.bBlockingHit; });
+}
+
+void USensorSubsystem::ApplyLineOfSightResults()
+{
+	for (const FLineOfSightResult& Result : CompletedChecks)
+	{
+		if (!InFlightChecks.IsValidIndex(Result.CheckIndex)) continue;
+
+		const FLineOfSightCheck Check = InFlightChecks[Result.CheckIndex];
+		InFlightChecks.RemoveAt(Result.CheckIndex);
+
+		// The sensor or the track may have gone while the trace was out
+		const int32* Index = SensorLookup.Find(Check.Owner.Get());
+		FSensorTrack* Track = Index ? FindMutableTrack(*Index, Check.Target.Get()) : nullptr;
+		if (!Track) continue;
+
+		Track->bLineOfSightPending = false;
+		if (Result.bClear)
+		{
+			Track->LineOfSightTime = Check.Time;
+			UpdateTrack(*Track, Check.End, Check.Time);
+		}
+	}
+	CompletedChecks.Reset();
+}
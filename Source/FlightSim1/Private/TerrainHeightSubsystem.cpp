@@ -0,0 +1,174 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#include "TerrainHeightSubsystem.h"
+#include "FlightSim1.h"
+#include "FlightSimProfiling.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Components/SceneComponent.h"
+
+bool UTerrainHeightSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UTerrainHeightSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTerrainHeightSubsystem, STATGROUP_Tickables);
+}
+
+void UTerrainHeightSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+	BeginBake(InWorld);
+}
+
+void UTerrainHeightSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	if (!IsBaking()) return;
+
+	FLIGHTSIM_STAT_SCOPE(TerrainBake);
+	TraceSamples(FPlatformTime::Seconds() + BakeBudgetMilliseconds / 1000.0);
+	if (NextBakeSample == BakeHeights.Num())
+	{
+		FinishBake();
+	}
+}
+
+void UTerrainHeightSubsystem::BeginBake(UWorld& World)
+{
+	Tiles.Reset();
+	BakeHeights.Reset();
+
+	// 1. Area covered by static geometry
+	FBox Bounds(ForceInit);
+	for (TActorIterator<AActor> It(&World); It; ++It)
+	{
+		const USceneComponent* Root = It->GetRootComponent();
+		if (Root && Root->Mobility == EComponentMobility::Static)
+		{
+			Bounds += It->GetComponentsBoundingBox();
+		}
+	}
+	if (!Bounds.IsValid) return;
+
+	const FVector2D Center(Bounds.GetCenter());
+	const FVector2D HalfSize = FVector2D(Bounds.GetExtent()).ClampAxes(0.0, MaxHalfExtent);
+
+	// 2. Grid layout
+	const int32 MaxSamples = FMath::Max(MaxSamplesPerAxis, 2);
+	Spacing = FMath::Max(SampleSpacing, 2.0f * static_cast<float>(HalfSize.GetMax()) / (MaxSamples - 1));
+	InvSpacing = 1.0f / Spacing;
+	Origin = Center - HalfSize;
+
+	NumSamplesX = FMath::Min(FMath::CeilToInt32(2.0 * HalfSize.X * InvSpacing) + 1, MaxSamples);
+	NumSamplesY = FMath::Min(FMath::CeilToInt32(2.0 * HalfSize.Y * InvSpacing) + 1, MaxSamples);
+
+	// 3. Samples are traced from Tick, a budget's worth per frame
+	TraceTop = Bounds.Max.Z + 100.0;
+	TraceBottom = Bounds.Min.Z - 100.0;
+	BakeHeights.SetNumUninitialized(NumSamplesX * NumSamplesY);
+	NextBakeSample = 0;
+	BakeMinHeight = UE_BIG_NUMBER;
+	BakeMaxHeight = -UE_BIG_NUMBER;
+	BakeStartTime = FPlatformTime::Seconds();
+}
+
+void UTerrainHeightSubsystem::TraceSamples(double EndTime)
+{
+	// WorldStatic only, so aircraft and projectiles never end up in the cache
+	const FCollisionObjectQueryParams ObjectParams(ECC_WorldStatic);
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(TerrainHeightBake), false);
+	const UWorld* World = GetWorld();
+
+	const int32 NumSamples = BakeHeights.Num();
+	while (NextBakeSample < NumSamples)
+	{
+		// Reading the clock costs little next to a batch of traces
+		const int32 BatchEnd = FMath::Min(NextBakeSample + 64, NumSamples);
+		for (; NextBakeSample < BatchEnd; ++NextBakeSample)
+		{
+			const double SampleX = Origin.X + (NextBakeSample % NumSamplesX) * Spacing;
+			const double SampleY = Origin.Y + (NextBakeSample / NumSamplesX) * Spacing;
+
+			FHitResult Hit;
+			const bool bHit = World->LineTraceSingleByObjectType(Hit, FVector(SampleX, SampleY, TraceTop), FVector(SampleX, SampleY, TraceBottom), ObjectParams, QueryParams);
+			const float Height = bHit ? static_cast<float>(Hit.ImpactPoint.Z) : static_cast<float>(TraceBottom);
+
+			BakeHeights[NextBakeSample] = Height;
+			BakeMinHeight = FMath::Min(BakeMinHeight, Height);
+			BakeMaxHeight = FMath::Max(BakeMaxHeight, Height);
+		}
+
+		if (FPlatformTime::Seconds() >= EndTime) break;
+	}
+}
+
+void UTerrainHeightSubsystem::FinishBake()
+{
+	// One extra sample on each axis so bilinear lookups on the last row/column stay in bounds
+	NumTilesX = FMath::DivideAndRoundUp(NumSamplesX + 1, TileSize);
+	const int32 NumTilesY = FMath::DivideAndRoundUp(NumSamplesY + 1, TileSize);
+
+	// 4. Quantize into tiles. Samples in padding repeat the nearest edge sample.
+	MinHeight = BakeMinHeight;
+	HeightStep = FMath::Max(BakeMaxHeight - BakeMinHeight, 1.0f) / MAX_uint16;
+	const float InvHeightStep = 1.0f / HeightStep;
+
+	Tiles.SetNumUninitialized(NumTilesX * NumTilesY * TileSize * TileSize);
+	for (int32 y = 0; y < NumTilesY * TileSize; ++y)
+	{
+		for (int32 x = 0; x < NumTilesX * TileSize; ++x)
+		{
+			const float Height = BakeHeights[FMath::Min(y, NumSamplesY - 1) * NumSamplesX + FMath::Min(x, NumSamplesX - 1)];
+			const int32 Tile = (y / TileSize) * NumTilesX + (x / TileSize);
+			Tiles[Tile * TileSize * TileSize + (y % TileSize) * TileSize + (x % TileSize)] =
+				static_cast<uint16>(FMath::Clamp(FMath::RoundToInt32((Height - MinHeight) * InvHeightStep), 0, static_cast<int32>(MAX_uint16)));
+		}
+	}
+	BakeHeights.Empty();
+
+	UE_LOG(LogFlightSim, Log, TEXT("Terrain height field: %d x %d samples at %.0f spacing, %.1f KB, baked over %.2f s"),
+		NumSamplesX, NumSamplesY, Spacing, Tiles.Num() * sizeof(uint16) / 1024.0f, FPlatformTime::Seconds() - BakeStartTime);
+}
+
+uint16 UTerrainHeightSubsystem::GetSample(int32 SampleX, int32 SampleY) const
+{
+	const int32 Tile = (SampleY / TileSize) * NumTilesX + (SampleX / TileSize);
+	return Tiles[Tile * TileSize * TileSize + (SampleY % TileSize) * TileSize + (SampleX % TileSize)];
+}
+
+bool UTerrainHeightSubsystem::GetGroundHeight(double X, double Y, float& OutGroundZ) const
+{
+	if (Tiles.Num() == 0) return false;
+
+	const float GridX = static_cast<float>((X - Origin.X) * InvSpacing);
+	const float GridY = static_cast<float>((Y - Origin.Y) * InvSpacing);
+	if (GridX < 0.0f || GridY < 0.0f || GridX > NumSamplesX - 1 || GridY > NumSamplesY - 1) return false;
+
+	const int32 X0 = FMath::FloorToInt32(GridX);
+	const int32 Y0 = FMath::FloorToInt32(GridY);
+	const float FracX = GridX - X0;
+	const float FracY = GridY - Y0;
+
+	const float Bottom = FMath::Lerp(static_cast<float>(GetSample(X0, Y0)), static_cast<float>(GetSample(X0 + 1, Y0)), FracX);
+	const float Top = FMath::Lerp(static_cast<float>(GetSample(X0, Y0 + 1)), static_cast<float>(GetSample(X0 + 1, Y0 + 1)), FracX);
+	OutGroundZ = MinHeight + FMath::Lerp(Bottom, Top, FracY) * HeightStep;
+	return true;
+}
+
+bool UTerrainHeightSubsystem::GetHeightAboveGround(const FVector& Location, float& OutHeight) const
+{
+	float GroundZ;
+	if (!GetGroundHeight(Location.X, Location.Y, GroundZ)) return false;
+
+	OutHeight = static_cast<float>(Location.Z) - GroundZ;
+	return true;
+}
+
+bool UTerrainHeightSubsystem::IsNearGround(const FVector& Location) const
+{
+	float Height;
+	return !GetHeightAboveGround(Location, Height) || Height < NearGroundBand;
+}
@@ -0,0 +1,213 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "FlightModel.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace FlightModelTests
+{
+	struct FAircraftCase
+	{
+		FVector Velocity;
+		FRotator Rotation;
+		float Throttle;
+		float Pitch, Roll, Yaw;
+		bool bActive;
+	};
+
+	constexpr float MaxThrust = 100000000.0f;
+	constexpr float LiftCoefficient = 0.25f;
+	constexpr float DragCoefficient = 0.02f;
+	constexpr float PitchRate = 60.0f;
+	constexpr float RollRate = 120.0f;
+	constexpr float YawRate = 20.0f;
+
+	// Seven aircraft, so the last register holds a padding lane. Covers rest, vertical flight and a flight path along the wing.
+	TArray<FAircraftCase> MakeCases()
+	{
+		TArray<FAircraftCase> Cases;
+		Cases.Add({ FVector::ZeroVector, FRotator(10.0f, 30.0f, 0.0f), 1.0f, 0.5f, 0.0f, 0.0f, true });
+		Cases.Add({ FVector(0.0f, 0.0f, 20000.0f), FRotator(90.0f, 0.0f, 0.0f), 0.8f, 1.0f, -0.3f, 0.2f, true });
+		Cases.Add({ FVector(0.0f, 0.0f, -15000.0f), FRotator(-90.0f, 45.0f, 0.0f), 0.0f, -1.0f, 0.0f, 0.0f, true });
+		Cases.Add({ FVector(0.0f, 9000.0f, 0.0f), FRotator(0.0f, 0.0f, 0.0f), 0.5f, 0.0f, 1.0f, -1.0f, true });
+		Cases.Add({ FVector(25000.0f, 0.0f, 0.0f), FRotator(0.0f, 0.0f, 0.0f), 1.0f, 0.0f, 0.0f, 0.0f, false });
+
+		FRandomStream Random(1234);
+		for (int32 i = 0; i < 2; ++i)
+		{
+			const FRotator Rotation(Random.FRandRange(-80.0f, 80.0f), Random.FRandRange(-180.0f, 180.0f), Random.FRandRange(-180.0f, 180.0f));
+			const FVector Velocity = Rotation.Vector() * Random.FRandRange(5000.0f, 40000.0f) + Random.GetUnitVector() * 3000.0f;
+			Cases.Add({ Velocity, Rotation, Random.FRand(), Random.FRandRange(-1.0f, 1.0f), Random.FRandRange(-1.0f, 1.0f), Random.FRandRange(-1.0f, 1.0f), true });
+		}
+		return Cases;
+	}
+
+	void FillBatch(FFlightModelBatch& Batch, const TArray<FAircraftCase>& Cases, const FAeroTables* Tables)
+	{
+		Batch.SetNum(Cases.Num());
+		for (int32 i = 0; i < Cases.Num(); ++i)
+		{
+			const FAircraftCase& Case = Cases[i];
+			const FRotationMatrix Axes(Case.Rotation);
+			Batch.SetState(i, Case.Velocity, Axes.GetScaledAxis(EAxis::X), Axes.GetScaledAxis(EAxis::Y), Axes.GetScaledAxis(EAxis::Z));
+			Batch.SetControls(i, Case.Throttle, Case.Pitch, Case.Roll, Case.Yaw, Case.bActive);
+			Batch.SetTuning(i, MaxThrust, LiftCoefficient, DragCoefficient, PitchRate, RollRate, YawRate);
+			Batch.SetTables(i, Tables);
+		}
+	}
+
+	// Straightforward per-aircraft version of EvaluateAerodynamics
+	void ReferenceAerodynamics(const FAircraftCase& Case, const FAeroTables& Tables, FVector& OutForce, FVector& OutTorque)
+	{
+		OutForce = OutTorque = FVector::ZeroVector;
+		const double SpeedSquared = Case.Velocity.SizeSquared();
+		if (!Case.bActive || SpeedSquared < 1.0) return;
+
+		const FRotationMatrix Axes(Case.Rotation);
+		const FVector Forward = Axes.GetScaledAxis(EAxis::X);
+		const FVector Right = Axes.GetScaledAxis(EAxis::Y);
+		const FVector Up = Axes.GetScaledAxis(EAxis::Z);
+
+		const double Speed = FMath::Sqrt(SpeedSquared);
+		const FVector VelocityNormal = Case.Velocity / Speed;
+		const float SinAlpha = FMath::Clamp(static_cast<float>(FVector::DotProduct(VelocityNormal, Up)), -1.0f, 1.0f);
+
+		const FVector Lift = FVector::CrossProduct(VelocityNormal, Right).GetSafeNormal() * SpeedSquared * Tables.GetLift(SinAlpha);
+		const FVector Drag = -VelocityNormal * SpeedSquared * Tables.GetDrag(SinAlpha, Speed / FlightModel::SpeedOfSound);
+		const FVector Thrust = Forward * Case.Throttle * MaxThrust;
+		OutForce = Lift + Drag + Thrust;
+
+		OutTorque = (Right * Case.Pitch * PitchRate + Forward * Case.Roll * RollRate + Up * Case.Yaw * YawRate) * Tables.GetControlEffectiveness(Speed);
+	}
+
+	// Straightforward per-aircraft version of EvaluateBasicAerodynamics
+	void ReferenceBasicAerodynamics(const FAircraftCase& Case, FVector& OutForce, FVector& OutTorque)
+	{
+		OutForce = OutTorque = FVector::ZeroVector;
+		if (!Case.bActive) return;
+
+		const FRotationMatrix Axes(Case.Rotation);
+		const FVector Forward = Axes.GetScaledAxis(EAxis::X);
+		const FVector Right = Axes.GetScaledAxis(EAxis::Y);
+		const FVector Up = Axes.GetScaledAxis(EAxis::Z);
+		const double Speed = Case.Velocity.Size();
+
+		OutForce = Forward * Case.Throttle * MaxThrust + Up * Speed * Speed * LiftCoefficient - Case.Velocity * Speed * DragCoefficient;
+		OutTorque = Right * Case.Pitch * PitchRate + Forward * Case.Roll * RollRate + Up * Case.Yaw * YawRate;
+	}
+
+	// The kernels work in floats; compare relative to the size of the expected value
+	bool NearlyEqual(const FVector& Actual, const FVector& Expected)
+	{
+		const double Tolerance = 1.0e-4 * FMath::Max(Expected.Size(), 1.0);
+		return (Actual - Expected).Size() <= Tolerance;
+	}
+
+	void TestPaddingIsZero(FAutomationTestBase& Test, const FFlightModelBatch& Batch)
+	{
+		for (int32 i = Batch.Num(); i < Batch.Throttle.Num(); ++i)
+		{
+			Test.TestTrue(FString::Printf(TEXT("Padding lane %d has no force"), i), Batch.GetForce(i).IsZero() && Batch.GetTorque(i).IsZero());
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlightModelAerodynamicsTest, "FlightSim.FlightModel.Aerodynamics",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFlightModelAerodynamicsTest::RunTest(const FString& Parameters)
+{
+	using namespace FlightModelTests;
+
+	FAeroTables Tables;
+	Tables.BuildLegacy(LiftCoefficient, DragCoefficient, 0.05f, 15.0f);
+
+	const TArray<FAircraftCase> Cases = MakeCases();
+	FFlightModelBatch Batch;
+	FillBatch(Batch, Cases, &Tables);
+	FlightModel::EvaluateAerodynamics(Batch);
+
+	for (int32 i = 0; i < Cases.Num(); ++i)
+	{
+		FVector ExpectedForce, ExpectedTorque;
+		ReferenceAerodynamics(Cases[i], Tables, ExpectedForce, ExpectedTorque);
+		TestTrue(FString::Printf(TEXT("Aircraft %d force %s matches %s"), i, *Batch.GetForce(i).ToString(), *ExpectedForce.ToString()), NearlyEqual(Batch.GetForce(i), ExpectedForce));
+		TestTrue(FString::Printf(TEXT("Aircraft %d torque %s matches %s"), i, *Batch.GetTorque(i).ToString(), *ExpectedTorque.ToString()), NearlyEqual(Batch.GetTorque(i), ExpectedTorque));
+	}
+
+	TestTrue(TEXT("Aircraft at rest produce no force"), Batch.GetForce(0).IsZero());
+	TestPaddingIsZero(*this, Batch);
+
+	// Without tables an aircraft is switched off
+	FillBatch(Batch, Cases, nullptr);
+	FlightModel::EvaluateAerodynamics(Batch);
+	for (int32 i = 0; i < Cases.Num(); ++i)
+	{
+		TestTrue(FString::Printf(TEXT("Aircraft %d without tables has no force"), i), Batch.GetForce(i).IsZero() && Batch.GetTorque(i).IsZero());
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlightModelBasicAerodynamicsTest, "FlightSim.FlightModel.BasicAerodynamics",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFlightModelBasicAerodynamicsTest::RunTest(const FString& Parameters)
+{
+	using namespace FlightModelTests;
+
+	const TArray<FAircraftCase> Cases = MakeCases();
+	FFlightModelBatch Batch;
+	FillBatch(Batch, Cases, nullptr);
+	FlightModel::EvaluateBasicAerodynamics(Batch);
+
+	for (int32 i = 0; i < Cases.Num(); ++i)
+	{
+		FVector ExpectedForce, ExpectedTorque;
+		ReferenceBasicAerodynamics(Cases[i], ExpectedForce, ExpectedTorque);
+		TestTrue(FString::Printf(TEXT("Aircraft %d force %s matches %s"), i, *Batch.GetForce(i).ToString(), *ExpectedForce.ToString()), NearlyEqual(Batch.GetForce(i), ExpectedForce));
+		TestTrue(FString::Printf(TEXT("Aircraft %d torque %s matches %s"), i, *Batch.GetTorque(i).ToString(), *ExpectedTorque.ToString()), NearlyEqual(Batch.GetTorque(i), ExpectedTorque));
+	}
+
+	TestPaddingIsZero(*this, Batch);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlightModelIntegrateBodyTest, "FlightSim.FlightModel.IntegrateBody",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFlightModelIntegrateBodyTest::RunTest(const FString& Parameters)
+{
+	// Free fall from rest with no damping: v = g t and the body does not turn
+	FFlightBodyState State;
+	const float GravityZ = -980.0f;
+	const float DeltaTime = 0.01f;
+	for (int32 Step = 0; Step < 100; ++Step)
+	{
+		FlightModel::IntegrateBody(State, FVector::ZeroVector, FVector::ZeroVector, 1000.0f, 0.0f, 0.0f, GravityZ, DeltaTime);
+	}
+	TestEqual(TEXT("Free fall speed after one second"), State.Velocity.Z, static_cast<double>(GravityZ), 0.01);
+	TestTrue(TEXT("Free fall does not rotate"), State.Rotation.Equals(FQuat::Identity));
+
+	// Replaying the same moves gives bit-identical results, which client replay relies on
+	FFlightBodyState A, B;
+	A.Velocity = B.Velocity = FVector(20000.0f, 0.0f, 0.0f);
+	for (int32 Step = 0; Step < 50; ++Step)
+	{
+		const FVector Force(1.0e7f, 0.0f, 2.0e6f * FMath::Sin(Step * 0.1f));
+		const FVector AngularAcceleration(10.0f, -5.0f, 2.0f);
+		FlightModel::IntegrateBody(A, Force, AngularAcceleration, 15000.0f, 0.01f, 0.5f, GravityZ, 1.0f / 60.0f);
+		FlightModel::IntegrateBody(B, Force, AngularAcceleration, 15000.0f, 0.01f, 0.5f, GravityZ, 1.0f / 60.0f);
+	}
+	TestTrue(TEXT("Integration is deterministic"), A.Location == B.Location && A.Velocity == B.Velocity && A.Rotation == B.Rotation);
+
+	// Zero or negative steps leave the state alone
+	const FFlightBodyState Before = A;
+	FlightModel::IntegrateBody(A, FVector(1.0e7, 0.0, 0.0), FVector(10.0, 0.0, 0.0), 15000.0f, 0.0f, 0.0f, GravityZ, 0.0f);
+	TestTrue(TEXT("Zero step is a no-op"), A.Location == Before.Location && A.Velocity == Before.Velocity);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,199 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "FlightRecording.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace FlightRecordingTests
+{
+	constexpr int32 NumFrames = 8;
+	constexpr float FrameTime = 1.0f / 30.0f;
+	// One 16-bit angle step, twice the worst rounding error
+	constexpr float AngleTolerance = 360.0f / 65536.0f;
+	// The missile is fired partway through the block, so it is declared by a later frame
+	constexpr int32 MissileLaunchFrame = 4;
+
+	TMap<uint32, FFlightRecordEntity> MakeEntities()
+	{
+		TMap<uint32, FFlightRecordEntity> Entities;
+		Entities.Add(3, { 3, EFlightRecordKind::Aircraft, 0, TEXT("/Game/Aircraft/SM_Fighter.SM_Fighter") });
+		Entities.Add(7, { 7, EFlightRecordKind::Aircraft, 1, TEXT("/Game/Aircraft/SM_Drone.SM_Drone") });
+		Entities.Add(12, { 12, EFlightRecordKind::Missile, 0, TEXT("/Game/Weapons/SM_Missile.SM_Missile") });
+		return Entities;
+	}
+
+	// Aircraft turning through the yaw wrap at 180 degrees, plus a missile launched mid-block. Samples are sorted by id.
+	FFlightRecordFrame MakeFrame(int32 Index)
+	{
+		FFlightRecordFrame Frame;
+		Frame.FrameNumber = 100 + Index;
+		Frame.Time = Index * FrameTime;
+
+		FFlightRecordSample& Fighter = Frame.Samples.AddDefaulted_GetRef();
+		Fighter.EntityId = 3;
+		Fighter.Velocity = FVector3f(25000.3f, -1200.7f, 310.2f);
+		Fighter.Location = FVector3f(150000.37f, -42000.81f, 80000.12f) + Fighter.Velocity * Frame.Time;
+		Fighter.Rotation = FRotator3f(5.3f, 176.0f + 1.7f * Index, -30.0f - 4.1f * Index);
+		Fighter.Throttle = 0.8f + 0.02f * Index;
+		Fighter.Health = 100.0f - 3.33f * Index;
+
+		FFlightRecordSample& Drone = Frame.Samples.AddDefaulted_GetRef();
+		Drone.EntityId = 7;
+		Drone.Velocity = FVector3f(-18000.0f, 0.0f, -150.5f);
+		Drone.Location = FVector3f(-90000.0f, 12000.5f, 60000.0f) + Drone.Velocity * Frame.Time;
+		Drone.Rotation = FRotator3f(-2.0f, -179.5f - 0.9f * Index, 0.0f);
+		Drone.Throttle = 1.0f;
+		Drone.Health = 50.0f;
+
+		if (Index >= MissileLaunchFrame)
+		{
+			// Copied first, since adding a sample can move the array
+			const FVector3f LaunchLocation = Frame.Samples[0].Location;
+			FFlightRecordSample& Missile = Frame.Samples.AddDefaulted_GetRef();
+			Missile.EntityId = 12;
+			Missile.Velocity = FVector3f(60000.0f, -3000.0f, 0.0f);
+			Missile.Location = LaunchLocation + Missile.Velocity * (Index - MissileLaunchFrame) * FrameTime;
+			Missile.Rotation = FRotator3f(0.0f, -2.86f, 0.0f);
+			Missile.Throttle = 1.0f;
+		}
+		return Frame;
+	}
+
+	TArray<uint8> EncodeBlock()
+	{
+		const TMap<uint32, FFlightRecordEntity> Entities = MakeEntities();
+		FFlightRecordEncoder Encoder;
+		Encoder.BeginBlock();
+
+		TArray<uint8> Bytes;
+		for (int32 Index = 0; Index < NumFrames; ++Index)
+		{
+			Encoder.EncodeFrame(MakeFrame(Index), Entities, Bytes);
+		}
+		return Bytes;
+	}
+
+	bool SamplesMatch(const FFlightRecordSample& Decoded, const FFlightRecordSample& Original)
+	{
+		using namespace FlightRecording;
+		return Decoded.EntityId == Original.EntityId
+			&& Decoded.Location.Equals(Original.Location, 0.51f * PositionStep)
+			&& Decoded.Velocity.Equals(Original.Velocity, 0.51f * VelocityStep)
+			&& (Decoded.Rotation - Original.Rotation).IsNearlyZero(AngleTolerance)
+			&& FMath::IsNearlyEqual(Decoded.Throttle, Original.Throttle, 1.0f / 255.0f)
+			&& FMath::IsNearlyEqual(Decoded.Health, Original.Health, 0.51f * HealthStep);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlightRecordingRoundTripTest, "FlightSim.FlightRecording.RoundTrip",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFlightRecordingRoundTripTest::RunTest(const FString& Parameters)
+{
+	using namespace FlightRecordingTests;
+
+	const TArray<uint8> Bytes = EncodeBlock();
+	const TMap<uint32, FFlightRecordEntity> Entities = MakeEntities();
+
+	FFlightRecordDecoder Decoder;
+	Decoder.BeginBlock();
+	const uint8* Cursor = Bytes.GetData();
+	const uint8* End = Cursor + Bytes.Num();
+
+	FFlightRecordFrame Decoded;
+	for (int32 Index = 0; Index < NumFrames; ++Index)
+	{
+		if (!TestTrue(FString::Printf(TEXT("Frame %d decodes"), Index), Decoder.DecodeFrame(Cursor, End, Decoded)))
+		{
+			return true;
+		}
+
+		const FFlightRecordFrame Original = MakeFrame(Index);
+		TestEqual(TEXT("Frame number survives"), Decoded.FrameNumber, Original.FrameNumber);
+		TestEqual(TEXT("Frame time is stored exactly"), Decoded.Time, Original.Time);
+
+		// Entities are declared by the frame they first appear in, and only once per block
+		TArray<uint32> ExpectedDeclarations;
+		if (Index == 0)
+		{
+			ExpectedDeclarations = { 3, 7 };
+		}
+		else if (Index == MissileLaunchFrame)
+		{
+			ExpectedDeclarations = { 12 };
+		}
+		TestEqual(FString::Printf(TEXT("Frame %d declares %d entities"), Index, ExpectedDeclarations.Num()), Decoded.NewEntities.Num(), ExpectedDeclarations.Num());
+		for (int32 i = 0; i < FMath::Min(Decoded.NewEntities.Num(), ExpectedDeclarations.Num()); ++i)
+		{
+			const FFlightRecordEntity& Entity = Decoded.NewEntities[i];
+			const FFlightRecordEntity& Expected = Entities[ExpectedDeclarations[i]];
+			TestTrue(FString::Printf(TEXT("Entity %u is declared with its kind, team and mesh"), Expected.EntityId),
+				Entity.EntityId == Expected.EntityId && Entity.Kind == Expected.Kind && Entity.Team == Expected.Team && Entity.MeshPath == Expected.MeshPath);
+		}
+
+		if (TestEqual(FString::Printf(TEXT("Frame %d sample count"), Index), Decoded.Samples.Num(), Original.Samples.Num()))
+		{
+			for (int32 i = 0; i < Original.Samples.Num(); ++i)
+			{
+				TestTrue(FString::Printf(TEXT("Frame %d entity %u matches within quantization"), Index, Original.Samples[i].EntityId),
+					SamplesMatch(Decoded.Samples[i], Original.Samples[i]));
+			}
+		}
+	}
+
+	TestTrue(TEXT("Decoding consumes the whole block"), Cursor == End);
+	TestFalse(TEXT("Decoding past the end of the block fails"), Decoder.DecodeFrame(Cursor, End, Decoded));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlightRecordingTruncatedBlockTest, "FlightSim.FlightRecording.TruncatedBlock",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFlightRecordingTruncatedBlockTest::RunTest(const FString& Parameters)
+{
+	using namespace FlightRecordingTests;
+
+	const TArray<uint8> Bytes = EncodeBlock();
+
+	// Cut the block at every length short of complete: the frames before the cut still decode, the rest fail
+	bool bTruncationDetected = true;
+	bool bPrefixIntact = true;
+	for (int32 Length = 0; Length < Bytes.Num(); ++Length)
+	{
+		const TArray<uint8> Truncated(Bytes.GetData(), Length);
+		const uint8* Cursor = Truncated.GetData();
+		const uint8* End = Cursor + Truncated.Num();
+
+		FFlightRecordDecoder Decoder;
+		Decoder.BeginBlock();
+		FFlightRecordFrame Decoded;
+		int32 NumDecoded = 0;
+		while (NumDecoded < NumFrames && Decoder.DecodeFrame(Cursor, End, Decoded))
+		{
+			bPrefixIntact &= Decoded.FrameNumber == MakeFrame(NumDecoded).FrameNumber;
+			++NumDecoded;
+		}
+		bTruncationDetected &= NumDecoded < NumFrames;
+		bPrefixIntact &= Cursor <= End;
+	}
+	TestTrue(TEXT("Every truncated block fails to decode in full"), bTruncationDetected);
+	TestTrue(TEXT("Frames before the cut decode unchanged"), bPrefixIntact);
+
+	// The frames must really be there for the failures above to mean anything
+	FFlightRecordDecoder Decoder;
+	Decoder.BeginBlock();
+	const uint8* Cursor = Bytes.GetData();
+	FFlightRecordFrame Decoded;
+	int32 NumDecoded = 0;
+	while (NumDecoded < NumFrames && Decoder.DecodeFrame(Cursor, Bytes.GetData() + Bytes.Num(), Decoded))
+	{
+		++NumDecoded;
+	}
+	TestEqual(TEXT("The complete block decodes every frame"), NumDecoded, NumFrames);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
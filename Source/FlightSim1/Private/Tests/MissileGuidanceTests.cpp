@@ -0,0 +1,125 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "MissileGuidance.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace MissileGuidanceTests
+{
+	constexpr float StepTime = 1.0f / 60.0f;
+	constexpr float HitRadius = 500.0f;
+
+	// Flies missile 0 of the batch for Duration seconds, moving the target along with it, and returns the closest approach
+	float FlyToClosestApproach(FMissileGuidanceBatch& Batch, FVector TargetLocation, const FVector& TargetVelocity, float Duration)
+	{
+		float ClosestDistance = FVector::Dist(Batch.GetPosition(0), TargetLocation);
+		const int32 NumSteps = FMath::CeilToInt32(Duration / StepTime);
+		for (int32 Step = 0; Step < NumSteps; ++Step)
+		{
+			MissileGuidance::Step(Batch, StepTime);
+			TargetLocation += TargetVelocity * StepTime;
+			if (Batch.HasTarget[0] > 0.0f)
+			{
+				Batch.SetTarget(0, TargetLocation, TargetVelocity);
+			}
+			ClosestDistance = FMath::Min(ClosestDistance, static_cast<float>(FVector::Dist(Batch.GetPosition(0), TargetLocation)));
+		}
+		return ClosestDistance;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMissileGuidanceStationaryTargetTest, "FlightSim.MissileGuidance.StationaryTarget",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FMissileGuidanceStationaryTargetTest::RunTest(const FString& Parameters)
+{
+	using namespace MissileGuidanceTests;
+
+	// Launched straight ahead with the target well off the nose
+	const FVector TargetLocation(100000.0f, 20000.0f, 0.0f);
+	FMissileGuidanceBatch Batch;
+	Batch.Add(FVector::ZeroVector, FVector(20000.0f, 0.0f, 0.0f), FMissileGuidanceBatch::FMissileParams());
+	Batch.SetTarget(0, TargetLocation, FVector::ZeroVector);
+
+	const float MissDistance = FlyToClosestApproach(Batch, TargetLocation, FVector::ZeroVector, 10.0f);
+	TestTrue(FString::Printf(TEXT("Missile intercepts a stationary target, missing by %.1f cm"), MissDistance), MissDistance < HitRadius);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMissileGuidanceCrossingTargetTest, "FlightSim.MissileGuidance.CrossingTarget",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FMissileGuidanceCrossingTargetTest::RunTest(const FString& Parameters)
+{
+	using namespace MissileGuidanceTests;
+
+	const FVector TargetLocation(80000.0f, -20000.0f, 0.0f);
+	const FVector TargetVelocity(0.0f, 6000.0f, 0.0f);
+
+	FMissileGuidanceBatch Guided;
+	Guided.Add(FVector::ZeroVector, FVector(20000.0f, 0.0f, 0.0f), FMissileGuidanceBatch::FMissileParams());
+	Guided.SetTarget(0, TargetLocation, TargetVelocity);
+	const float GuidedMiss = FlyToClosestApproach(Guided, TargetLocation, TargetVelocity, 10.0f);
+	TestTrue(FString::Printf(TEXT("Guided missile intercepts a crossing target, missing by %.1f cm"), GuidedMiss), GuidedMiss < HitRadius);
+
+	// The same launch without a target flies straight and misses, so the hit above is down to guidance
+	FMissileGuidanceBatch Ballistic;
+	Ballistic.Add(FVector::ZeroVector, FVector(20000.0f, 0.0f, 0.0f), FMissileGuidanceBatch::FMissileParams());
+	const float BallisticMiss = FlyToClosestApproach(Ballistic, TargetLocation, TargetVelocity, 10.0f);
+	TestTrue(FString::Printf(TEXT("Ballistic missile misses a crossing target by %.1f cm"), BallisticMiss), BallisticMiss > 4.0f * HitRadius);
+	TestTrue(TEXT("Ballistic missile is not steered"), FMath::IsNearlyZero(Ballistic.VelY[0]) && FMath::IsNearlyZero(Ballistic.VelZ[0]));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMissileGuidanceMotorBurnoutTest, "FlightSim.MissileGuidance.MotorBurnout",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FMissileGuidanceMotorBurnoutTest::RunTest(const FString& Parameters)
+{
+	using namespace MissileGuidanceTests;
+
+	const FMissileGuidanceBatch::FMissileParams Params;
+	FMissileGuidanceBatch Batch;
+	Batch.Add(FVector::ZeroVector, FVector(1000.0f, 0.0f, 0.0f), Params);
+
+	// Burn: the motor outpulls drag up to the speed cap
+	float Speed = Batch.GetVelocity(0).Size();
+	bool bAccelerates = true;
+	bool bCapped = true;
+	while (Batch.FlightTime[0] < Params.MotorBurnTime)
+	{
+		MissileGuidance::Step(Batch, StepTime);
+		const float NewSpeed = Batch.GetVelocity(0).Size();
+		bAccelerates &= NewSpeed >= Speed;
+		bCapped &= NewSpeed <= Params.MaxSpeed * (1.0f + KINDA_SMALL_NUMBER);
+		Speed = NewSpeed;
+	}
+	TestTrue(TEXT("Missile gains speed while the motor burns"), bAccelerates);
+	TestTrue(TEXT("Missile never exceeds its top speed"), bCapped);
+	TestTrue(FString::Printf(TEXT("Missile reaches top speed by burnout, at %.1f cm/s"), Speed), FMath::IsNearlyEqual(Speed, Params.MaxSpeed, 1.0f));
+
+	// Coast: drag alone slows it as dv/dt = -k v^2, so v(t) = v0 / (1 + k v0 t)
+	const float BurnoutSpeed = Speed;
+	const float BurnoutTime = Batch.FlightTime[0];
+	bool bDecelerates = true;
+	for (int32 Step = 0; Step < 420; ++Step)
+	{
+		MissileGuidance::Step(Batch, StepTime);
+		const float NewSpeed = Batch.GetVelocity(0).Size();
+		bDecelerates &= NewSpeed < Speed;
+		Speed = NewSpeed;
+	}
+	TestTrue(TEXT("Missile loses speed every step after burnout"), bDecelerates);
+
+	const float CoastTime = Batch.FlightTime[0] - BurnoutTime;
+	const float ExpectedSpeed = BurnoutSpeed / (1.0f + Params.DragCoefficient * BurnoutSpeed * CoastTime);
+	TestTrue(FString::Printf(TEXT("Coast speed %.1f cm/s follows the drag model's %.1f cm/s"), Speed, ExpectedSpeed), FMath::IsNearlyEqual(Speed, ExpectedSpeed, ExpectedSpeed * 0.01f));
+	TestTrue(TEXT("Unguided missile keeps its heading"), FMath::IsNearlyZero(Batch.VelY[0]) && FMath::IsNearlyZero(Batch.VelZ[0]));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
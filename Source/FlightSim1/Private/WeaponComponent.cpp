@@ -0,0 +1,162 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#include "WeaponComponent.h"
+#include "WeaponFireSubsystem.h"
+#include "FlightEffectsSubsystem.h"
+#include "FlightSimProfiling.h"
+#include "Components/SceneComponent.h"
+#include "Engine/World.h"
+#include "Net/UnrealNetwork.h"
+
+UWeaponComponent::UWeaponComponent()
+{
+	// Advanced by the owner's own update; only replicas of owners without one tick, and only while firing
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	SetIsReplicatedByDefault(true);
+
+	Definition = nullptr;
+	Muzzle = nullptr;
+	Cooldown = 0.0f;
+	bTriggerHeld = false;
+	bWasTriggerHeld = false;
+	bEffectsEnabled = true;
+	bUpdateOnSimulatedProxy = false;
+}
+
+void UWeaponComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME_CONDITION(UWeaponComponent, bTriggerHeld, COND_SkipOwner);
+}
+
+void UWeaponComponent::OnRep_TriggerHeld()
+{
+	UpdateLoopingSound();
+
+	if (bUpdateOnSimulatedProxy && GetOwnerRole() == ROLE_SimulatedProxy)
+	{
+		// The server's cooldown is not replicated, so a replica fires as soon as it sees the trigger
+		if (bTriggerHeld)
+		{
+			Cooldown = 0.0f;
+		}
+		SetComponentTickEnabled(bTriggerHeld);
+	}
+}
+
+void UWeaponComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	UpdateWeapon(DeltaTime);
+}
+
+void UWeaponComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UFlightEffectsSubsystem* Effects = GetWorld()->GetSubsystem<UFlightEffectsSubsystem>())
+	{
+		Effects->StopLoopingSound(GetOwner());
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UWeaponComponent::SetTriggerHeld(bool bHeld)
+{
+	if (bHeld == bTriggerHeld) return;
+
+	bTriggerHeld = bHeld;
+	UpdateLoopingSound();
+}
+
+void UWeaponComponent::SetEffectsEnabled(bool bEnabled)
+{
+	if (bEnabled == bEffectsEnabled) return;
+
+	bEffectsEnabled = bEnabled;
+	UpdateLoopingSound();
+}
+
+void UWeaponComponent::UpdateLoopingSound()
+{
+	UFlightEffectsSubsystem* Effects = GetWorld() ? GetWorld()->GetSubsystem<UFlightEffectsSubsystem>() : nullptr;
+	if (!Effects) return;
+
+	if (bTriggerHeld && bEffectsEnabled)
+	{
+		Effects->StartLoopingSound(GetOwner(), GetStats().FireSound);
+	}
+	else
+	{
+		Effects->StopLoopingSound(GetOwner());
+	}
+}
+
+void UWeaponComponent::UpdateWeapon(float DeltaTime)
+{
+	Cooldown -= DeltaTime;
+
+	const bool bPressed = bTriggerHeld && !bWasTriggerHeld;
+	bWasTriggerHeld = bTriggerHeld;
+	if (!bTriggerHeld)
+	{
+		// Rounds are only owed while the trigger is held
+		Cooldown = FMath::Max(Cooldown, 0.0f);
+		return;
+	}
+	if (Cooldown > 0.0f) return;
+
+	FLIGHTSIM_SCOPE(Weapons, FireWeapon);
+
+	// A press counts from the end of the step it arrived in, so its first round has no catching up to do
+	if (bPressed)
+	{
+		Cooldown = 0.0f;
+	}
+
+	const FWeaponStats& Stats = GetStats();
+	const float Interval = FMath::Max(Stats.FireInterval, 0.01f);
+	int32 NumRounds = 0;
+	while (Cooldown <= 0.0f && NumRounds < Stats.MaxRoundsPerUpdate)
+	{
+		FireRound(Stats, -Cooldown);
+		Cooldown += Interval;
+		++NumRounds;
+	}
+
+	// Anything still owed past the cap is dropped
+	Cooldown = FMath::Max(Cooldown, 0.0f);
+
+	// One flash covers every round of the update
+	if (bEffectsEnabled)
+	{
+		if (UFlightEffectsSubsystem* Effects = GetWorld()->GetSubsystem<UFlightEffectsSubsystem>())
+		{
+			const USceneComponent* From = Muzzle ? Muzzle : GetOwner()->GetRootComponent();
+			Effects->SpawnEffect(EFlightEffectCategory::MuzzleFlash, Stats.MuzzleFlashFX, From->GetComponentLocation(), From->GetComponentRotation());
+		}
+	}
+}
+
+void UWeaponComponent::FireRound(const FWeaponStats& Stats, float Age)
+{
+	UWeaponFireSubsystem* WeaponFire = GetWorld()->GetSubsystem<UWeaponFireSubsystem>();
+	if (!WeaponFire) return;
+
+	AActor* Owner = GetOwner();
+	const USceneComponent* From = Muzzle ? Muzzle : Owner->GetRootComponent();
+	const FVector Forward = Owner->GetActorForwardVector();
+
+	// Relative to the aircraft, a round that fell due Age seconds ago is already that far ahead of the muzzle
+	const FVector MuzzleLocation = From->GetComponentLocation();
+	const FVector Location = MuzzleLocation + Forward * (Stats.MuzzleSpeed * Age);
+	// Replicated movement does not give non-simulating replicas a velocity
+	const bool bReplicaMovement = Owner->GetLocalRole() == ROLE_SimulatedProxy && Owner->IsReplicatingMovement();
+	const FVector OwnerVelocity = bReplicaMovement ? FVector(Owner->GetReplicatedMovement().LinearVelocity) : Owner->GetVelocity();
+	const FVector RoundVelocity = OwnerVelocity + Forward * Stats.MuzzleSpeed;
+
+	// The round flies as data in the weapon subsystem. A client's rounds are only tracers; the server's deal the damage.
+	WeaponFire->FireRound(Owner, MuzzleLocation, Location, RoundVelocity, Owner->HasAuthority() ? Stats.Damage : 0.0f);
+}
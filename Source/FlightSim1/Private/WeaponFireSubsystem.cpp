@@ -0,0 +1,317 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#include "WeaponFireSubsystem.h"
+#include "FlightSim1.h"
+#include "AircraftRegistrySubsystem.h"
+#include "DamageSubsystem.h"
+#include "DroneSwarmSubsystem.h"
+#include "TerrainHeightSubsystem.h"
+#include "FlightSimProfiling.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/AssetManager.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Math/VectorRegister.h"
+
+bool UWeaponFireSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UWeaponFireSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	Registry = Collection.InitializeDependency<UAircraftRegistrySubsystem>();
+	Terrain = Collection.InitializeDependency<UTerrainHeightSubsystem>();
+	Drones = Collection.InitializeDependency<UDroneSwarmSubsystem>();
+	RoundTraceDelegate.BindUObject(this, &UWeaponFireSubsystem::OnRoundTraceComplete);
+}
+
+TStatId UWeaponFireSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UWeaponFireSubsystem, STATGROUP_Tickables);
+}
+
+void UWeaponFireSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Nothing to draw on a dedicated server
+	if (InWorld.GetNetMode() == NM_DedicatedServer) return;
+
+	// Streamed in so level start does not wait on it; rounds fired before it arrives are simulated but not drawn
+	TracerMeshLoad = UAssetManager::GetStreamableManager().RequestAsyncLoad(TracerMesh.ToSoftObjectPath(),
+		FStreamableDelegate::CreateUObject(this, &UWeaponFireSubsystem::OnTracerMeshLoaded));
+}
+
+void UWeaponFireSubsystem::OnTracerMeshLoaded()
+{
+	UWorld* World = GetWorld();
+	UStaticMesh* Mesh = TracerMesh.Get();
+	if (!World || !Mesh || Tracers) return;
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.ObjectFlags |= RF_Transient;
+	AActor* TracerActor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+	if (!TracerActor) return;
+
+	Tracers = NewObject<UInstancedStaticMeshComponent>(TracerActor, TEXT("Tracers"));
+	Tracers->SetStaticMesh(Mesh);
+	Tracers->SetMobility(EComponentMobility::Movable);
+	Tracers->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Tracers->SetCastShadow(false);
+	TracerActor->SetRootComponent(Tracers);
+	Tracers->RegisterComponent();
+}
+
+void UWeaponFireSubsystem::FireRound(AActor* Shooter, const FVector& Muzzle, const FVector& Location, const FVector& Velocity, float Damage)
+{
+	if (NumRounds >= MaxRounds) return;
+
+	// The first step only checks from Location on, so a round that starts down range checks the stretch it skipped now
+	const bool bSkippedStretch = Damage > 0.0f && !Location.Equals(Muzzle);
+	if (bSkippedStretch && Shooter && Drones && Drones->HitDrone(Muzzle, Location, Damage)) return;
+
+	// Grow the padded arrays a whole vector at a time
+	const int32 Index = NumRounds++;
+	if (Index >= PositionX.Num())
+	{
+		for (TArray<float>* Lane : { &PositionX, &PositionY, &PositionZ, &VelocityX, &VelocityY, &VelocityZ, &StartX, &StartY, &StartZ, &TimeRemaining })
+		{
+			Lane->AddZeroed(4);
+		}
+	}
+
+	PositionX[Index] = static_cast<float>(Location.X);
+	PositionY[Index] = static_cast<float>(Location.Y);
+	PositionZ[Index] = static_cast<float>(Location.Z);
+	VelocityX[Index] = static_cast<float>(Velocity.X);
+	VelocityY[Index] = static_cast<float>(Velocity.Y);
+	VelocityZ[Index] = static_cast<float>(Velocity.Z);
+	TimeRemaining[Index] = RoundLifetime;
+
+	Serials.Add(NextSerial++);
+	Shooters.Add(Shooter);
+	Damages.Add(Damage);
+
+	if (bSkippedStretch && TraceRound(Index, Muzzle, Location))
+	{
+		FLIGHTSIM_ADD_COUNTER(TracesPerFrame, 1);
+	}
+}
+
+void UWeaponFireSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	FLIGHTSIM_SCOPE(Weapons, WeaponFireTick);
+
+	// Hits from last frame's batch first, so those rounds are gone before this frame's step
+	ApplyCompletedHits();
+	StepRounds(DeltaTime);
+	CollideRounds();
+	UpdateTracers();
+
+	FLIGHTSIM_SET_COUNTER(RoundsInFlight, NumRounds);
+}
+
+void UWeaponFireSubsystem::StepRounds(float DeltaTime)
+{
+	FLIGHTSIM_STAT_SCOPE(StepRounds);
+
+	// Semi-implicit Euler: v += (g - k|v|v) dt, then p += v dt
+	const VectorRegister4Float Dt = VectorSetFloat1(DeltaTime);
+	const VectorRegister4Float GravityStep = VectorSetFloat1(GetWorld()->GetGravityZ() * DeltaTime);
+	const VectorRegister4Float NegativeDragStep = VectorSetFloat1(-DragFactor * DeltaTime);
+
+	for (int32 i = 0; i < NumRounds; i += 4)
+	{
+		const VectorRegister4Float PX = VectorLoad(&PositionX[i]);
+		const VectorRegister4Float PY = VectorLoad(&PositionY[i]);
+		const VectorRegister4Float PZ = VectorLoad(&PositionZ[i]);
+		VectorRegister4Float VX = VectorLoad(&VelocityX[i]);
+		VectorRegister4Float VY = VectorLoad(&VelocityY[i]);
+		VectorRegister4Float VZ = VectorLoad(&VelocityZ[i]);
+
+		VectorStore(PX, &StartX[i]);
+		VectorStore(PY, &StartY[i]);
+		VectorStore(PZ, &StartZ[i]);
+
+		const VectorRegister4Float SpeedSquared = VectorMultiplyAdd(VX, VX, VectorMultiplyAdd(VY, VY, VectorMultiply(VZ, VZ)));
+		const VectorRegister4Float DragScale = VectorMultiply(NegativeDragStep, VectorSqrt(SpeedSquared));
+
+		VX = VectorMultiplyAdd(VX, DragScale, VX);
+		VY = VectorMultiplyAdd(VY, DragScale, VY);
+		VZ = VectorAdd(VectorMultiplyAdd(VZ, DragScale, VZ), GravityStep);
+
+		VectorStore(VX, &VelocityX[i]);
+		VectorStore(VY, &VelocityY[i]);
+		VectorStore(VZ, &VelocityZ[i]);
+		VectorStore(VectorMultiplyAdd(VX, Dt, PX), &PositionX[i]);
+		VectorStore(VectorMultiplyAdd(VY, Dt, PY), &PositionY[i]);
+		VectorStore(VectorMultiplyAdd(VZ, Dt, PZ), &PositionZ[i]);
+		VectorStore(VectorSubtract(VectorLoad(&TimeRemaining[i]), Dt), &TimeRemaining[i]);
+	}
+}
+
+void UWeaponFireSubsystem::CollideRounds()
+{
+	FLIGHTSIM_STAT_SCOPE(CollideRounds);
+
+	int32 NumTraces = 0;
+	for (int32 i = NumRounds - 1; i >= 0; --i)
+	{
+		const FVector End(PositionX[i], PositionY[i], PositionZ[i]);
+
+		float GroundZ;
+		if (TimeRemaining[i] <= 0.0f || (Terrain && Terrain->GetGroundHeight(End.X, End.Y, GroundZ) && End.Z <= GroundZ))
+		{
+			RemoveRound(i);
+			continue;
+		}
+
+		if (Damages[i] <= 0.0f) continue;
+
+		// Drones fire without a shooter and do not hit each other. A drone hit is known now, so the round stops here.
+		const FVector Start(StartX[i], StartY[i], StartZ[i]);
+		if (Drones && !Shooters[i].IsExplicitlyNull() && Drones->HitDrone(Start, End, Damages[i]))
+		{
+			RemoveRound(i);
+			continue;
+		}
+
+		if (TraceRound(i, Start, End))
+		{
+			++NumTraces;
+		}
+	}
+
+	FLIGHTSIM_ADD_COUNTER(TracesPerFrame, NumTraces);
+}
+
+bool UWeaponFireSubsystem::TraceRound(int32 Index, const FVector& Start, const FVector& End)
+{
+	AActor* Shooter = Shooters[Index].Get();
+	if (!IsNearAircraft(Start, End, Shooter)) return false;
+
+	FCollisionQueryParams CollisionParams(SCENE_QUERY_STAT(GunfireTrace));
+	CollisionParams.AddIgnoredActor(Shooter);
+
+	const int32 TraceIndex = InFlightTraces.Add({ Serials[Index], Shooters[Index], Damages[Index] });
+	GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, Start, End, ECC_Gunfire, CollisionParams,
+		FCollisionResponseParams::DefaultResponseParam, &RoundTraceDelegate, static_cast<uint32>(TraceIndex));
+	return true;
+}
+
+bool UWeaponFireSubsystem::IsNearAircraft(const FVector& Start, const FVector& End, const AActor* Shooter)
+{
+	if (!Registry) return false;
+
+	NearbyEntries.Reset();
+	Registry->QueryRadius((Start + End) * 0.5, FVector::Dist(Start, End) * 0.5 + AircraftProximity, NearbyEntries);
+
+	const float ProximitySquared = FMath::Square(AircraftProximity);
+	for (int32 Entry : NearbyEntries)
+	{
+		if (Registry->GetEntryAircraft(Entry) == Shooter) continue;
+		if (FMath::PointDistToSegmentSquared(Registry->GetEntryLocation(Entry), Start, End) <= ProximitySquared)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void UWeaponFireSubsystem::OnRoundTraceComplete(const FTraceHandle& Handle, FTraceDatum& Data)
+{
+	const int32 TraceIndex = static_cast<int32>(Data.UserData);
+	if (Data.OutHits.Num() > 0 && Data.OutHits[0].GetActor())
+	{
+		CompletedHits.Add({ TraceIndex, Data.OutHits[0].GetActor() });
+	}
+	else if (InFlightTraces.IsValidIndex(TraceIndex))
+	{
+		InFlightTraces.RemoveAt(TraceIndex);
+	}
+}
+
+void UWeaponFireSubsystem::ApplyCompletedHits()
+{
+	if (CompletedHits.Num() == 0) return;
+
+	UDamageSubsystem* DamageSubsystem = GetWorld()->GetSubsystem<UDamageSubsystem>();
+	for (const FRoundHit& Hit : CompletedHits)
+	{
+		if (!InFlightTraces.IsValidIndex(Hit.TraceIndex)) continue;
+
+		const FRoundTrace Trace = InFlightTraces[Hit.TraceIndex];
+		InFlightTraces.RemoveAt(Hit.TraceIndex);
+
+		// The round stops in whatever it hit. Hits are few, so a search beats keeping a serial -> index map current.
+		// A round fired down range has two segments in one batch, and whichever hit is applied second finds it gone.
+		const int32 Index = Serials.Find(Trace.Serial);
+		if (Index == INDEX_NONE) continue;
+		RemoveRound(Index);
+
+		if (DamageSubsystem && Hit.HitActor.IsValid())
+		{
+			DamageSubsystem->QueueDamage(Hit.HitActor.Get(), Trace.Damage, Trace.Shooter.Get(), EFlightDamageType::Gunfire);
+		}
+	}
+	CompletedHits.Reset();
+}
+
+void UWeaponFireSubsystem::UpdateTracers()
+{
+	if (!Tracers) return;
+
+	const FVector Scale(TracerWidth / 100.0f, TracerWidth / 100.0f, TracerLength / 100.0f);
+	TracerTransforms.SetNum(NumRounds, EAllowShrinking::No);
+	for (int32 i = 0; i < NumRounds; ++i)
+	{
+		// The tracer trails the round along its flight path
+		const FVector Direction = FVector(VelocityX[i], VelocityY[i], VelocityZ[i]).GetSafeNormal();
+		const FVector Location = FVector(PositionX[i], PositionY[i], PositionZ[i]) - Direction * (TracerLength * 0.5f);
+		TracerTransforms[i] = FTransform(FRotationMatrix::MakeFromZ(Direction).ToQuat(), Location, Scale);
+	}
+
+	const int32 NumInstances = Tracers->GetInstanceCount();
+	if (NumInstances < NumRounds)
+	{
+		TArray<FTransform> NewInstances;
+		NewInstances.Init(FTransform::Identity, NumRounds - NumInstances);
+		Tracers->AddInstances(NewInstances, false, true);
+	}
+	else if (NumInstances > NumRounds)
+	{
+		TArray<int32> Removed;
+		for (int32 i = NumInstances - 1; i >= NumRounds; --i)
+		{
+			Removed.Add(i);
+		}
+		Tracers->RemoveInstances(Removed);
+	}
+
+	if (NumRounds > 0)
+	{
+		Tracers->BatchUpdateInstancesTransforms(0, TracerTransforms, true, true, true);
+	}
+}
+
+void UWeaponFireSubsystem::RemoveRound(int32 Index)
+{
+	// Move the last round into the hole; the padded lanes keep their length
+	const int32 Last = NumRounds - 1;
+	if (Index != Last)
+	{
+		for (TArray<float>* Lane : { &PositionX, &PositionY, &PositionZ, &VelocityX, &VelocityY, &VelocityZ, &StartX, &StartY, &StartZ, &TimeRemaining })
+		{
+			(*Lane)[Index] = (*Lane)[Last];
+		}
+	}
+	--NumRounds;
+
+	Serials.RemoveAtSwap(Index, EAllowShrinking::No);
+	Shooters.RemoveAtSwap(Index, EAllowShrinking::No);
+	Damages.RemoveAtSwap(Index, EAllowShrinking::No);
+}
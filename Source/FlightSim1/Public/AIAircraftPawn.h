@@ -4,12 +4,16 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Pawn.h"
+#include "GenericTeamAgentInterface.h"
+#include "SensorSubsystem.h"
 #include "AIAircraftPawn.generated.h"
 
 class UHealthComponent;
 class USceneComponent;
+class UWeaponComponent;
 class UParticleSystem;
 class USoundBase;
+class UAIFlightSubsystem;
 
 UENUM(BlueprintType)
 enum class EAIState : uint8
@@ -20,16 +24,33 @@ enum class EAIState : uint8
 };
 
 UCLASS()
-class FLIGHTSIM1_API AAIAircraftPawn : public APawn
+class FLIGHTSIM1_API AAIAircraftPawn : public APawn, public IGenericTeamAgentInterface
 {
 	GENERATED_BODY()
 
+	// Flight and state updates are batched by the subsystem instead of ticking per actor
+	friend class UAIFlightSubsystem;
+
+	// Drones copy their tuning from the class defaults and hand over to a spawned pawn on promotion
+	friend class UDroneSwarmSubsystem;
+
 public:
 	AAIAircraftPawn();
 
+	// --- IGenericTeamAgentInterface ---
+	virtual void SetGenericTeamId(const FGenericTeamId& NewTeamId) override;
+	virtual FGenericTeamId GetGenericTeamId() const override;
+
+	virtual void PostLoad() override;
+
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+public:
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
+protected:
 	// --- Components ---
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
 	UStaticMeshComponent* AircraftMesh;
@@ -40,6 +61,15 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
 	USceneComponent* MuzzleLocation;
 
+	// Triggered and advanced by UAIFlightSubsystem on the server, replicated to clients for tracers and effects
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+	UWeaponComponent* WeaponComponent;
+
+	// --- Team ---
+	// Aircraft only attack aircraft of other teams. The player flies for team 0.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Replicated, Category = "Team")
+	uint8 TeamId;
+
 	// --- AI Properties ---
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
 	float FlightSpeed;
@@ -56,39 +86,40 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
 	float CirclingOffsetDistance;
 
-	// --- Weapon Properties ---
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapons")
-	float FireRate;
+	// --- Sensors ---
+	// Aircraft only go after what this finds. Server only.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Sensors")
+	FFlightSensorModel SensorModel;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapons")
-	float WeaponRange;
+	// --- Deprecated Weapon Properties ---
+	// Moved to WeaponComponent. Still loaded so PostLoad can carry values set before the move over to it, and still
+	// visible to Blueprints so graphs that used them warn instead of failing to compile.
+	UPROPERTY(BlueprintReadWrite, Category = "Weapons", meta = (DeprecatedProperty, DeprecationMessage = "Use FireInterval in WeaponComponent's DefaultStats or its Definition."))
+	float FireRate_DEPRECATED;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapons")
-	float FireAngleThreshold;
+	UPROPERTY(BlueprintReadWrite, Category = "Weapons", meta = (DeprecatedProperty, DeprecationMessage = "Use FireAngleThreshold in WeaponComponent's DefaultStats or its Definition."))
+	float FireAngleThreshold_DEPRECATED;
 
-	UPROPERTY(EditDefaultsOnly, Category = "Weapons")
-	UParticleSystem* MuzzleFlashFX;
+	UPROPERTY(meta = (DeprecatedProperty, DeprecationMessage = "Set MuzzleFlashFX on WeaponComponent or its Definition."))
+	UParticleSystem* MuzzleFlashFX_DEPRECATED;
 
-	UPROPERTY(EditDefaultsOnly, Category = "Weapons")
-	USoundBase* FireSound;
+	UPROPERTY(meta = (DeprecatedProperty, DeprecationMessage = "Set FireSound on WeaponComponent or its Definition."))
+	USoundBase* FireSound_DEPRECATED;
 
-	// --- AI State Machine ---
-	EAIState CurrentAIState;
-	FTimerHandle EvasionTimerHandle;
-	FTimerHandle FireRateTimerHandle;
+	// Guns fired hitscan traces this long before rounds were simulated. Nothing reads it.
+	UPROPERTY(BlueprintReadWrite, Category = "Weapons", meta = (DeprecatedProperty, DeprecationMessage = "Guns no longer have a fixed range; rounds fly for UWeaponFireSubsystem's RoundLifetime."))
+	float WeaponRange_DEPRECATED;
 
-	void MoveAndTurn(float DeltaTime);
-	void TryFireWeapon();
-	void FireWeapon();
+	// --- AI State Machine ---
+	// Slot in UAIFlightSubsystem, which owns the state machine and movement. Server only; clients get replicated movement.
+	int32 FlightIndex;
 
 	// --- Evasion Logic ---
 	UFUNCTION()
 	void HandleTakeDamage(AActor* DamagedActor, float NewHealth);
-	void BeginEvasion();
-	void EndEvasion();
-	void PerformEvasion(float DeltaTime);
 
 public:
-	virtual void Tick(float DeltaTime) override;
+	UFUNCTION(BlueprintPure, Category = "AI")
+	EAIState GetAIState() const;
 };
 
@@ -0,0 +1,365 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AIAircraftPawn.h"
+#include "AIFlightSubsystem.generated.h"
+
+class UStaticMeshComponent;
+class UTerrainHeightSubsystem;
+class UAircraftRegistrySubsystem;
+class USensorSubsystem;
+struct FSensorTrack;
+
+// How much simulation an AI aircraft gets at one significance level
+USTRUCT()
+struct FAISignificanceTier
+{
+	GENERATED_BODY()
+
+	FAISignificanceTier() = default;
+	FAISignificanceTier(float InMinSignificance, int32 InUpdateInterval, float InWeaponInterval, bool bInSimulatePhysics, bool bInEnableEffects)
+		: MinSignificance(InMinSignificance), UpdateInterval(InUpdateInterval), WeaponEvaluationInterval(InWeaponInterval)
+		, bSimulatePhysics(bInSimulatePhysics), bEnableEffects(bInEnableEffects)
+	{}
+
+	// Aircraft at least this significant qualify for the tier
+	UPROPERTY(EditAnywhere, Category = "Significance")
+	float MinSignificance = 0.0f;
+
+	// Frames between AI updates; skipped frames are made up with a longer step
+	UPROPERTY(EditAnywhere, Category = "Significance", meta = (ClampMin = "1"))
+	int32 UpdateInterval = 1;
+
+	// Seconds between fire decisions
+	UPROPERTY(EditAnywhere, Category = "Significance")
+	float WeaponEvaluationInterval = 0.0f;
+
+	// Rigid body simulation; otherwise the aircraft is moved kinematically
+	UPROPERTY(EditAnywhere, Category = "Significance")
+	bool bSimulatePhysics = true;
+
+	// Muzzle flashes and gun sounds
+	UPROPERTY(EditAnywhere, Category = "Significance")
+	bool bEnableEffects = true;
+};
+
+/**
+ * Owns the flight state of every AAIAircraftPawn in the world and updates all of them in one batched pass per frame.
+ * Pawns register in BeginPlay and unregister in EndPlay; they do not tick on their own.
+ * State is stored as struct-of-arrays: index i in every array refers to the same aircraft.
+ *
+ * Each frame's update has three phases. The game thread snapshots transforms and picks the aircraft due an update.
+ * The decisions (state changes, steering, the kinematic step and whether to fire) then run across worker threads
+ * with ParallelFor, reading only the snapshot and writing only their own FAIUpdate. Finally the game thread
+ * applies the updates: state, rotations, forces, swept moves and fire requests.
+ *
+ * Targets are picked by a central assignment pass that runs at AssignmentInterval rather than every frame.
+ * Each attacker considers its nearest hostile tracks from its own sensor, so it only goes after aircraft it can
+ * actually see, and attackers are spread across targets by penalizing targets that already have attackers.
+ * Aircraft then fly at the tracked location, and drop the target once the track is lost.
+ *
+ * Attackers sharing a target fly in groups of FormationSize: the first to pick the target leads and the others
+ * hold vee slots off its wing until the leader is within FormationBreakDistance of the target. On top of that every
+ * aircraft steers with boids rules against its nearest neighbours from the registry's per-frame grid: separation
+ * from any aircraft, and alignment and cohesion with its own team. Each aircraft looks at no more than MaxNeighbors
+ * others, so the pass stays linear in the number of aircraft.
+ *
+ * Every aircraft also has a significance tier, from its apparent size in each player's view, whether it is on screen
+ * and whether it is after that player, taking the highest over all players. Less significant tiers update less often, evaluate weapons less often,
+ * drop rigid body physics and skip effects. Tiers change with hysteresis so aircraft near a boundary do not flicker.
+ *
+ * Aircraft without rigid body physics, either from their tier or because bKinematicFlight is set, are flown by a
+ * point-mass integrator: the flight path turns toward the goal within the turn rate and load factor limits, the
+ * body banks into a coordinated turn, and moves are swept only when other aircraft or the ground are close.
+ */
+UCLASS(Config = Game)
+class FLIGHTSIM1_API UAIFlightSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Adds the aircraft to the batch and returns its slot index
+	int32 RegisterAircraft(AAIAircraftPawn* Aircraft);
+	void UnregisterAircraft(AAIAircraftPawn* Aircraft);
+
+	// Called by the pawn when it takes damage, switches the slot into evasion
+	void NotifyDamaged(int32 Index);
+
+	int32 GetNumAircraft() const { return Pawns.Num(); }
+	EAIState GetAIState(int32 Index) const { return States.IsValidIndex(Index) ? States[Index] : EAIState::Seeking; }
+	APawn* GetAssignedTarget(int32 Index) const { return Targets.IsValidIndex(Index) ? Targets[Index].Get() : nullptr; }
+	int32 GetSignificanceTier(int32 Index) const { return SignificanceTierIndices.IsValidIndex(Index) ? SignificanceTierIndices[Index] : 0; }
+
+	// Tuning is Config, set in the [/Script/FlightSim1.AIFlightSubsystem] section of DefaultGame.ini
+
+	// --- Target assignment tuning ---
+	// Seconds between assignment passes
+	UPROPERTY(Config, EditAnywhere, Category = "Target Assignment")
+	float AssignmentInterval = 0.5f;
+
+	// Number of nearest hostile tracks each attacker considers
+	UPROPERTY(Config, EditAnywhere, Category = "Target Assignment")
+	int32 CandidatesPerAttacker = 6;
+
+	// Hostiles further away than this are ignored
+	UPROPERTY(Config, EditAnywhere, Category = "Target Assignment")
+	float MaxTargetDistance = 1000000.0f;
+
+	// Cost added per unit of (1 - cos) off the attacker's nose
+	UPROPERTY(Config, EditAnywhere, Category = "Target Assignment")
+	float NoseAngleWeight = 0.5f;
+
+	// Cost added per unit of (1 - cos) off the target's tail
+	UPROPERTY(Config, EditAnywhere, Category = "Target Assignment")
+	float AspectWeight = 0.25f;
+
+	// Cost added for every attacker already assigned to the target
+	UPROPERTY(Config, EditAnywhere, Category = "Target Assignment")
+	float AttackerCountWeight = 0.3f;
+
+	// --- Terrain avoidance ---
+	// Seconds ahead along the current velocity at which terrain clearance is checked
+	UPROPERTY(Config, EditAnywhere, Category = "Terrain Avoidance")
+	float TerrainLookAheadTime = 2.0f;
+
+	// Aircraft predicted to come closer than this to the ground pull up
+	UPROPERTY(Config, EditAnywhere, Category = "Terrain Avoidance")
+	float MinTerrainClearance = 5000.0f;
+
+	// Minimum nose-up pitch in degrees while pulling up
+	UPROPERTY(Config, EditAnywhere, Category = "Terrain Avoidance")
+	float PullUpPitch = 25.0f;
+
+	// --- Significance ---
+	// Most to least significant. Significance is bounds radius over distance from the viewer, scaled below.
+	UPROPERTY(Config, EditAnywhere, Category = "Significance")
+	TArray<FAISignificanceTier> SignificanceTiers = {
+		FAISignificanceTier(0.02f, 1, 0.0f, true, true),
+		FAISignificanceTier(0.005f, 2, 0.25f, true, true),
+		FAISignificanceTier(0.0015f, 4, 0.5f, false, false),
+		FAISignificanceTier(0.0f, 8, 1.0f, false, false) };
+
+	// Seconds between significance passes
+	UPROPERTY(Config, EditAnywhere, Category = "Significance")
+	float SignificanceInterval = 0.25f;
+
+	// Fraction below a tier's threshold an aircraft must fall before it drops to the next tier
+	UPROPERTY(Config, EditAnywhere, Category = "Significance")
+	float SignificanceHysteresis = 0.25f;
+
+	// Significance multiplier for aircraft outside a player's field of view
+	UPROPERTY(Config, EditAnywhere, Category = "Significance")
+	float OffScreenSignificanceScale = 0.35f;
+
+	// Significance multiplier for aircraft targeting a player
+	UPROPERTY(Config, EditAnywhere, Category = "Significance")
+	float ThreatSignificanceScale = 3.0f;
+
+	// --- Kinematic flight ---
+	// Fly every AI aircraft with the point-mass integrator and no rigid body, whatever its significance tier
+	UPROPERTY(Config, EditAnywhere, Category = "Kinematic Flight")
+	bool bKinematicFlight = false;
+
+	// Maximum load factor in g, which caps the turn rate at high speed
+	UPROPERTY(Config, EditAnywhere, Category = "Kinematic Flight")
+	float MaxLoadFactor = 9.0f;
+
+	// Degrees per second the body rolls toward the coordinated bank angle
+	UPROPERTY(Config, EditAnywhere, Category = "Kinematic Flight")
+	float BankRate = 180.0f;
+
+	// Moves are swept when another aircraft is within this distance plus the move length
+	UPROPERTY(Config, EditAnywhere, Category = "Kinematic Flight")
+	float SweepProximity = 5000.0f;
+
+	// --- Formation ---
+	// Leader plus wingmen per group
+	UPROPERTY(Config, EditAnywhere, Category = "Formation", meta = (ClampMin = "1"))
+	int32 FormationSize = 4;
+
+	// Distance between neighbouring slots, back and out
+	UPROPERTY(Config, EditAnywhere, Category = "Formation")
+	float FormationSpacing = 3000.0f;
+
+	// Wingmen break off to attack once their leader is this close to the target
+	UPROPERTY(Config, EditAnywhere, Category = "Formation")
+	float FormationBreakDistance = 30000.0f;
+
+	// How far ahead of its slot, along the leader's heading, a wingman aims
+	UPROPERTY(Config, EditAnywhere, Category = "Formation")
+	float FormationLookAhead = 8000.0f;
+
+	// --- Flocking ---
+	UPROPERTY(Config, EditAnywhere, Category = "Flocking")
+	float NeighborRadius = 10000.0f;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Flocking")
+	int32 MaxNeighbors = 6;
+
+	// Aircraft closer than this push apart, harder the closer they are
+	UPROPERTY(Config, EditAnywhere, Category = "Flocking")
+	float SeparationRadius = 4000.0f;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Flocking")
+	float SeparationWeight = 1.5f;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Flocking")
+	float AlignmentWeight = 0.3f;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Flocking")
+	float CohesionWeight = 0.2f;
+
+	// --- Threading ---
+	// Run the decision phase across worker threads; off runs it inline on the game thread
+	UPROPERTY(Config, EditAnywhere, Category = "Threading")
+	bool bParallelDecisions = true;
+
+	// Aircraft per worker task. Decisions are cheap, so small batches spend more on scheduling than on work.
+	UPROPERTY(Config, EditAnywhere, Category = "Threading", meta = (ClampMin = "1"))
+	int32 DecisionBatchSize = 32;
+
+private:
+	// One aircraft's update this frame. The game thread fills the first block, the decision phase the rest.
+	struct FAIUpdate
+	{
+		int32 Index = INDEX_NONE;
+		float StepTime = 0.0f;
+		bool bSimulatingPhysics = false;
+
+		EAIState State = EAIState::Seeking;
+		float EvasionTimeRemaining = 0.0f;
+		float WeaponCooldown = 0.0f;
+		bool bLostTarget = false;
+		bool bEvaluateFire = false;
+		bool bFire = false;
+
+		// New pose. Location and velocity only for kinematic aircraft; physics aircraft get thrust instead.
+		FRotator Rotation = FRotator::ZeroRotator;
+		FVector Location = FVector::ZeroVector;
+		FVector Velocity = FVector::ZeroVector;
+	};
+
+	void GatherState();
+	void AssignTargets();
+	void UpdateSignificance();
+	void SetSignificanceTier(int32 Index, int32 NewTier);
+
+	// Per-worker scratch for the decision phase
+	struct FAIDecisionContext
+	{
+		TArray<int32> Neighbors;
+	};
+
+	// --- Decision phase, any thread ---
+	void Decide(FAIUpdate& Update, FAIDecisionContext& Context) const;
+	bool GetFormationGoal(int32 Index, const FVector& TargetLocation, FVector& OutGoal) const;
+	FVector ComputeFlocking(int32 Index, TArray<int32>& Neighbors, bool bSeparationOnly) const;
+	void MoveAndTurn(FAIUpdate& Update, const FVector& TargetActorLocation, const FVector& FlockSteer) const;
+	void PerformEvasion(FAIUpdate& Update) const;
+	void Steer(FAIUpdate& Update, const FRotator& DesiredRotation, float InterpSpeed) const;
+	void IntegrateKinematic(FAIUpdate& Update, const FVector& DesiredDirection) const;
+
+	// --- Apply phase, game thread ---
+	void ApplyUpdate(const FAIUpdate& Update);
+	void ApplyThrust(int32 Index, float DeltaTime);
+	void MoveKinematic(int32 Index, const FAIUpdate& Update);
+	bool NeedsSweep(int32 Index, float MoveDistance);
+	FRotator AvoidTerrain(int32 Index, const FRotator& DesiredRotation) const;
+	void RemoveAtSwap(int32 Index);
+
+	// --- Object handles ---
+	UPROPERTY()
+	TArray<AAIAircraftPawn*> Pawns;
+
+	UPROPERTY()
+	TArray<UStaticMeshComponent*> Meshes;
+
+	UPROPERTY()
+	UTerrainHeightSubsystem* Terrain;
+
+	UPROPERTY()
+	UAircraftRegistrySubsystem* Registry;
+
+	UPROPERTY()
+	USensorSubsystem* Sensors;
+
+	// --- Tuning, copied from the pawn on register ---
+	TArray<float> FlightSpeeds;
+	TArray<float> TurnSpeeds;
+	TArray<float> MaxSpeeds;
+	TArray<float> AvoidanceDistances;
+	TArray<float> CirclingOffsets;
+	TArray<float> FireAngleThresholds;
+	TArray<float> MuzzleSpeeds;
+
+	// --- AI state ---
+	TArray<uint8> Teams;
+	TArray<TWeakObjectPtr<APawn>> Targets;
+	// Formation leader, null for leaders and aircraft flying alone, and the slot offset in the leader's frame
+	TArray<TWeakObjectPtr<AAIAircraftPawn>> Leaders;
+	TArray<FVector> FormationSlots;
+	TArray<EAIState> States;
+	TArray<float> EvasionTimeRemaining;
+
+	// --- Significance state ---
+	TArray<uint8> SignificanceTierIndices;
+	TArray<int32> FramesUntilUpdate;
+	// Time since the aircraft's last update, consumed as its next step
+	TArray<float> PendingDeltaTime;
+	TArray<float> WeaponCooldowns;
+
+	// --- Per-frame snapshot, gathered once at the start of the pass ---
+	TArray<FVector> Locations;
+	TArray<FRotator> Rotations;
+	TArray<FVector> Velocities;
+
+	// How long an aircraft keeps evading after being hit
+	float EvasionDuration = 2.0f;
+
+	float TimeUntilAssignment = 0.0f;
+	float TimeUntilSignificance = 0.0f;
+	float FrameDeltaTime = 0.0f;
+
+	// Aircraft due an update this frame
+	TArray<FAIUpdate> Updates;
+	TArray<FAIDecisionContext> DecisionContexts;
+
+	// --- Significance scratch, one entry per player view ---
+	struct FSignificanceViewer
+	{
+		FVector Location;
+		FVector Direction;
+		float CosHalfFov;
+		const APawn* Pawn;
+	};
+	TArray<FSignificanceViewer> Viewers;
+
+	// --- Assignment scratch, kept to avoid reallocating every pass ---
+	struct FAssignmentCandidate
+	{
+		APawn* Target;
+		float BaseCost;
+	};
+	TArray<FAssignmentCandidate> AssignmentCandidates;
+	TArray<int32> AssignmentOrder;
+	TArray<float> BestBaseCosts;
+	struct FNearbyTrack
+	{
+		const FSensorTrack* Track;
+		FVector Location;
+		float DistanceSquared;
+	};
+	TArray<FNearbyTrack> NearbyTracks;
+	TArray<int32> NearbyEntries;
+	TMap<APawn*, int32> AttackerCounts;
+	// Leader of the group currently filling up on each target
+	TMap<APawn*, AAIAircraftPawn*> GroupLeaders;
+};
@@ -0,0 +1,72 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Curves/CurveFloat.h"
+#include "FlightModel.h"
+#include "AerodynamicProfile.generated.h"
+
+// Drag coefficient against angle of attack at one Mach number
+USTRUCT(BlueprintType)
+struct FAeroDragCurve
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = "Drag", meta = (ClampMin = "0.0"))
+	float Mach = 0.0f;
+
+	// Cd against angle of attack in degrees (-90 to 90)
+	UPROPERTY(EditAnywhere, Category = "Drag")
+	FRuntimeFloatCurve DragCurve;
+};
+
+/**
+ * Aerodynamic coefficients for one aircraft type, authored as curves and baked into FAeroTables on load.
+ * The flight model only ever samples the baked tables, so the curves can be as detailed as needed
+ * (post-stall lift, transonic drag rise) without affecting per-tick cost.
+ */
+UCLASS(BlueprintType)
+class FLIGHTSIM1_API UAerodynamicProfile : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UAerodynamicProfile();
+
+	// Cl against angle of attack in degrees (-90 to 90)
+	UPROPERTY(EditAnywhere, Category = "Lift")
+	FRuntimeFloatCurve LiftCurve;
+
+	// Cd curves at increasing Mach numbers; speeds between two entries blend them, speeds outside use the nearest one
+	UPROPERTY(EditAnywhere, Category = "Drag")
+	TArray<FAeroDragCurve> DragCurves;
+
+	// Control surface effectiveness (0-1) against airspeed in cm/s
+	UPROPERTY(EditAnywhere, Category = "Controls")
+	FRuntimeFloatCurve ControlEffectivenessCurve;
+
+	// --- Baking ---
+	UPROPERTY(EditAnywhere, Category = "Baking", meta = (ClampMin = "2", ClampMax = "4096"))
+	int32 AngleOfAttackSamples;
+
+	UPROPERTY(EditAnywhere, Category = "Baking", meta = (ClampMin = "2", ClampMax = "256"))
+	int32 MachSamples;
+
+	UPROPERTY(EditAnywhere, Category = "Baking", meta = (ClampMin = "2", ClampMax = "1024"))
+	int32 AirspeedSamples;
+
+	// Baked tables, rebuilt on load and whenever a curve is edited
+	const FAeroTables& GetTables();
+
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+	void BakeTables();
+
+	FAeroTables Tables;
+};
@@ -0,0 +1,92 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AircraftRegistrySubsystem.generated.h"
+
+/**
+ * Index of every live aircraft in the world, bucketed into a uniform grid that is rebuilt once per frame.
+ * Aircraft join in BeginPlay and leave on death/EndPlay. Queries only visit the grid cells that overlap
+ * the query volume, so their cost grows with nearby contacts rather than with the world's actor count.
+ *
+ * Queries return entry indices; use the Get* accessors to read the entry. Indices stay valid until the next grid rebuild.
+ * Positions are the snapshot taken at the last rebuild.
+ */
+UCLASS(Config = Game)
+class FLIGHTSIM1_API UAircraftRegistrySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterAircraft(APawn* Aircraft);
+	void UnregisterAircraft(APawn* Aircraft);
+
+	// --- Queries. Results are appended to OutEntries, which is not cleared. ---
+	// All entries within Radius of Center
+	void QueryRadius(const FVector& Center, float Radius, TArray<int32>& OutEntries) const;
+
+	// All entries within Range of Origin whose direction from Origin is within the cone (Direction must be normalized)
+	void QueryCone(const FVector& Origin, const FVector& Direction, float CosHalfAngle, float Range, TArray<int32>& OutEntries) const;
+
+	// Up to K entries closest to Center within MaxRadius, sorted nearest first
+	void QueryKNearest(const FVector& Center, int32 K, float MaxRadius, TArray<int32>& OutEntries) const;
+
+	// As QueryKNearest, but only entries whose team differs from Team
+	void QueryKNearestHostiles(const FVector& Center, uint8 Team, int32 K, float MaxRadius, TArray<int32>& OutEntries) const;
+
+	// --- Entry accessors ---
+	int32 GetNumEntries() const { return Aircraft.Num(); }
+	APawn* GetEntryAircraft(int32 Entry) const { return Aircraft[Entry]; }
+	const FVector& GetEntryLocation(int32 Entry) const { return Locations[Entry]; }
+	const FVector& GetEntryVelocity(int32 Entry) const { return Velocities[Entry]; }
+	uint8 GetEntryTeam(int32 Entry) const { return Teams[Entry]; }
+
+	// Tuning is Config, set in the [/Script/FlightSim1.AircraftRegistrySubsystem] section of DefaultGame.ini
+
+	// Edge length of a grid cell, in cm
+	UPROPERTY(Config, EditAnywhere, Category = "Aircraft Registry")
+	float CellSize = 25000.0f;
+
+private:
+	void RebuildGrid();
+	FIntVector GetCell(const FVector& Location) const;
+
+	template <typename PredicateType>
+	void GatherFromCells(const FVector& Center, float Radius, PredicateType&& Predicate) const;
+
+	template <typename FilterType>
+	void GatherKNearest(const FVector& Center, int32 K, float MaxRadius, FilterType&& Filter, TArray<int32>& OutEntries) const;
+
+	// --- Entries, struct-of-arrays ---
+	UPROPERTY()
+	TArray<APawn*> Aircraft;
+
+	TArray<FVector> Locations;
+	TArray<FVector> Velocities;
+
+	// Cached from IGenericTeamAgentInterface on register; aircraft do not change sides
+	TArray<uint8> Teams;
+
+	// Aircraft -> entry index, used to find entries on unregister
+	TMap<TObjectKey<APawn>, int32> EntryLookup;
+
+	// --- Grid ---
+	// Entry indices sorted by cell; each cell owns a contiguous range of this array
+	TArray<int32> SortedEntries;
+
+	// Cell -> (first index into SortedEntries, count)
+	TMap<FIntVector, FIntPoint> CellRanges;
+
+	// Scratch storage for the rebuild, kept to avoid reallocating every frame
+	TArray<TPair<FIntVector, int32>> Keyed;
+
+	// Entries that were unregistered since the last rebuild, skipped by queries
+	TBitArray<> RemovedEntries;
+	bool bHasRemovedEntries = false;
+};
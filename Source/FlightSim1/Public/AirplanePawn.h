@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Pawn.h"
+#include "FlightModel.h"
 #include "AirplanePawn.generated.h"
 
 // Forward declare classes to improve compile times
@@ -93,6 +94,9 @@ private:
 	double YawInput = 0.0;
 	double ThrottleInput = 0.0;
 
+	// Single-aircraft batch for the flight model
+	FFlightModelBatch FlightModelBatch;
+
 	// Functions to handle the input events
 	void HandleThrottle(const FInputActionValue& Value);
 	void HandlePitch(const FInputActionValue& Value);
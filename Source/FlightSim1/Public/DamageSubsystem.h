@@ -0,0 +1,95 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DamageSubsystem.generated.h"
+
+class UHealthComponent;
+
+UENUM(BlueprintType)
+enum class EFlightDamageType : uint8
+{
+	Generic,
+	Gunfire,
+	Missile,
+	Collision
+};
+
+// Slot in the damage subsystem's health table. The serial catches handles to slots that were freed and reused.
+struct FHealthHandle
+{
+	int32 Index = INDEX_NONE;
+	uint32 Serial = 0;
+
+	bool IsValid() const { return Index != INDEX_NONE; }
+};
+
+/**
+ * Resolves all damage in the world once per frame.
+ * Health components register at BeginPlay and get a handle into the health table; the owning actor is also
+ * indexed, so hit paths can queue damage by actor without searching its components. Queued damage is summed
+ * per target and applied in one pass at the end of the frame: each damaged component broadcasts
+ * OnHealthChanged once, and kills are logged and reported to the game mode here rather than inside weapon code.
+ */
+UCLASS()
+class FLIGHTSIM1_API UDamageSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	FHealthHandle RegisterHealth(UHealthComponent* Health);
+	void UnregisterHealth(FHealthHandle Handle);
+
+	// Handle of the health component on Target, if it has registered one
+	FHealthHandle FindHealth(const AActor* Target) const;
+
+	// Current health of the component behind Handle, 0 if it has unregistered
+	float GetHealth(FHealthHandle Handle) const;
+
+	void QueueDamage(FHealthHandle Target, float Amount, AActor* Instigator, EFlightDamageType DamageType);
+
+	// Convenience for hit paths that only have the actor. Actors without health are ignored.
+	void QueueDamage(const AActor* Target, float Amount, AActor* Instigator, EFlightDamageType DamageType);
+
+private:
+	struct FQueuedDamage
+	{
+		FHealthHandle Target;
+		float Amount;
+		TWeakObjectPtr<AActor> Instigator;
+		EFlightDamageType DamageType;
+	};
+
+	bool IsHandleValid(FHealthHandle Handle) const;
+	void ResolveDamage();
+
+	// --- Health table, indexed by FHealthHandle::Index ---
+	UPROPERTY()
+	TArray<UHealthComponent*> Components;
+
+	TArray<uint32> Serials;
+	TArray<int32> FreeSlots;
+	TMap<TObjectKey<AActor>, int32> SlotsByActor;
+	uint32 NextSerial = 1;
+
+	// --- Per-frame queue ---
+	TArray<FQueuedDamage> QueuedDamage;
+
+	// --- Resolve scratch, kept to avoid reallocating every frame ---
+	TArray<float> PendingDamage;
+	TArray<int32> DamagedSlots;
+
+	struct FKill
+	{
+		UHealthComponent* Victim;
+		TWeakObjectPtr<AActor> Killer;
+		EFlightDamageType DamageType;
+	};
+	TArray<FKill> Kills;
+};
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/GameModeBase.h"
+#include "Engine/StreamableManager.h"
 #include "DogfightGameModeBase.generated.h"
 
 class UUserWidget;
@@ -13,31 +14,103 @@ class FLIGHTSIM1_API ADogfightGameModeBase : public AGameModeBase
 {
 	GENERATED_BODY()
 
+	// Overrides spawn counts for benchmark runs
+	friend class UFlightSimBenchmarkSubsystem;
+
 public:
 	ADogfightGameModeBase();
 
+	// Routes an aircraft death to PlayerDied/EnemyDied depending on who controlled it and which team it flew for
+	void AircraftDied(APawn* DeadAircraft);
+
 	void EnemyDied();
 	void PlayerDied();
 
+	// Adds Count enemy drones to the swarm, in rings around a point DroneSpawnDistance ahead of the origin.
+	// Needs the AI pawn class, which drones are promoted to, so does nothing before it has loaded.
+	void SpawnDroneWave(int32 Count);
+
+	virtual void Tick(float DeltaSeconds) override;
+
 protected:
 	virtual void BeginPlay() override;
 
+	// Loaded asynchronously at match start, together with everything it references
 	UPROPERTY(EditDefaultsOnly, Category = "Spawning")
-	TSubclassOf<APawn> AIPawnClass;
+	TSoftClassPtr<APawn> AIPawnClass;
 
 	UPROPERTY(EditDefaultsOnly, Category = "Spawning")
 	int32 NumberOfEnemiesToSpawn;
 
+	// Radius of the innermost spawn ring; larger groups fill further rings outwards
 	UPROPERTY(EditDefaultsOnly, Category = "Spawning")
 	float SpawnRadius;
 
+	// Minimum distance between two spawn points
+	UPROPERTY(EditDefaultsOnly, Category = "Spawning")
+	float SpawnSeparation;
+
+	// Aircraft released per wave
+	UPROPERTY(EditDefaultsOnly, Category = "Spawning", meta = (ClampMin = "1"))
+	int32 SpawnWaveSize;
+
+	// Seconds between waves. 0 releases everything at once, still spread over frames by the budget.
+	UPROPERTY(EditDefaultsOnly, Category = "Spawning", meta = (ClampMin = "0.0"))
+	float SpawnWaveInterval;
+
+	// Game thread time per frame spent spawning, in milliseconds. At least one aircraft spawns per frame.
+	UPROPERTY(EditDefaultsOnly, Category = "Spawning", meta = (ClampMin = "0.0"))
+	float SpawnBudgetMs;
+
+	// AI wingmen flying for the player's team. Use together with NumberOfEnemiesToSpawn for AI-vs-AI load tests.
+	UPROPERTY(EditDefaultsOnly, Category = "Spawning")
+	int32 NumberOfAlliesToSpawn;
+
+	// Enemy drones released as one swarm wave once the AI pawn class has loaded. See UDroneSwarmSubsystem.
+	UPROPERTY(EditDefaultsOnly, Category = "Drone Swarm")
+	int32 NumberOfDronesToSpawn;
+
+	// Drone waves gather this far out along +X, well beyond promotion range of a player at the origin
+	UPROPERTY(EditDefaultsOnly, Category = "Drone Swarm")
+	float DroneSpawnDistance;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Teams")
+	uint8 PlayerTeamId;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Teams")
+	uint8 EnemyTeamId;
+
 	UPROPERTY(EditDefaultsOnly, Category = "UI")
 	TSubclassOf<UUserWidget> GameOverWidgetClass;
 
 private:
+	struct FPendingSpawn
+	{
+		FVector Location;
+		uint8 TeamId;
+	};
+
 	int32 LivingEnemies;
 
 	void SpawnEnemies();
+	void OnAIPawnClassLoaded();
+	void SpawnPendingAircraft();
+	APawn* SpawnAircraft(const FVector& Location, uint8 TeamId);
+	void AddSpawnPoints(TArray<FPendingSpawn>& OutSpawns, int32 Count, uint8 TeamId, const FVector& Center) const;
+	// Radius of the outermost ring AddSpawnPoints uses for Count aircraft
+	float GetSpawnRingsRadius(int32 Count) const;
+	bool IsSpawning() const { return PendingSpawns.Num() > 0; }
 	void CheckWinCondition();
+	void OnDroneDestroyed(uint8 TeamId);
+
+	// Spawn points for the whole match, computed up front and consumed in order
+	TArray<FPendingSpawn> PendingSpawns;
+	int32 NextPendingSpawn;
+	float FirstWaveTime;
+
+	UPROPERTY()
+	UClass* LoadedAIPawnClass;
+
+	TSharedPtr<FStreamableHandle> AIPawnClassHandle;
 };
 
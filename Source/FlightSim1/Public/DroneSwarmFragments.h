@@ -0,0 +1,77 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityTypes.h"
+#include "Templates/SubclassOf.h"
+#include "DroneSwarmFragments.generated.h"
+
+class AAIAircraftPawn;
+
+// Point-mass flight state of a drone
+USTRUCT()
+struct FDroneFlightFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	FVector Location = FVector::ZeroVector;
+	FVector Velocity = FVector::ZeroVector;
+
+	// cm/s
+	float MaxSpeed = 8000.0f;
+
+	// Radians per second the flight path can turn
+	float TurnRate = 1.0f;
+};
+
+USTRUCT()
+struct FDroneHealthFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	float Health = 100.0f;
+	float MaxHealth = 100.0f;
+};
+
+USTRUCT()
+struct FDroneWeaponFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	// Seconds between rounds while on target
+	float FireInterval = 0.5f;
+	float Cooldown = 0.0f;
+
+	// Only fires at targets closer than this
+	float Range = 60000.0f;
+
+	// Cosine of the largest angle off the nose the drone fires at
+	float FireAngleThreshold = 0.98f;
+
+	float MuzzleSpeed = 100000.0f;
+	float Damage = 10.0f;
+};
+
+// Who the drone is after
+USTRUCT()
+struct FDroneTargetFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	uint8 Team = 1;
+
+	// Index into UDroneSwarmSubsystem's target snapshot, INDEX_NONE without a target
+	int32 TargetIndex = INDEX_NONE;
+	float DistanceToTarget = UE_BIG_NUMBER;
+};
+
+// The pawn class a drone stands in for and becomes when promoted, shared by every drone spawned from it
+USTRUCT()
+struct FDroneClassFragment : public FMassConstSharedFragment
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TSubclassOf<AAIAircraftPawn> PawnClass;
+};
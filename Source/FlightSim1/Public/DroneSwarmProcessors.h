@@ -0,0 +1,66 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassProcessor.h"
+#include "MassEntityQuery.h"
+#include "DroneSwarmProcessors.generated.h"
+
+/**
+ * Drone processors. They are not registered with Mass's processing phases; UDroneSwarmSubsystem's tick runs them
+ * one after another: flight, weapons, then representation. The swarm's tick is not ordered against other
+ * subsystems', so the player positions it reads and the drone grid it leaves for UWeaponFireSubsystem can be a
+ * frame old.
+ */
+
+// Picks the nearest hostile, pursues it with lead, avoids terrain and integrates the point mass. Runs in parallel.
+UCLASS()
+class FLIGHTSIM1_API UDroneFlightProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	UDroneFlightProcessor();
+
+protected:
+	virtual void ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager) override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+private:
+	FMassEntityQuery EntityQuery;
+};
+
+// Fires rounds through UWeaponFireSubsystem at targets in range and on the nose. Game thread.
+UCLASS()
+class FLIGHTSIM1_API UDroneWeaponProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	UDroneWeaponProcessor();
+
+protected:
+	virtual void ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager) override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+private:
+	FMassEntityQuery EntityQuery;
+};
+
+// Hands UDroneSwarmSubsystem the instance transforms and grid entries, and the drones to promote or remove. Game thread.
+UCLASS()
+class FLIGHTSIM1_API UDroneRepresentationProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	UDroneRepresentationProcessor();
+
+protected:
+	virtual void ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager) override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+private:
+	FMassEntityQuery EntityQuery;
+};
@@ -0,0 +1,165 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MassEntityTypes.h"
+#include "MassArchetypeTypes.h"
+#include "DroneSwarmSubsystem.generated.h"
+
+class AAIAircraftPawn;
+class UInstancedStaticMeshComponent;
+class UTerrainHeightSubsystem;
+class UDroneFlightProcessor;
+class UDroneWeaponProcessor;
+class UDroneRepresentationProcessor;
+
+// A drone was destroyed without being promoted, e.g. shot down or flown into terrain
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnDroneDestroyed, uint8 /* Team */);
+
+/**
+ * Swarms of lightweight drones for stress scenarios, thousands at a time.
+ *
+ * A drone is a Mass entity with flight, health, weapon and target fragments, not an actor. Every frame the
+ * subsystem runs the drone processors: flight (in parallel), weapons, then representation, which draws every
+ * drone through one instanced static mesh component. A drone that comes within PromotionDistance of a player is
+ * promoted: the entity is destroyed and a full AAIAircraftPawn of the class it was spawned from takes its place,
+ * with the same position, velocity and health. At most MaxPromotionsPerFrame drones are promoted per frame.
+ *
+ * Drones hunt player pawns only. Their positions are bucketed into a uniform grid after every frame's processing,
+ * which UWeaponFireSubsystem checks damaging rounds against through HitDrone. Drones are server side; clients see
+ * them once they are promoted and replicate.
+ */
+UCLASS(Config = Game)
+class FLIGHTSIM1_API UDroneSwarmSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Creates a drone at each location, flying along +X, with the flight, weapon and health tuning of PawnClass's
+	// defaults. PawnClass is also what the drones become when promoted.
+	void SpawnDrones(TSubclassOf<AAIAircraftPawn> PawnClass, TConstArrayView<FVector> Locations, uint8 Team);
+
+	int32 GetNumDrones() const { return NumDrones; }
+
+	// Damages the first drone within DroneHitRadius of the segment from Start to End, as of the last grid rebuild.
+	// Returns whether one was hit.
+	bool HitDrone(const FVector& Start, const FVector& End, float Damage);
+
+	FOnDroneDestroyed OnDroneDestroyed;
+
+	// Tuning is Config, set in the [/Script/FlightSim1.DroneSwarmSubsystem] section of DefaultGame.ini
+
+	// --- Promotion ---
+	// Drones closer than this to a player become full aircraft
+	UPROPERTY(Config, EditAnywhere, Category = "Promotion")
+	float PromotionDistance = 40000.0f;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Promotion", meta = (ClampMin = "1"))
+	int32 MaxPromotionsPerFrame = 4;
+
+	// --- Gunfire ---
+	// Rounds passing closer than this to a drone's origin hit it
+	UPROPERTY(Config, EditAnywhere, Category = "Gunfire")
+	float DroneHitRadius = 600.0f;
+
+	// Edge length of a cell of the drone grid, in cm
+	UPROPERTY(Config, EditAnywhere, Category = "Gunfire")
+	float GridCellSize = 10000.0f;
+
+	// --- Terrain avoidance ---
+	// Seconds ahead along the velocity at which terrain clearance is checked
+	UPROPERTY(Config, EditAnywhere, Category = "Terrain Avoidance")
+	float TerrainLookAheadTime = 2.0f;
+
+	// Drones predicted to come closer than this to the ground climb
+	UPROPERTY(Config, EditAnywhere, Category = "Terrain Avoidance")
+	float MinTerrainClearance = 5000.0f;
+
+	// --- Processor interface ---
+	struct FDroneTarget
+	{
+		TWeakObjectPtr<APawn> Pawn;
+		FVector Location;
+		FVector Velocity;
+		uint8 Team;
+	};
+
+	// Player pawns as of the start of this frame's processing
+	const TArray<FDroneTarget>& GetTargets() const { return Targets; }
+
+	const UTerrainHeightSubsystem* GetTerrain() const { return Terrain; }
+
+private:
+	friend class UDroneRepresentationProcessor;
+
+	struct FDronePromotion
+	{
+		FMassEntityHandle Entity;
+		TSubclassOf<AAIAircraftPawn> PawnClass;
+		FVector Location;
+		FVector Velocity;
+		float Health;
+		float MaxHealth;
+		uint8 Team;
+	};
+
+	struct FDroneLoss
+	{
+		FMassEntityHandle Entity;
+		uint8 Team;
+	};
+
+	void CreateProcessors();
+	void GatherTargets();
+	void PromoteDrones();
+	void DestroyDeadDrones();
+	void UpdateInstances();
+	void RebuildGrid();
+	FIntVector GetCell(const FVector& Location) const;
+
+	UPROPERTY()
+	UTerrainHeightSubsystem* Terrain;
+
+	UPROPERTY()
+	UDroneFlightProcessor* FlightProcessor;
+
+	UPROPERTY()
+	UDroneWeaponProcessor* WeaponProcessor;
+
+	UPROPERTY()
+	UDroneRepresentationProcessor* RepresentationProcessor;
+
+	UPROPERTY()
+	UInstancedStaticMeshComponent* Instances;
+
+	FMassArchetypeHandle Archetype;
+	int32 NumDrones = 0;
+
+	TArray<FDroneTarget> Targets;
+
+	// --- Filled by the representation processor each frame ---
+	TArray<FTransform> InstanceTransforms;
+	TArray<FDronePromotion> Promotions;
+	TArray<FDroneLoss> DeadDrones;
+
+	// Drones that stay in the swarm, struct-of-arrays
+	TArray<FMassEntityHandle> GridEntities;
+	TArray<FVector> GridLocations;
+
+	// --- Grid ---
+	// Drone indices sorted by cell; each cell owns a contiguous range of this array
+	TArray<int32> SortedDrones;
+
+	// Cell -> (first index into SortedDrones, count)
+	TMap<FIntVector, FIntPoint> CellRanges;
+
+	// Scratch storage for the rebuild, kept to avoid reallocating every frame
+	TArray<TPair<FIntVector, int32>> Keyed;
+};
@@ -0,0 +1,52 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "FighterHUDWidget.generated.h"
+
+/**
+ * Native base for the fighter HUD. The pawn pushes its flight data every frame, but the Blueprint events below
+ * only fire when a value changes at display resolution (AirspeedStep, AltitudeStep), so the widget needs no
+ * property bindings and does no work while the readouts are steady.
+ */
+UCLASS(Abstract)
+class FLIGHTSIM1_API UFighterHUDWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	// Airspeed in km/h, altitudes in meters
+	void PushFlightData(float Airspeed, float Altitude, float AltitudeAboveGround, AActor* LockedTarget, int32 MissileAmmo);
+
+protected:
+	UFUNCTION(BlueprintImplementableEvent, Category = "HUD")
+	void OnAirspeedChanged(float Airspeed);
+
+	UFUNCTION(BlueprintImplementableEvent, Category = "HUD")
+	void OnAltitudeChanged(float Altitude, float AltitudeAboveGround);
+
+	UFUNCTION(BlueprintImplementableEvent, Category = "HUD")
+	void OnLockedTargetChanged(AActor* LockedTarget);
+
+	UFUNCTION(BlueprintImplementableEvent, Category = "HUD")
+	void OnMissileAmmoChanged(int32 MissileAmmo);
+
+	// Display resolution of the airspeed readout, km/h
+	UPROPERTY(EditAnywhere, Category = "HUD")
+	float AirspeedStep = 1.0f;
+
+	// Display resolution of the altitude readouts, meters
+	UPROPERTY(EditAnywhere, Category = "HUD")
+	float AltitudeStep = 1.0f;
+
+private:
+	// Last values pushed to Blueprint, already snapped to their step
+	float ShownAirspeed = -1.0f;
+	float ShownAltitude = -1.0f;
+	float ShownAltitudeAboveGround = -1.0f;
+	int32 ShownMissileAmmo = INDEX_NONE;
+	TWeakObjectPtr<AActor> ShownLockedTarget;
+	bool bHasPushed = false;
+};
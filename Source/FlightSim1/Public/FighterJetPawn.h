@@ -4,6 +4,10 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Pawn.h"
+#include "GenericTeamAgentInterface.h"
+#include "FlightModel.h"
+#include "FlightNetTypes.h"
+#include "SensorSubsystem.h"
 #include "FighterJetPawn.generated.h"
 
 // Forward declarations for component classes
@@ -12,26 +16,60 @@ class USpringArmComponent;
 class UCameraComponent;
 class USceneComponent;
 class UHealthComponent;
+class UWeaponComponent;
 class UParticleSystem;
 class USoundBase;
 class UUserWidget;
 class AMissile;
-
+class UAerodynamicProfile;
+class UFighterHUDWidget;
+class SContactMarkerLayer;
+
+/**
+ * Player fighter.
+ *
+ * Standalone, the aircraft is a rigid body in the physics scene pushed by FlightModel forces. In a networked game
+ * it is flown by FlightModel::IntegrateBody with swept moves instead, so that it can be re-simulated:
+ * - the owning client runs each move locally as soon as it is made and sends its quantized input to the server;
+ * - the server runs the same moves and replicates the resulting state with the last move it ran;
+ * - the owner rewinds to that state and replays the moves the server has not seen yet if its prediction was off;
+ * - everyone else interpolates between replicated states, InterpolationDelay behind the server, and extrapolates
+ *   briefly when updates are late.
+ */
 UCLASS()
-class FLIGHTSIM1_API AFighterJetPawn : public APawn
+class FLIGHTSIM1_API AFighterJetPawn : public APawn, public IGenericTeamAgentInterface
 {
 	GENERATED_BODY()
 
 public:
 	AFighterJetPawn();
 
+	// --- IGenericTeamAgentInterface ---
+	virtual void SetGenericTeamId(const FGenericTeamId& NewTeamId) override;
+	virtual FGenericTeamId GetGenericTeamId() const override;
+
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
+	virtual void PostLoad() override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void NotifyControllerChanged() override;
 	virtual void Tick(float DeltaTime) override;
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 
+	// Flies the aircraft from code instead of player input, e.g. for benchmarks. Input bindings are ignored from the first call on.
+	void SetAutopilotInput(float InThrottle, float InPitch, float InRoll, float InYaw, bool bInFireGun, bool bInLaunchMissile);
+
+	float GetThrottle() const { return CurrentThrottle; }
+
+	// --- Network statistics ---
+	// Server: game thread time spent running this aircraft's moves since the last call
+	double ConsumeServerMoveMilliseconds();
+	// Owning client: number of times a server state disagreed with the prediction and moves were replayed
+	int32 GetNumCorrections() const { return NumCorrections; }
+
 	// --- Components ---
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
 	UStaticMeshComponent* AircraftMesh;
@@ -48,6 +86,13 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
 	UHealthComponent* HealthComponent;
 
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+	UWeaponComponent* WeaponComponent;
+
+	// --- Team ---
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Replicated, Category = "Team")
+	uint8 TeamId;
+
 	// --- Flight Physics Properties ---
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Flight|Thrust")
 	float MaxThrust;
@@ -80,6 +125,10 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Flight|Advanced Physics")
 	float CriticalAngleOfAttack;
 
+	// Lift, drag and control effectiveness curves for this aircraft type. When unset, the coefficients above are baked into an equivalent table.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flight|Advanced Physics")
+	UAerodynamicProfile* AerodynamicProfile;
+
 	// --- HUD Variables ---
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "HUD")
 	float Airspeed;
@@ -87,21 +136,21 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "HUD")
 	float Altitude;
 
+	// Height above the terrain in meters, from the terrain height cache where available
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "HUD")
+	float AltitudeAboveGround;
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "HUD")
 	AActor* LockedTarget;
 
 	// --- Weapon Properties ---
+	// Maximum distance at which a target can be locked
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapons")
-	float WeaponRange;
+	float LockRange;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapons")
-	float FireRate;
-
-	UPROPERTY(EditDefaultsOnly, Category = "Weapons")
-	UParticleSystem* MuzzleFlashFX;
-
-	UPROPERTY(EditDefaultsOnly, Category = "Weapons")
-	USoundBase* FireSound;
+	// Radar whose tracks drive lock-on and the contact markers. Only scans on the machine that controls the aircraft.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Sensors")
+	FFlightSensorModel SensorModel;
 
 	UPROPERTY(EditDefaultsOnly, Category = "Weapons")
 	TSubclassOf<AMissile> MissileClass;
@@ -109,9 +158,47 @@ public:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapons")
 	int32 MaxMissileAmmo;
 
-	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = "Weapons")
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Replicated, Category = "Weapons")
 	int32 CurrentMissileAmmo;
 
+	// --- Deprecated Weapon Properties ---
+	// Moved to WeaponComponent. Still loaded so PostLoad can carry values set before the move over to it, and still
+	// visible to Blueprints so graphs that used them warn instead of failing to compile.
+	UPROPERTY(BlueprintReadWrite, Category = "Weapons", meta = (DeprecatedProperty, DeprecationMessage = "Use FireInterval in WeaponComponent's DefaultStats or its Definition."))
+	float FireRate_DEPRECATED;
+
+	UPROPERTY(meta = (DeprecatedProperty, DeprecationMessage = "Set MuzzleFlashFX on WeaponComponent or its Definition."))
+	UParticleSystem* MuzzleFlashFX_DEPRECATED;
+
+	UPROPERTY(meta = (DeprecatedProperty, DeprecationMessage = "Set FireSound on WeaponComponent or its Definition."))
+	USoundBase* FireSound_DEPRECATED;
+
+	// Guns fired hitscan traces this long before rounds were simulated. Nothing reads it.
+	UPROPERTY(BlueprintReadWrite, Category = "Weapons", meta = (DeprecatedProperty, DeprecationMessage = "Guns no longer have a fixed range; rounds fly for UWeaponFireSubsystem's RoundLifetime."))
+	float WeaponRange_DEPRECATED;
+
+	// --- Networking ---
+	// How far behind the server remote aircraft are drawn, so there is usually a newer state to interpolate towards
+	UPROPERTY(EditAnywhere, Category = "Network")
+	float InterpolationDelay;
+
+	// Longest a remote aircraft is extrapolated past its newest state before it holds position
+	UPROPERTY(EditAnywhere, Category = "Network")
+	float MaxExtrapolationTime;
+
+	// Prediction error in cm above which the owning client rewinds and replays
+	UPROPERTY(EditAnywhere, Category = "Network")
+	float CorrectionThreshold;
+
+	// Moves repeated in every input packet, so a lost packet rarely costs the server a move
+	UPROPERTY(EditAnywhere, Category = "Network")
+	int32 InputRedundancy;
+
+	// Move time the server lets a client bank while its packets are delayed. Moves beyond the server time that has
+	// passed plus this are shortened or dropped, so a client cannot fly faster than the clock.
+	UPROPERTY(EditAnywhere, Category = "Network", meta = (ClampMin = "0.0"))
+	float MaxMoveTimeAhead;
+
 protected:
 	// --- Input Handling ---
 	void Throttle(float Value);
@@ -122,14 +209,15 @@ protected:
 
 	void StartFire();
 	void StopFire();
-	void FireWeapon();
 
 	void FireMissile();
 
 	// --- Internal Logic ---
 	void ApplyAerodynamics(float DeltaTime);
+	void EvaluateFlightModel(const FVector& Velocity, const FQuat& Rotation, float InThrottle, float InPitch, float InRoll, float InYaw, FVector& OutForce, FVector& OutAngularAcceleration);
 	void CheckIfOnGround();
 	void UpdateHUDVariables();
+	void UpdateContactMarkers();
 	void UpdateLockedTarget();
 
 	UFUNCTION()
@@ -138,18 +226,98 @@ protected:
 	UFUNCTION()
 	void HandlePawnDeath();
 
+	void CreateHUD();
+
+	// The radar only runs for the pilot's own aircraft; nothing else reads its tracks
+	void UpdateSensorRegistration();
+
+	// --- Networked flight ---
+	void TickNetworkedFlight(float DeltaTime);
+	// Runs one move: ground check, flight model, integration and a swept move of the mesh
+	void StepFlight(const FFlightNetInput& Input);
+	void PublishServerState();
+	void ReconcileWithServer();
+	void InterpolateRemote();
+	void SetBodyTransform(const FFlightBodyState& Body);
+
+	UFUNCTION(Server, Unreliable)
+	void ServerSendInputs(const TArray<FFlightNetInput>& Inputs);
+
+	// The client's lock is sent along, as the server only tracks locks for aircraft it flies locally
+	UFUNCTION(Server, Reliable)
+	void ServerFireMissile(AActor* Target);
+
+	UFUNCTION()
+	void OnRep_ServerState();
+
+	UPROPERTY(ReplicatedUsing = OnRep_ServerState)
+	FFlightNetState ServerState;
+
+	// Set at BeginPlay when the game is not standalone
+	bool bNetworkedFlight;
+	FFlightBodyState FlightBody;
+	float BodyMass;
+
+	// Owning client: moves sent but not yet acknowledged, with the state each one predicted
+	struct FSavedMove
+	{
+		FFlightNetInput Input;
+		FFlightBodyState Result;
+	};
+	TArray<FSavedMove> SavedMoves;
+	// Oldest moves are forgotten past this, e.g. while the server is not answering
+	static constexpr int32 MaxSavedMoves = 128;
+	// Most moves a packet carries; the server ignores any beyond
+	static constexpr int32 MaxInputsPerPacket = 32;
+	TArray<FFlightNetInput> OutgoingInputs;
+	uint16 NextInputSequence;
+	int32 NumCorrections;
+
+	// Server: last move run for the owning client
+	uint16 LastProcessedInput;
+	bool bHasProcessedInput;
+	uint64 ServerMoveCycles;
+	// Server: move time the client may still run, topped up by the server time that passes
+	float ServerMoveTimeBudget;
+	double LastMoveBudgetTime;
+
+	// Remote clients: replicated states, oldest first
+	struct FStateSnapshot
+	{
+		float ServerTime;
+		FFlightBodyState State;
+	};
+	TArray<FStateSnapshot> Snapshots;
+
+	// Single-aircraft batch for the flight model, kept to avoid reallocating every tick
+	FFlightModelBatch FlightModelBatch;
+
+	// Tables baked from the legacy coefficients when no AerodynamicProfile is assigned
+	FAeroTables LegacyAeroTables;
+	const FAeroTables* AeroTables;
+
 	bool bIsFiring;
 	bool bIsOnGround;
+	bool bAutopilot;
 	float CurrentThrottle;
 	float PitchInput, RollInput, YawInput, GroundSteerInput;
 
-	FTimerHandle FireRateTimerHandle;
-
 	// --- UI ---
 	UPROPERTY(EditDefaultsOnly, Category = "UI")
 	TSubclassOf<UUserWidget> HUDWidgetClass;
 
 	UPROPERTY()
 	UUserWidget* HUDWidgetInstance;
+
+	// HUDWidgetInstance when the HUD derives from the native base, which gets its values pushed instead of polled
+	UPROPERTY()
+	UFighterHUDWidget* FighterHUDWidget;
+
+	// Aircraft within this range get a contact box
+	UPROPERTY(EditAnywhere, Category = "UI")
+	float ContactMarkerRange;
+
+	// One native layer draws every contact box, created once the pawn has a local player
+	TSharedPtr<SContactMarkerLayer> ContactMarkerLayer;
 };
 
@@ -0,0 +1,169 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FlightEffectsSubsystem.generated.h"
+
+class UParticleSystem;
+class UParticleSystemComponent;
+class UAudioComponent;
+class USoundBase;
+
+UENUM()
+enum class EFlightEffectCategory : uint8
+{
+	MuzzleFlash,
+	Explosion,
+	Num UMETA(Hidden)
+};
+
+USTRUCT()
+struct FFlightEffectCategorySettings
+{
+	GENERATED_BODY()
+
+	FFlightEffectCategorySettings() {}
+	FFlightEffectCategorySettings(int32 InMaxActive, float InCullDistance, float InRadius, float InMinScreenSize, bool bInCullOffScreen)
+		: MaxActive(InMaxActive), CullDistance(InCullDistance), Radius(InRadius), MinScreenSize(InMinScreenSize), bCullOffScreen(bInCullOffScreen)
+	{
+	}
+
+	// Effects of the category alive at once; requests beyond this are dropped
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0"))
+	int32 MaxActive = 32;
+
+	// Not spawned farther than this from the view
+	UPROPERTY(EditAnywhere)
+	float CullDistance = 200000.0f;
+
+	// Rough size of the effect, for the screen size test
+	UPROPERTY(EditAnywhere)
+	float Radius = 200.0f;
+
+	// Not spawned when Radius would cover less than this fraction of the view
+	UPROPERTY(EditAnywhere)
+	float MinScreenSize = 0.001f;
+
+	// Skip effects outside the view. Off for effects that last long enough to be turned toward.
+	UPROPERTY(EditAnywhere)
+	bool bCullOffScreen = true;
+};
+
+USTRUCT()
+struct FFlightEffectPool
+{
+	GENERATED_BODY()
+
+	// Finished components ready to fire again
+	UPROPERTY()
+	TArray<UParticleSystemComponent*> Free;
+};
+
+/**
+ * Weapon effects and gun audio for the local view.
+ *
+ * Effects are requested during the frame and spawned on the subsystem's tick. Requests that are too far away, too
+ * small on screen or off screen are culled; the rest are spawned biggest on screen first until either their
+ * category's MaxActive or the frame's SpawnBudgetPerFrame runs out, and whatever is left is dropped. Particle
+ * components are pooled per template and go back to the pool when their system finishes, so templates must not loop.
+ *
+ * Guns get one looping sound per shooter, started and stopped with the trigger, instead of a one-shot per round.
+ * Only the MaxLoopingSounds nearest shooters within LoopingSoundCullDistance are audible.
+ *
+ * Does nothing on a dedicated server.
+ */
+UCLASS(Config = Game)
+class FLIGHTSIM1_API UFlightEffectsSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Queues a one-shot effect; it is spawned, or culled, on this frame's tick
+	void SpawnEffect(EFlightEffectCategory Category, UParticleSystem* Template, const FVector& Location, const FRotator& Rotation);
+
+	// Sound must loop. Plays attached to Source until StopLoopingSound.
+	void StartLoopingSound(AActor* Source, USoundBase* Sound);
+	void StopLoopingSound(AActor* Source);
+
+	// Tuning is Config, set in the [/Script/FlightSim1.FlightEffectsSubsystem] section of DefaultGame.ini
+
+	// --- Budgets ---
+	UPROPERTY(Config, EditAnywhere, Category = "Budgets")
+	FFlightEffectCategorySettings MuzzleFlashes = FFlightEffectCategorySettings(24, 150000.0f, 150.0f, 0.002f, true);
+
+	UPROPERTY(Config, EditAnywhere, Category = "Budgets")
+	FFlightEffectCategorySettings Explosions = FFlightEffectCategorySettings(16, 600000.0f, 1500.0f, 0.0005f, false);
+
+	// Particle components activated per frame across all categories
+	UPROPERTY(Config, EditAnywhere, Category = "Budgets", meta = (ClampMin = "0"))
+	int32 SpawnBudgetPerFrame = 8;
+
+	// --- Audio ---
+	UPROPERTY(Config, EditAnywhere, Category = "Audio", meta = (ClampMin = "0"))
+	int32 MaxLoopingSounds = 8;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Audio")
+	float LoopingSoundCullDistance = 200000.0f;
+
+private:
+	struct FEffectRequest
+	{
+		UParticleSystem* Template;
+		FVector Location;
+		FRotator Rotation;
+		EFlightEffectCategory Category;
+		float ScreenSize;
+	};
+
+	struct FLoopingSound
+	{
+		TWeakObjectPtr<UAudioComponent> Audio;
+		bool bWanted = false;
+	};
+
+	struct FLoopCandidate
+	{
+		UAudioComponent* Audio;
+		float DistanceSquared;
+	};
+
+	const FFlightEffectCategorySettings& GetSettings(EFlightEffectCategory Category) const;
+	bool UpdateView();
+	void SpawnPendingEffects();
+	void UpdateLoopingSounds();
+	UParticleSystemComponent* AcquireComponent(UParticleSystem* Template);
+
+	UFUNCTION()
+	void OnEffectFinished(UParticleSystemComponent* Component);
+
+	// Owns the pooled particle components
+	UPROPERTY()
+	AActor* EffectsActor;
+
+	UPROPERTY()
+	TMap<UParticleSystem*, FFlightEffectPool> Pools;
+
+	UPROPERTY()
+	TArray<UParticleSystemComponent*> ActiveEffects;
+	TArray<EFlightEffectCategory> ActiveCategories;
+	int32 ActiveCounts[static_cast<int32>(EFlightEffectCategory::Num)] = {};
+
+	TArray<FEffectRequest> PendingEffects;
+	int32 NumSpawned = 0;
+	int32 NumCulled = 0;
+
+	TMap<TWeakObjectPtr<AActor>, FLoopingSound> LoopingSounds;
+	TArray<FLoopCandidate> LoopCandidates;
+
+	// Local view as of this frame's tick
+	FVector ViewLocation = FVector::ZeroVector;
+	FVector ViewDirection = FVector::ForwardVector;
+	float CosHalfFov = 0.7f;
+	float TanHalfFov = 1.0f;
+};
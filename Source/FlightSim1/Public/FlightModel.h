@@ -0,0 +1,134 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Aerodynamic coefficients for one aircraft type, baked into flat sample arrays.
+ * Lift and drag are indexed by the sine of the angle of attack, which the flight model gets from a dot product,
+ * so a lookup needs no transcendental call. All lookups interpolate linearly between samples.
+ */
+struct FLIGHTSIM1_API FAeroTables
+{
+	// Cl sampled uniformly over sin(alpha) in [-1, 1]
+	TArray<float> Lift;
+
+	// Cd sampled uniformly over sin(alpha) in [-1, 1] (rows) and Mach in [0, MaxMach] (columns), row-major
+	TArray<float> Drag;
+	int32 DragMachSamples = 1;
+	float MaxMach = 0.0f;
+
+	// Control effectiveness sampled uniformly over airspeed in [0, MaxControlSpeed]
+	TArray<float> ControlEffectiveness;
+	float MaxControlSpeed = 1.0f;
+
+	float GetLift(float SinAlpha) const;
+	float GetDrag(float SinAlpha, float Mach) const;
+	float GetControlEffectiveness(float Airspeed) const;
+
+	bool IsValid() const { return Lift.Num() > 1 && Drag.Num() > 1 && ControlEffectiveness.Num() > 1; }
+
+	/**
+	 * Bakes the original hard-coded model: a sine lift curve that drops to zero past the critical angle,
+	 * parasitic plus induced drag with no Mach dependence, and control effectiveness ramping from 0.1 at rest
+	 * to 1 at 5000 cm/s.
+	 */
+	void BuildLegacy(float LiftCoefficient, float DragCoefficient, float InducedDragCoefficient, float CriticalAngleOfAttackDegrees, int32 AlphaSamples = 256);
+};
+
+/**
+ * Aircraft state and tuning for any number of aircraft, stored as struct-of-arrays of floats.
+ * Arrays are padded to a multiple of four so the kernels can always process four aircraft per SIMD register;
+ * padding lanes are zero and produce zero force.
+ *
+ * Engine-independent: no UObjects, no components, world space in, world space out. Units follow the pawns
+ * (cm, cm/s, unreal units of force, degrees for control rates).
+ */
+struct FLIGHTSIM1_API FFlightModelBatch
+{
+	// --- State ---
+	TArray<float> VelX, VelY, VelZ;
+	TArray<float> ForwardX, ForwardY, ForwardZ;
+	TArray<float> RightX, RightY, RightZ;
+	TArray<float> UpX, UpY, UpZ;
+
+	// --- Controls ---
+	// Throttle in [0, 1], control inputs in [-1, 1]
+	TArray<float> Throttle;
+	TArray<float> PitchInput, RollInput, YawInput;
+
+	// 1 to evaluate the aircraft, 0 to output zero force (e.g. while on the ground)
+	TArray<float> Active;
+
+	// --- Tuning ---
+	TArray<float> MaxThrust;
+	// Constant coefficients for EvaluateBasicAerodynamics
+	TArray<float> LiftCoefficient;
+	TArray<float> DragCoefficient;
+	// Control authority per axis. Angular acceleration in deg/s^2 for EvaluateAerodynamics, torque for EvaluateBasicAerodynamics.
+	TArray<float> PitchRate, RollRate, YawRate;
+
+	// Coefficient tables for EvaluateAerodynamics, shared by every aircraft of a type. Not owned.
+	TArray<const FAeroTables*> Tables;
+
+	// --- Output ---
+	TArray<float> ForceX, ForceY, ForceZ;
+	TArray<float> TorqueX, TorqueY, TorqueZ;
+
+	// Resizes every column to hold NewNum aircraft, padding with zeroed lanes
+	void SetNum(int32 NewNum);
+	int32 Num() const { return NumAircraft; }
+
+	// --- Per-aircraft accessors for adapters ---
+	void SetState(int32 Index, const FVector& Velocity, const FVector& Forward, const FVector& Right, const FVector& Up);
+	void SetControls(int32 Index, float InThrottle, float InPitch, float InRoll, float InYaw, bool bInActive);
+	void SetTuning(int32 Index, float InMaxThrust, float InLiftCoefficient, float InDragCoefficient, float InPitchRate, float InRollRate, float InYawRate);
+	void SetTables(int32 Index, const FAeroTables* InTables) { Tables[Index] = InTables; }
+
+	FVector GetForce(int32 Index) const { return FVector(ForceX[Index], ForceY[Index], ForceZ[Index]); }
+	FVector GetTorque(int32 Index) const { return FVector(TorqueX[Index], TorqueY[Index], TorqueZ[Index]); }
+
+private:
+	int32 NumAircraft = 0;
+};
+
+/**
+ * Rigid body state for an aircraft integrated by FlightModel::IntegrateBody instead of the physics scene,
+ * as networked aircraft are so their moves can be replayed.
+ */
+struct FLIGHTSIM1_API FFlightBodyState
+{
+	FVector Location = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+	FVector Velocity = FVector::ZeroVector;
+	// World space, deg/s
+	FVector AngularVelocity = FVector::ZeroVector;
+};
+
+namespace FlightModel
+{
+	// Sea level speed of sound, cm/s
+	constexpr float SpeedOfSound = 34300.0f;
+
+	/**
+	 * Fighter model: lift perpendicular to the flight path and drag opposing it, both from the aircraft's
+	 * FAeroTables; thrust along the nose; control torques scaled by the table's airspeed effectiveness.
+	 * Aircraft without tables produce no force. Torque output is angular acceleration in deg/s^2.
+	 */
+	FLIGHTSIM1_API void EvaluateAerodynamics(FFlightModelBatch& Batch);
+
+	/**
+	 * Basic model: lift along the up vector proportional to speed squared, drag opposing velocity,
+	 * thrust along the nose and control torques with no airspeed dependence. Torque output is in radians.
+	 */
+	FLIGHTSIM1_API void EvaluateBasicAerodynamics(FFlightModelBatch& Batch);
+
+	/**
+	 * One semi-implicit Euler step of a rigid body under a force, an angular acceleration in deg/s^2 (as output by
+	 * EvaluateAerodynamics) and gravity, damped the way the physics scene damps bodies. No collision.
+	 * Deterministic for identical inputs, which is what lets a client replay its moves onto server state.
+	 */
+	FLIGHTSIM1_API void IntegrateBody(FFlightBodyState& State, const FVector& Force, const FVector& AngularAcceleration, float Mass,
+		float LinearDamping, float AngularDamping, float GravityZ, float DeltaTime);
+}
@@ -0,0 +1,52 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FlightNetStatsSubsystem.generated.h"
+
+class UNetConnection;
+
+/**
+ * Network load report for multiplayer tests. Only created when the game is started with -FlightNetStats.
+ *
+ * Every -NetStatsInterval=<seconds> (default 5) logs, and appends to -NetStatsOutput=<file.csv> if given:
+ * - on a server, one row per client connection with bandwidth, packet rate, packet loss, ping and the game thread
+ *   time spent running that client's moves;
+ * - on a client, one row for the server connection with the number of prediction corrections.
+ * Both also report the average game thread time over the interval.
+ *
+ * A local load test, one server and as many clients as wanted on the loopback address, each flown by the
+ * benchmark autopilot:
+ *
+ *   FlightSim1 /Game/FlightLevel?listen -server -log -FlightNetStats -NetStatsOutput=Server.csv
+ *   FlightSim1 127.0.0.1 -game -nullrhi -unattended -FlightSimBenchmark -BenchmarkFrames=100000 -FlightNetStats
+ */
+UCLASS()
+class FLIGHTSIM1_API UFlightNetStatsSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void Report();
+	void ReportConnection(const TCHAR* Role, UNetConnection* Connection, double ServerMoveMilliseconds, int32 Corrections, double AverageGameThreadMilliseconds);
+
+	// --- Settings, from the command line ---
+	float ReportInterval = 5.0f;
+	FString OutputPath;
+
+	// --- Interval state ---
+	float TimeUntilReport = 0.0f;
+	double GameThreadMilliseconds = 0.0;
+	int32 FramesInInterval = 0;
+};
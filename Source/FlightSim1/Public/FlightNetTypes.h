@@ -0,0 +1,115 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FlightModel.h"
+#include "FlightNetTypes.generated.h"
+
+/**
+ * One move of player input, sent from the owning client to the server.
+ * Quantized when it is made rather than when it is sent, so the client predicts with exactly the values
+ * the server will simulate. About 9 bytes on the wire.
+ */
+USTRUCT()
+struct FLIGHTSIM1_API FFlightNetInput
+{
+	GENERATED_BODY()
+
+	// Longest move the server will simulate; longer frames are split into several moves
+	static constexpr float MaxDeltaTime = 0.05f;
+
+	UPROPERTY()
+	uint16 Sequence = 0;
+	// Tenths of a millisecond
+	UPROPERTY()
+	uint16 DeltaTime = 0;
+
+	UPROPERTY()
+	uint8 Throttle = 0;
+
+	UPROPERTY()
+	int8 Pitch = 0;
+
+	UPROPERTY()
+	int8 Roll = 0;
+
+	UPROPERTY()
+	int8 Yaw = 0;
+
+	UPROPERTY()
+	bool bFiring = false;
+
+	void Set(float InDeltaTime, float InThrottle, float InPitch, float InRoll, float InYaw, bool bInFiring);
+
+	float GetDeltaTime() const { return FMath::Min(DeltaTime * 0.0001f, MaxDeltaTime); }
+	float GetThrottle() const { return Throttle / 255.0f; }
+	float GetPitch() const { return Pitch / 127.0f; }
+	float GetRoll() const { return Roll / 127.0f; }
+	float GetYaw() const { return Yaw / 127.0f; }
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FFlightNetInput> : public TStructOpsTypeTraitsBase2<FFlightNetInput>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
+/**
+ * Server-authoritative aircraft state. Position and velocity are packed at 1 cm and 1 cm/s, angular velocity
+ * at 0.1 deg/s and orientation as 16 bits per axis, for roughly 35 bytes per update.
+ *
+ * At most 24 bits per component limits positions to about +-84 km (2^23 cm) from the origin on each axis.
+ * Farther out the packed value is clamped and NetSerialize reports failure. Maps must fit inside that; the
+ * terrain height cache's default MaxHalfExtent of 20 km does.
+ */
+USTRUCT()
+struct FLIGHTSIM1_API FFlightNetState
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector Location = FVector::ZeroVector;
+
+	UPROPERTY()
+	FRotator Rotation = FRotator::ZeroRotator;
+
+	UPROPERTY()
+	FVector Velocity = FVector::ZeroVector;
+
+	UPROPERTY()
+	FVector AngularVelocity = FVector::ZeroVector;
+
+	// Server world time of the state, for interpolation on remote clients
+	UPROPERTY()
+	float ServerTime = 0.0f;
+
+	// Last owning-client move the server has simulated; the owner replays everything after it
+	UPROPERTY()
+	uint16 LastInputSequence = 0;
+
+	UPROPERTY()
+	uint8 Throttle = 0;
+
+	UPROPERTY()
+	bool bFiring = false;
+
+	void FromBody(const FFlightBodyState& Body);
+	FFlightBodyState ToBody() const;
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FFlightNetState> : public TStructOpsTypeTraitsBase2<FFlightNetState>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
@@ -0,0 +1,120 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FlightRecording.h"
+#include "DamageSubsystem.h"
+#include "Engine/StreamableManager.h"
+#include "FlightRecorderSubsystem.generated.h"
+
+class AFlightReplayGhost;
+class UAircraftRegistrySubsystem;
+class UMissileGuidanceSubsystem;
+class UStaticMesh;
+
+/**
+ * Flight recorder for after-action review.
+ *
+ * Recording: every frame the game thread copies each live aircraft's and missile's transform, velocity, throttle
+ * and health into a preallocated frame slot and hands it to an FFlightRecordWriter thread, which quantizes,
+ * delta-compresses and streams it to Saved/FlightRecordings. If the writer falls behind, frames are dropped
+ * rather than stalling the game. Starts with play when bRecordOnBeginPlay is set or -FlightRecord is given, unless
+ * -NoFlightRecorder is.
+ *
+ * Playback: StartPlayback, or -FlightReplay=<file> on the command line, memory-maps a recording and drives
+ * an AFlightReplayGhost per recorded entity. Ghost meshes stream in asynchronously; a ghost is drawn once its
+ * mesh has loaded.
+ */
+UCLASS(Config = Game)
+class FLIGHTSIM1_API UFlightRecorderSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// --- Recording ---
+	bool StartRecording(const FString& Filename);
+	void StopRecording();
+	bool IsRecording() const { return Writer.IsValid(); }
+
+	// --- Playback ---
+	bool StartPlayback(const FString& Filename);
+	void StopPlayback();
+	bool IsPlayingBack() const { return Replay.IsValid(); }
+	void SeekPlayback(float Time);
+
+	// Tuning is Config, set in the [/Script/FlightSim1.FlightRecorderSubsystem] section of DefaultGame.ini
+
+	// Start recording when play begins. Off by default, since recording costs a thread and disk space every session.
+	UPROPERTY(Config, EditAnywhere, Category = "Flight Recorder")
+	bool bRecordOnBeginPlay = false;
+
+	// Frames per compressed block; also the seek granularity
+	UPROPERTY(Config, EditAnywhere, Category = "Flight Recorder")
+	int32 FramesPerBlock = 60;
+
+	// Frames that can wait for the writer thread before capture starts dropping them
+	UPROPERTY(Config, EditAnywhere, Category = "Flight Recorder")
+	int32 FrameSlots = 128;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Flight Recorder")
+	float PlaybackRate = 1.0f;
+
+private:
+	void CaptureFrame();
+	void CaptureActor(AActor* Actor, EFlightRecordKind Kind, uint8 Team, float Throttle, FFlightRecordFrame& Frame);
+	void AdvancePlayback(float DeltaTime);
+	void ApplyPlaybackFrame(const FFlightRecordFrame& Frame);
+	AFlightReplayGhost* FindOrSpawnGhost(uint32 EntityId);
+	// The mesh at Path if it is loaded, otherwise nullptr after starting to load it
+	UStaticMesh* RequestGhostMesh(const FString& Path);
+	void OnGhostMeshLoaded(FString Path);
+
+	UPROPERTY()
+	UAircraftRegistrySubsystem* Registry;
+
+	UPROPERTY()
+	UMissileGuidanceSubsystem* MissileGuidance;
+
+	UPROPERTY()
+	UDamageSubsystem* Damage;
+
+	// --- Recording state ---
+	struct FRecordedActor
+	{
+		uint32 EntityId;
+		FHealthHandle Health;
+	};
+	TMap<TObjectKey<AActor>, FRecordedActor> RecordedActors;
+	TUniquePtr<FFlightRecordWriter> Writer;
+	uint32 NextEntityId = 1;
+	uint32 NextFrameNumber = 0;
+	uint32 DroppedFrames = 0;
+	double RecordingStartTime = 0.0;
+
+	// --- Playback state ---
+	TUniquePtr<FFlightReplayReader> Replay;
+	// Latest frame at or before PlaybackTime, and the one after it
+	FFlightRecordFrame CurrentFrame;
+	FFlightRecordFrame NextFrame;
+	bool bHasNextFrame = false;
+	float PlaybackTime = 0.0f;
+	uint32 PlaybackFrameCounter = 0;
+
+	UPROPERTY()
+	TMap<uint32, AFlightReplayGhost*> Ghosts;
+
+	// Null while the mesh is loading or if it failed to load
+	UPROPERTY()
+	TMap<FString, UStaticMesh*> GhostMeshes;
+
+	TMap<FString, TSharedPtr<FStreamableHandle>> GhostMeshLoads;
+};
@@ -0,0 +1,233 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "Containers/CircularQueue.h"
+#include <atomic>
+
+class IFileHandle;
+class IMappedFileHandle;
+class IMappedFileRegion;
+class FEvent;
+class FRunnableThread;
+
+enum class EFlightRecordKind : uint8
+{
+	Aircraft,
+	Missile
+};
+
+// One entity's state for one frame, as captured on the game thread
+struct FFlightRecordSample
+{
+	uint32 EntityId = 0;
+	FVector3f Location = FVector3f::ZeroVector;
+	FVector3f Velocity = FVector3f::ZeroVector;
+	FRotator3f Rotation = FRotator3f::ZeroRotator;
+	// In [0, 1]
+	float Throttle = 0.0f;
+	float Health = 0.0f;
+};
+
+// What an entity is. Written the first time the entity appears in each block, so every block decodes on its own.
+struct FFlightRecordEntity
+{
+	uint32 EntityId = 0;
+	EFlightRecordKind Kind = EFlightRecordKind::Aircraft;
+	uint8 Team = 0;
+	// Static mesh the playback ghost is drawn with
+	FString MeshPath;
+};
+
+struct FFlightRecordFrame
+{
+	uint32 FrameNumber = 0;
+	// Seconds since recording started
+	float Time = 0.0f;
+	// Entities captured for the first time this frame (recording), or declared by this frame's block (playback)
+	TArray<FFlightRecordEntity> NewEntities;
+	TArray<FFlightRecordSample> Samples;
+
+	void Reset()
+	{
+		NewEntities.Reset();
+		Samples.Reset();
+	}
+};
+
+/**
+ * Recording file format. A file header, then blocks of frames, each block zlib-compressed unless that
+ * does not make it smaller. Blocks decode independently, so playback can seek to any block and a file cut
+ * short by a crash is readable up to its last complete block.
+ *
+ * Inside a block every value is quantized (1 cm position, 4 cm/s velocity, 16-bit angles, 8-bit throttle,
+ * 0.1 health) and stored as the varint residual against a prediction from the entity's previous frames in the
+ * block: constant velocity for position, previous value for the rest. A per-entity bit mask skips zero residuals,
+ * so steady flight costs a few bytes per aircraft per frame before compression.
+ */
+namespace FlightRecording
+{
+	constexpr uint32 Magic = 0x43525346; // "FSRC"
+	constexpr uint32 Version = 1;
+
+	constexpr float PositionStep = 1.0f;
+	constexpr float VelocityStep = 4.0f;
+	constexpr float HealthStep = 0.1f;
+
+	// Location xyz, velocity xyz, pitch yaw roll, throttle, health
+	constexpr int32 NumFields = 11;
+
+	struct FFileHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+	};
+
+	struct FBlockHeader
+	{
+		// Equal to RawSize when the block is stored uncompressed
+		uint32 CompressedSize;
+		uint32 RawSize;
+		uint32 NumFrames;
+		float StartTime;
+		float EndTime;
+	};
+
+	// Quantized values from an entity's last two frames in the current block
+	struct FEntityHistory
+	{
+		int32 Previous[NumFields];
+		int32 BeforePrevious[NumFields];
+		int32 NumFrames = 0;
+	};
+}
+
+class FLIGHTSIM1_API FFlightRecordEncoder
+{
+public:
+	// Forgets every entity's history, so what follows decodes without earlier blocks
+	void BeginBlock() { History.Reset(); }
+
+	// Appends one frame to Out. Samples must be sorted by EntityId; Entities describes every id in the frame.
+	void EncodeFrame(const FFlightRecordFrame& Frame, const TMap<uint32, FFlightRecordEntity>& Entities, TArray<uint8>& Out);
+
+private:
+	TMap<uint32, FlightRecording::FEntityHistory> History;
+	TArray<uint32> Declarations;
+};
+
+class FLIGHTSIM1_API FFlightRecordDecoder
+{
+public:
+	void BeginBlock() { History.Reset(); }
+
+	// Reads one frame and advances Cursor. Returns false if the data is truncated or malformed.
+	bool DecodeFrame(const uint8*& Cursor, const uint8* End, FFlightRecordFrame& OutFrame);
+
+private:
+	TMap<uint32, FlightRecording::FEntityHistory> History;
+};
+
+/**
+ * Background thread that encodes captured frames and streams them to disk.
+ * The game thread takes an empty frame with AcquireFrame, fills it and hands it back with SubmitFrame. The two
+ * threads only meet in two single-producer single-consumer queues of slot indices, so capture never takes a
+ * lock or allocates once the slots have grown to a frame's size.
+ */
+class FLIGHTSIM1_API FFlightRecordWriter : public FRunnable
+{
+public:
+	FFlightRecordWriter(const FString& InFilename, int32 NumFrameSlots, int32 InFramesPerBlock);
+	virtual ~FFlightRecordWriter() override;
+
+	// Opens the file and starts the thread
+	bool Start();
+
+	// Writes every submitted frame, closes the file and joins the thread
+	void Finish();
+
+	// Game thread. Returns nullptr when the writer has fallen behind and every slot is in flight.
+	FFlightRecordFrame* AcquireFrame();
+	void SubmitFrame(FFlightRecordFrame* Frame);
+
+	const FString& GetFilename() const { return Filename; }
+
+	// --- FRunnable ---
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	void WriteFrame(FFlightRecordFrame& Frame);
+	void FlushBlock();
+
+	FString Filename;
+	TUniquePtr<IFileHandle> File;
+
+	TArray<FFlightRecordFrame> Slots;
+	// Slots the game thread may fill, and slots waiting to be written
+	TCircularQueue<int32> FreeSlots;
+	TCircularQueue<int32> FilledSlots;
+
+	FEvent* WorkEvent = nullptr;
+	FRunnableThread* Thread = nullptr;
+	std::atomic<bool> bStopping { false };
+
+	// --- Writer thread only ---
+	FFlightRecordEncoder Encoder;
+	TMap<uint32, FFlightRecordEntity> Entities;
+	TArray<uint8> RawBlock;
+	TArray<uint8> CompressedBlock;
+	int32 FramesPerBlock;
+	int32 FramesInBlock = 0;
+	float BlockStartTime = 0.0f;
+	float BlockEndTime = 0.0f;
+};
+
+/**
+ * Reads a recording through a memory mapping. Uncompressed blocks are decoded in place; compressed blocks are
+ * inflated one at a time into a reused buffer.
+ */
+class FLIGHTSIM1_API FFlightReplayReader
+{
+public:
+	FFlightReplayReader();
+	~FFlightReplayReader();
+
+	bool Open(const FString& Filename);
+	void Close();
+	bool IsOpen() const { return MappedRegion.IsValid(); }
+
+	// Next frame in the file. Returns false at the end.
+	bool ReadFrame(FFlightRecordFrame& OutFrame);
+
+	// Restarts reading at the block containing Time. Frames before Time in that block are still returned.
+	void Seek(float Time);
+
+	float GetDuration() const;
+	int32 GetNumBlocks() const { return Blocks.Num(); }
+	const FFlightRecordEntity* FindEntity(uint32 EntityId) const { return Entities.Find(EntityId); }
+
+private:
+	bool LoadBlock(int32 BlockIndex);
+
+	struct FBlockInfo
+	{
+		int64 PayloadOffset;
+		FlightRecording::FBlockHeader Header;
+	};
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	TArray<FBlockInfo> Blocks;
+
+	int32 CurrentBlock = INDEX_NONE;
+	int32 FramesLeftInBlock = 0;
+	const uint8* Cursor = nullptr;
+	const uint8* BlockEnd = nullptr;
+	TArray<uint8> InflatedBlock;
+
+	FFlightRecordDecoder Decoder;
+	TMap<uint32, FFlightRecordEntity> Entities;
+};
@@ -0,0 +1,48 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "FlightReplayGhost.generated.h"
+
+class UStaticMeshComponent;
+class UStaticMesh;
+
+// Stand-in for a recorded aircraft or missile during playback. Positioned by UFlightRecorderSubsystem; no collision or tick.
+UCLASS()
+class FLIGHTSIM1_API AFlightReplayGhost : public AActor
+{
+	GENERATED_BODY()
+
+	// Writes the replayed state and playback bookkeeping
+	friend class UFlightRecorderSubsystem;
+
+public:
+	AFlightReplayGhost();
+
+	void SetGhostMesh(UStaticMesh* Mesh);
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+	UStaticMeshComponent* GhostMesh;
+
+	// --- Replayed state, for Blueprint effects ---
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = "Replay")
+	uint8 Team;
+
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = "Replay")
+	bool bIsMissile;
+
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = "Replay")
+	FVector ReplayVelocity;
+
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = "Replay")
+	float Throttle;
+
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = "Replay")
+	float Health;
+
+private:
+	// Playback frame the ghost last appeared in; ghosts missing from a frame are hidden
+	uint32 LastSeenFrame;
+};
@@ -0,0 +1,59 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FlightSimProfiling.h"
+#include "FlightSimBenchmarkSubsystem.generated.h"
+
+/**
+ * Headless dogfight benchmark. Only created when the game is started with -FlightSimBenchmark, e.g.
+ *
+ *   FlightSim1 /Game/FlightLevel -game -nullrhi -unattended -benchmark -fps=60 -FlightSimBenchmark
+ *       -BenchmarkEnemies=200 -BenchmarkAllies=0 -BenchmarkFrames=3000 -BenchmarkWarmup=120 -BenchmarkOutput=Results.json
+ *
+ * -BenchmarkDrones=10000 adds a drone swarm wave for stress runs.
+ *
+ * Overrides the game mode's spawn counts, flies the player pawn on a scripted autopilot, records game thread time
+ * and per-system time (FLIGHTSIM_SCOPE) for every measured frame, writes p50/p95/p99 for each to a JSON file
+ * and exits. -benchmark -fps=60 gives a fixed time step so runs are comparable.
+ */
+UCLASS()
+class FLIGHTSIM1_API UFlightSimBenchmarkSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void FlyPlayer(float DeltaTime);
+	void RecordFrame();
+	void WriteResults() const;
+
+	// --- Settings, from the command line ---
+	int32 EnemyCount = INDEX_NONE;
+	int32 AllyCount = INDEX_NONE;
+	int32 DroneCount = INDEX_NONE;
+	int32 WarmupFrames = 120;
+	int32 MeasuredFrames = 3000;
+	FString OutputPath;
+
+	// --- Run state ---
+	int32 FrameCounter = 0;
+	float ElapsedTime = 0.0f;
+	bool bFinished = false;
+
+	// Milliseconds per measured frame
+	TArray<float> GameThreadSamples;
+	TArray<float> TimerSamples[static_cast<int32>(EFlightSimTimer::Num)];
+};
@@ -0,0 +1,117 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+// --- stat FlightSim ---
+DECLARE_STATS_GROUP(TEXT("FlightSim"), STATGROUP_FlightSim, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply Aerodynamics"), STAT_FlightSim_ApplyAerodynamics, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Basic Aerodynamics"), STAT_FlightSim_BasicAerodynamics, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Check If On Ground"), STAT_FlightSim_CheckIfOnGround, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Update HUD"), STAT_FlightSim_UpdateHUD, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Update Contact Markers"), STAT_FlightSim_UpdateContactMarkers, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Update Locked Target"), STAT_FlightSim_UpdateLockedTarget, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Fire Weapon"), STAT_FlightSim_FireWeapon, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Fire Missile"), STAT_FlightSim_FireMissile, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("AI Tick"), STAT_FlightSim_AITick, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("AI Assign Targets"), STAT_FlightSim_AssignTargets, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("AI Decide"), STAT_FlightSim_AIDecide, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("AI Apply"), STAT_FlightSim_AIApply, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Registry Rebuild"), STAT_FlightSim_RegistryRebuild, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Weapon Fire Tick"), STAT_FlightSim_WeaponFireTick, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Step Rounds"), STAT_FlightSim_StepRounds, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Collide Rounds"), STAT_FlightSim_CollideRounds, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Missile Guidance Tick"), STAT_FlightSim_MissileGuidanceTick, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Missile Launch"), STAT_FlightSim_MissileLaunch, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Resolve Damage"), STAT_FlightSim_ResolveDamage, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Spawn Enemies"), STAT_FlightSim_SpawnEnemies, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Record Frame"), STAT_FlightSim_RecordFrame, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Replay Playback"), STAT_FlightSim_ReplayPlayback, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Net Server Move"), STAT_FlightSim_NetServerMove, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Net Reconcile"), STAT_FlightSim_NetReconcile, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Sensor Tick"), STAT_FlightSim_SensorTick, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Drone Swarm Tick"), STAT_FlightSim_DroneSwarmTick, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Effects Tick"), STAT_FlightSim_EffectsTick, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Terrain Bake"), STAT_FlightSim_TerrainBake, STATGROUP_FlightSim, FLIGHTSIM1_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Live Aircraft"), STAT_FlightSim_LiveAircraft, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Drones"), STAT_FlightSim_Drones, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Missiles In Flight"), STAT_FlightSim_MissilesInFlight, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Rounds In Flight"), STAT_FlightSim_RoundsInFlight, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Traces Per Frame"), STAT_FlightSim_TracesPerFrame, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Pending Line Of Sight Checks"), STAT_FlightSim_PendingLineOfSightChecks, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Active Effects"), STAT_FlightSim_ActiveEffects, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Effects Spawned"), STAT_FlightSim_EffectsSpawned, STATGROUP_FlightSim, FLIGHTSIM1_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Effects Culled"), STAT_FlightSim_EffectsCulled, STATGROUP_FlightSim, FLIGHTSIM1_API);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(FLIGHTSIM1_API, FlightSim);
+
+// Gameplay systems that report their own frame time
+enum class EFlightSimTimer : uint8
+{
+	Aerodynamics,
+	AI,
+	Weapons,
+	Missiles,
+	HUD,
+	Sensors,
+	Num
+};
+
+/**
+ * Exclusive per-system game thread time for the current frame.
+ * Scopes nest: entering a scope pauses the enclosing one, so an AI aircraft firing its gun is charged to Weapons
+ * rather than to both Weapons and AI. Collection is off unless a consumer (the benchmark) enables it.
+ * Game thread only.
+ */
+struct FLIGHTSIM1_API FFlightSimFrameTimers
+{
+	static bool bEnabled;
+
+	static void Reset();
+	static double GetMilliseconds(EFlightSimTimer Timer);
+	static const TCHAR* GetName(EFlightSimTimer Timer);
+
+private:
+	friend struct FFlightSimScopeTimer;
+
+	static uint64 Cycles[static_cast<int32>(EFlightSimTimer::Num)];
+	static EFlightSimTimer* ActiveTimer;
+	static uint64 ActiveStart;
+};
+
+struct FLIGHTSIM1_API FFlightSimScopeTimer
+{
+	explicit FFlightSimScopeTimer(EFlightSimTimer InTimer);
+	~FFlightSimScopeTimer();
+
+private:
+	EFlightSimTimer Timer;
+	EFlightSimTimer* Enclosing;
+	bool bActive;
+};
+
+// Cycle stat, Insights CPU event and CSV timing for STAT_FlightSim_<Stat>
+#define FLIGHTSIM_STAT_SCOPE(Stat) \
+	SCOPE_CYCLE_COUNTER(STAT_FlightSim_##Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE(FlightSim_##Stat); \
+	CSV_SCOPED_TIMING_STAT(FlightSim, Stat)
+
+// As FLIGHTSIM_STAT_SCOPE, and charges the scope's exclusive time to a benchmark system
+#define FLIGHTSIM_SCOPE(Timer, Stat) \
+	FFlightSimScopeTimer ANONYMOUS_VARIABLE(FlightSimScope)(EFlightSimTimer::Timer); \
+	FLIGHTSIM_STAT_SCOPE(Stat)
+
+// Per-frame counters, mirrored to stat FlightSim and the CSV profiler
+#define FLIGHTSIM_SET_COUNTER(Stat, Value) \
+	SET_DWORD_STAT(STAT_FlightSim_##Stat, Value); \
+	CSV_CUSTOM_STAT(FlightSim, Stat, static_cast<int32>(Value), ECsvCustomStatOp::Set)
+
+#define FLIGHTSIM_ADD_COUNTER(Stat, Amount) \
+	INC_DWORD_STAT_BY(STAT_FlightSim_##Stat, Amount); \
+	CSV_CUSTOM_STAT(FlightSim, Stat, static_cast<int32>(Amount), ECsvCustomStatOp::Accumulate)
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "DamageSubsystem.h"
 #include "HealthComponent.generated.h"
 
 // Delegate for broadcasting a message when the actor's health changes
@@ -17,25 +18,50 @@ class FLIGHTSIM1_API UHealthComponent : public UActorComponent
 {
 	GENERATED_BODY()
 
+	// Applies resolved damage and runs the death sequence
+	friend class UDamageSubsystem;
+
 public:
 	UHealthComponent();
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+public:
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
+protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Health")
 	float MaxHealth;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Health")
+	// Damage is resolved on the server; clients get the result and the same events
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, ReplicatedUsing = OnRep_CurrentHealth, Category = "Health")
 	float CurrentHealth;
 
+	UFUNCTION()
+	void OnRep_CurrentHealth(float OldHealth);
+
 	UFUNCTION()
 	void Die();
 
+	// Subtracts a frame's summed damage and broadcasts OnHealthChanged once
+	void ApplyResolvedDamage(float TotalDamage);
+
+	// Slot in the damage subsystem's health table
+	FHealthHandle HealthHandle;
+
 public:
+	// Queues damage with the damage subsystem; it is applied with the rest of the frame's damage. Server only.
 	UFUNCTION(BlueprintCallable, Category = "Health")
 	void TakeDamage(float Damage);
 
+	// Sets health outright, without the damage queue or OnHealthChanged, for an aircraft taking over another's
+	// state such as a promoted drone. Server only, after BeginPlay.
+	void SetCurrentHealth(float NewHealth);
+
+	FHealthHandle GetHealthHandle() const { return HealthHandle; }
+
 	UFUNCTION(BlueprintPure, Category = "Health")
 	bool IsDead() const;
 
@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "MissileGuidance.h"
+#include "Engine/NetSerialization.h"
 #include "Missile.generated.h"
 
 class UStaticMeshComponent;
@@ -16,12 +18,20 @@ class FLIGHTSIM1_API AMissile : public AActor
 {
 	GENERATED_BODY()
 
+	// Guidance is batched by the subsystem instead of ticking per missile
+	friend class UMissileGuidanceSubsystem;
+
 public:
 	AMissile();
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+public:
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
+protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
 	UStaticMeshComponent* MissileMesh;
 
@@ -37,15 +47,61 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = "Damage")
 	UParticleSystem* ExplosionEffect;
 
+	// Missiles that miss are returned to the pool after this many seconds
+	UPROPERTY(EditDefaultsOnly, Category = "Flight")
+	float MaxFlightTime;
+
+	// --- Guidance ---
+	// Proportional navigation gain
+	UPROPERTY(EditDefaultsOnly, Category = "Guidance")
+	float NavigationConstant;
+
+	// Limit on turning acceleration, cm/s^2
+	UPROPERTY(EditDefaultsOnly, Category = "Guidance")
+	float MaxLateralAcceleration;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Guidance|Motor")
+	float MotorBurnTime;
+
+	// Acceleration along the flight path while the motor burns, cm/s^2
+	UPROPERTY(EditDefaultsOnly, Category = "Guidance|Motor")
+	float MotorAcceleration;
+
+	// Drag deceleration is AirDragCoefficient * speed^2
+	UPROPERTY(EditDefaultsOnly, Category = "Guidance|Motor")
+	float AirDragCoefficient;
+
 	UFUNCTION()
 	void OnMissileHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
 
 	UPROPERTY()
 	AActor* TargetActor;
 
-public:
-	virtual void Tick(float DeltaTime) override;
+	// Missiles fly and hit on the server; clients get the movement and this, which drives the trail
+	UPROPERTY(ReplicatedUsing = OnRep_InFlight)
+	bool bInFlight;
+
+	UFUNCTION()
+	void OnRep_InFlight();
+
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastExplode(FVector_NetQuantize Location);
+
+	// Slot in UMissileGuidanceSubsystem while in flight
+	int32 GuidanceIndex;
 
+public:
 	void SetTarget(AActor* NewTarget);
+
+	FMissileGuidanceBatch::FMissileParams GetGuidanceParams() const;
+
+	// --- Pooling, driven by UMissilePoolSubsystem ---
+	// Moves the missile into place and resets its movement, trail and target
+	void LaunchFromPool(const FVector& Location, const FRotator& Rotation, AActor* NewTarget);
+
+	// Hides the missile and stops all movement, effects, collision and ticking
+	void DeactivateForPool();
+
+	bool IsInFlight() const { return bInFlight; }
 };
 
@@ -0,0 +1,74 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Every missile in flight, stored as struct-of-arrays of plain floats so the guidance step is one
+ * branch-free loop the compiler can vectorize. Has no UObject dependencies and can be stepped headless.
+ * Units are cm, seconds, cm/s and cm/s^2.
+ */
+struct FLIGHTSIM1_API FMissileGuidanceBatch
+{
+	// --- Kinematic state ---
+	TArray<float> PosX, PosY, PosZ;
+	TArray<float> VelX, VelY, VelZ;
+
+	// --- Target state, written by the caller before each step ---
+	TArray<float> TargetPosX, TargetPosY, TargetPosZ;
+	TArray<float> TargetVelX, TargetVelY, TargetVelZ;
+
+	// 1 when the missile has a target to guide on, 0 for ballistic flight
+	TArray<float> HasTarget;
+
+	// Seconds since launch
+	TArray<float> FlightTime;
+
+	// --- Per-missile tuning ---
+	// Proportional navigation gain, typically 3-5
+	TArray<float> NavigationConstant;
+	// Limit on commanded acceleration perpendicular to the flight path
+	TArray<float> MaxLateralAcceleration;
+	// Seconds the motor burns after launch
+	TArray<float> MotorBurnTime;
+	// Acceleration along the flight path while the motor burns
+	TArray<float> MotorAcceleration;
+	// Drag deceleration is DragCoefficient * speed^2
+	TArray<float> DragCoefficient;
+	TArray<float> MaxSpeed;
+
+	int32 Num() const { return PosX.Num(); }
+
+	struct FMissileParams
+	{
+		float NavigationConstant = 4.0f;
+		float MaxLateralAcceleration = 30000.0f;
+		float MotorBurnTime = 3.0f;
+		float MotorAcceleration = 15000.0f;
+		float DragCoefficient = 0.00002f;
+		float MaxSpeed = 20000.0f;
+	};
+
+	int32 Add(const FVector& Position, const FVector& Velocity, const FMissileParams& Params);
+	void RemoveAtSwap(int32 Index);
+
+	void SetState(int32 Index, const FVector& Position, const FVector& Velocity);
+	void SetTarget(int32 Index, const FVector& Position, const FVector& Velocity);
+	void ClearTarget(int32 Index);
+
+	FVector GetPosition(int32 Index) const { return FVector(PosX[Index], PosY[Index], PosZ[Index]); }
+	FVector GetVelocity(int32 Index) const { return FVector(VelX[Index], VelY[Index], VelZ[Index]); }
+};
+
+namespace MissileGuidance
+{
+	/**
+	 * Advances every missile in the batch by DeltaTime.
+	 * Guidance is pure proportional navigation: the commanded acceleration is N * (LOS rate x missile velocity),
+	 * clamped to MaxLateralAcceleration. Speed follows a burn/coast energy model: motor acceleration along the
+	 * flight path until MotorBurnTime, quadratic drag throughout, and a hard cap at MaxSpeed.
+	 * Deterministic for a given input, so it can be unit-tested and replayed outside the engine.
+	 */
+	FLIGHTSIM1_API void Step(FMissileGuidanceBatch& Batch, float DeltaTime);
+}
@@ -0,0 +1,45 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MissileGuidance.h"
+#include "MissileGuidanceSubsystem.generated.h"
+
+class AMissile;
+
+/**
+ * Guides every missile in flight with one batched MissileGuidance::Step per frame.
+ * Missiles join on launch and leave when they return to the pool; they do not tick.
+ * The subsystem gathers missile and target state, steps the batch, and writes the new velocity back
+ * to each missile's ProjectileMovement, which still does the swept move and raises hits.
+ */
+UCLASS()
+class FLIGHTSIM1_API UMissileGuidanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterMissile(AMissile* Missile, AActor* Target);
+	void UnregisterMissile(AMissile* Missile);
+
+	int32 GetNumMissilesInFlight() const { return Missiles.Num(); }
+	AMissile* GetMissile(int32 Index) const { return Missiles[Index]; }
+
+private:
+	UPROPERTY()
+	TArray<AMissile*> Missiles;
+
+	TArray<TWeakObjectPtr<AActor>> Targets;
+	TArray<float> MaxFlightTimes;
+
+	FMissileGuidanceBatch Batch;
+
+	// Scratch list of missiles that ran out of flight time this frame
+	TArray<AMissile*> ExpiredMissiles;
+};
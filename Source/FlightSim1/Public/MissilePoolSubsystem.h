@@ -0,0 +1,48 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MissilePoolSubsystem.generated.h"
+
+class AMissile;
+
+USTRUCT()
+struct FMissilePool
+{
+	GENERATED_BODY()
+
+	// Dormant missiles ready to launch
+	UPROPERTY()
+	TArray<AMissile*> Free;
+};
+
+/**
+ * Keeps dormant missile actors around so launches reuse an existing actor instead of spawning one.
+ * Pools are keyed by missile class and pre-warmed at match start by whoever carries that missile.
+ * Missiles return themselves to the pool on impact or when they run out of flight time.
+ */
+UCLASS()
+class FLIGHTSIM1_API UMissilePoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	// Makes sure at least Count dormant missiles of MissileClass exist
+	void Prewarm(TSubclassOf<AMissile> MissileClass, int32 Count);
+
+	// Launches a pooled missile. Only spawns a new actor when the pool is empty.
+	AMissile* Launch(TSubclassOf<AMissile> MissileClass, const FVector& Location, const FRotator& Rotation, AActor* Target, APawn* InstigatorPawn);
+
+	// Deactivates the missile in place and makes it available again
+	void Release(AMissile* Missile);
+
+private:
+	AMissile* SpawnDormant(TSubclassOf<AMissile> MissileClass);
+
+	UPROPERTY()
+	TMap<UClass*, FMissilePool> Pools;
+};
@@ -0,0 +1,47 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SLeafWidget.h"
+
+// One on-screen contact box
+struct FContactMarker
+{
+	// Viewport position in pixels
+	FVector2f ScreenPosition;
+	FLinearColor Color;
+	// Half the box size in pixels
+	float HalfSize;
+};
+
+/**
+ * Full-viewport overlay that draws every contact box in a single OnPaint, instead of one widget per marker.
+ * Owners refill the marker list and call MarkersChanged; nothing is repainted while the list is unchanged.
+ */
+class FLIGHTSIM1_API SContactMarkerLayer : public SLeafWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SContactMarkerLayer)
+		: _LineThickness(1.5f)
+	{}
+		SLATE_ARGUMENT(float, LineThickness)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+
+	// Filled by the owner, then published with MarkersChanged
+	TArray<FContactMarker>& GetMutableMarkers() { return Markers; }
+	void MarkersChanged();
+
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect,
+		FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+	virtual FVector2D ComputeDesiredSize(float LayoutScaleMultiplier) const override;
+
+private:
+	TArray<FContactMarker> Markers;
+	float LineThickness = 1.5f;
+
+	// Scratch outline, reused for every marker
+	mutable TArray<FVector2f> Outline;
+};
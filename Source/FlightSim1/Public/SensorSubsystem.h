@@ -0,0 +1,185 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "SensorSubsystem.generated.h"
+
+class APawn;
+class UAircraftRegistrySubsystem;
+
+// Volume an aircraft's sensor covers and how fast it searches it
+USTRUCT(BlueprintType)
+struct FFlightSensorModel
+{
+	GENERATED_BODY()
+
+	// Detection range, cm
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Sensor")
+	float Range = 300000.0f;
+
+	// Degrees either side of the nose
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Sensor")
+	float AzimuthHalfAngle = 60.0f;
+
+	// Degrees above and below the nose
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Sensor")
+	float ElevationHalfAngle = 30.0f;
+
+	// Degrees of azimuth the beam sweeps per second. 0 is a staring sensor, such as IR, that sees its whole volume at once.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Sensor")
+	float ScanRate = 120.0f;
+};
+
+// One contact in an aircraft's track file
+struct FSensorTrack
+{
+	TWeakObjectPtr<APawn> Target;
+	uint8 Team = 0;
+
+	// Filtered estimate as of UpdateTime
+	FVector Location = FVector::ZeroVector;
+	FVector Velocity = FVector::ZeroVector;
+	double UpdateTime = 0.0;
+
+	// When a trace last found the line of sight clear
+	double LineOfSightTime = -UE_BIG_NUMBER;
+
+	// Measurements taken; 0 while the first line-of-sight check is pending
+	int32 NumUpdates = 0;
+	bool bLineOfSightPending = false;
+
+	// Seen at least once
+	bool IsValid() const { return NumUpdates > 0; }
+
+	// Seen often enough for the velocity estimate to mean something
+	bool IsEstablished() const { return NumUpdates >= 2; }
+
+	FVector PredictLocation(double Time) const { return Location + Velocity * (Time - UpdateTime); }
+};
+
+/**
+ * Sensors and track files for every aircraft that registers one.
+ *
+ * Each sensor searches its volume with a beam that sweeps ScanRate degrees of azimuth per second. Sensors are
+ * serviced round-robin, at most MaxScansPerFrame a frame, and each scan covers the sector swept since that
+ * sensor's last one, so under load sensors scan less often in larger steps rather than the frame stretching.
+ *
+ * Aircraft in the swept sector are only detected once an async trace against static geometry finds the line of
+ * sight clear. Traces go out at most LineOfSightTracesPerFrame a frame from a bounded queue, and a clear result is
+ * reused for LineOfSightReuseTime. Detections update the aircraft's track on the target with an alpha-beta
+ * filter; tracks coast on their velocity between updates and are dropped after TrackTimeout without one.
+ */
+UCLASS(Config = Game)
+class FLIGHTSIM1_API USensorSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterSensor(APawn* Owner, const FFlightSensorModel& Model);
+	void UnregisterSensor(APawn* Owner);
+
+	// The owner's track file, or nullptr if it has no sensor. Includes tracks that are not valid yet.
+	const TArray<FSensorTrack>* FindTracks(const APawn* Owner) const;
+
+	// The owner's valid track on Target, or nullptr
+	const FSensorTrack* FindTrack(const APawn* Owner, const APawn* Target) const;
+
+	// Current estimated location of Target as tracked by Owner. False if Owner has no valid track on it.
+	bool GetTrackedLocation(const APawn* Owner, const APawn* Target, FVector& OutLocation) const;
+
+	double GetTime() const;
+
+	// Tuning is Config, set in the [/Script/FlightSim1.SensorSubsystem] section of DefaultGame.ini
+
+	// --- Budgets ---
+	UPROPERTY(Config, EditAnywhere, Category = "Sensors")
+	int32 MaxScansPerFrame = 64;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Sensors")
+	int32 LineOfSightTracesPerFrame = 48;
+
+	// Detections beyond this many waiting traces are dropped and picked up again on a later scan
+	UPROPERTY(Config, EditAnywhere, Category = "Sensors")
+	int32 MaxPendingLineOfSightChecks = 1024;
+
+	// Seconds a clear line of sight is trusted before the pair is traced again. Longer than a radar frame, so a
+	// target held in the beam is traced about once per reuse period rather than once per sweep.
+	UPROPERTY(Config, EditAnywhere, Category = "Sensors")
+	float LineOfSightReuseTime = 1.5f;
+
+	// --- Tracking ---
+	// Share of the position residual taken into the estimate per update
+	UPROPERTY(Config, EditAnywhere, Category = "Tracking")
+	float TrackAlpha = 0.6f;
+
+	// Share of the residual over the update interval taken into the velocity estimate
+	UPROPERTY(Config, EditAnywhere, Category = "Tracking")
+	float TrackBeta = 0.3f;
+
+	// Seconds without a detection before a track is dropped
+	UPROPERTY(Config, EditAnywhere, Category = "Tracking")
+	float TrackTimeout = 3.0f;
+
+private:
+	void Scan(int32 Index, float ElapsedTime);
+	void Detect(int32 Index, APawn* Target, uint8 Team, const FVector& Origin, const FVector& Location, double Time);
+	void UpdateTrack(FSensorTrack& Track, const FVector& MeasuredLocation, double Time) const;
+	FSensorTrack* FindMutableTrack(int32 Index, const APawn* Target);
+	void SubmitLineOfSightChecks();
+	void ApplyLineOfSightResults();
+	void OnLineOfSightTraceComplete(const FTraceHandle& Handle, FTraceDatum& Data);
+
+	UPROPERTY()
+	UAircraftRegistrySubsystem* Registry;
+
+	// --- Sensors, struct-of-arrays ---
+	UPROPERTY()
+	TArray<APawn*> Owners;
+
+	TArray<FFlightSensorModel> Models;
+	// Beam position in degrees from the left edge of the volume
+	TArray<float> ScanPositions;
+	// Time since the sensor was last scanned
+	TArray<float> PendingScanTime;
+	TArray<TArray<FSensorTrack>> TrackFiles;
+
+	TMap<TObjectKey<APawn>, int32> SensorLookup;
+	int32 NextSensorToScan = 0;
+
+	// --- Line of sight ---
+	struct FLineOfSightCheck
+	{
+		TWeakObjectPtr<APawn> Owner;
+		TWeakObjectPtr<APawn> Target;
+		FVector Start;
+		FVector End;
+		double Time;
+	};
+
+	struct FLineOfSightResult
+	{
+		int32 CheckIndex;
+		bool bClear;
+	};
+
+	// Detections waiting for a trace, oldest first, and the next one to send
+	TArray<FLineOfSightCheck> QueuedChecks;
+	int32 FirstQueuedCheck = 0;
+
+	// Checks whose traces are in flight, indexed by the trace's UserData
+	TSparseArray<FLineOfSightCheck> InFlightChecks;
+	TArray<FLineOfSightResult> CompletedChecks;
+
+	FTraceDelegate LineOfSightDelegate;
+
+	// Scratch buffer for registry queries
+	TArray<int32> ScanCandidates;
+};
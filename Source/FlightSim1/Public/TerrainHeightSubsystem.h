@@ -0,0 +1,97 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TerrainHeightSubsystem.generated.h"
+
+/**
+ * Cached ground height for the whole level, so aircraft can get their height above ground without tracing.
+ * On world begin play the subsystem lays a regular grid over the level's static actors. It then traces straight
+ * down against WorldStatic geometry (landscape, runways) at each sample, spread over as many frames as
+ * BakeBudgetMilliseconds allows, and stores the heights quantized to 16 bits in TileSize x TileSize tiles so a
+ * bilinear lookup touches one or two cache lines.
+ *
+ * Until the bake finishes every query behaves as outside the sampled area. The cache is only as detailed as
+ * SampleSpacing. Callers that need precision near the ground, such as touchdown checks, should trace for real
+ * when IsNearGround says so.
+ */
+UCLASS(Config = Game)
+class FLIGHTSIM1_API UTerrainHeightSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Ground height under X/Y from the cache. False outside the sampled area or before the cache is built.
+	bool GetGroundHeight(double X, double Y, float& OutGroundZ) const;
+
+	// Height above the cached ground. False where GetGroundHeight would be.
+	bool GetHeightAboveGround(const FVector& Location, float& OutHeight) const;
+
+	// True inside the near-ground band or where the cache has no data, i.e. whenever a real trace is needed
+	bool IsNearGround(const FVector& Location) const;
+
+	bool HasHeightField() const { return Tiles.Num() > 0; }
+	bool IsBaking() const { return BakeHeights.Num() > 0; }
+
+	// Tuning is Config, set in the [/Script/FlightSim1.TerrainHeightSubsystem] section of DefaultGame.ini
+
+	// --- Grid settings ---
+	// Distance between height samples
+	UPROPERTY(Config, EditAnywhere, Category = "Terrain")
+	float SampleSpacing = 5000.0f;
+
+	// Upper bound on samples along each axis; SampleSpacing grows for larger levels
+	UPROPERTY(Config, EditAnywhere, Category = "Terrain")
+	int32 MaxSamplesPerAxis = 1024;
+
+	// Upper bound on the sampled area's half size, so a sky sphere does not stretch the grid
+	UPROPERTY(Config, EditAnywhere, Category = "Terrain")
+	float MaxHalfExtent = 2000000.0f;
+
+	// Below this height above the cached ground, callers should trace instead of trusting the cache
+	UPROPERTY(Config, EditAnywhere, Category = "Terrain")
+	float NearGroundBand = 3000.0f;
+
+	// Game thread time the bake may spend tracing each frame
+	UPROPERTY(Config, EditAnywhere, Category = "Terrain", meta = (ClampMin = "0.1"))
+	float BakeBudgetMilliseconds = 2.0f;
+
+private:
+	static constexpr int32 TileSize = 16;
+
+	void BeginBake(UWorld& World);
+	void TraceSamples(double EndTime);
+	void FinishBake();
+	uint16 GetSample(int32 SampleX, int32 SampleY) const;
+
+	// Tiles are stored one after another, samples inside a tile row-major
+	TArray<uint16> Tiles;
+	int32 NumTilesX = 0;
+	int32 NumSamplesX = 0;
+	int32 NumSamplesY = 0;
+
+	FVector2D Origin = FVector2D::ZeroVector;
+	float Spacing = 0.0f;
+	float InvSpacing = 0.0f;
+
+	// Dequantization: Z = MinHeight + Sample * HeightStep
+	float MinHeight = 0.0f;
+	float HeightStep = 0.0f;
+
+	// --- Bake in progress ---
+	// Traced heights, row-major, empty once the bake is done
+	TArray<float> BakeHeights;
+	int32 NextBakeSample = 0;
+	double TraceTop = 0.0;
+	double TraceBottom = 0.0;
+	float BakeMinHeight = 0.0f;
+	float BakeMaxHeight = 0.0f;
+	double BakeStartTime = 0.0;
+};
@@ -0,0 +1,86 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "WeaponDefinition.h"
+#include "WeaponComponent.generated.h"
+
+class USceneComponent;
+
+/**
+ * A gun, shared by the player's fighter and AI aircraft.
+ *
+ * The component uses no timers and, apart from the replicas below, does not tick. Its owner advances it with
+ * UpdateWeapon from its own update, and the time until the next round is kept as an accumulator. An update that
+ * spans several fire intervals fires every round that fell due, up to MaxRoundsPerUpdate. Each of those rounds
+ * starts as far down range as it would have travelled since it was due, and the stretch from the muzzle is still
+ * checked for hits. Rounds fly as data in UWeaponFireSubsystem; the muzzle flash and looping gun sound go through
+ * UFlightEffectsSubsystem.
+ *
+ * The trigger replicates to everyone but the owning client, who already knows it. An owner that only runs its
+ * update with authority, like AI aircraft, sets bUpdateOnSimulatedProxy. Its replicas then tick the weapon
+ * themselves while the trigger is held, so clients see and hear the gun fire zero-damage tracers.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class FLIGHTSIM1_API UWeaponComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UWeaponComponent();
+
+protected:
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+public:
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	// Gun type; DefaultStats are used without one
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon")
+	UWeaponDefinition* Definition;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon")
+	FWeaponStats DefaultStats;
+
+	// Replicas advance the weapon from their own tick, for owners that have no update off the server
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon")
+	bool bUpdateOnSimulatedProxy;
+
+	const FWeaponStats& GetStats() const { return Definition ? Definition->Stats : DefaultStats; }
+
+	// Where rounds leave from, the owner's root when unset
+	void SetMuzzle(USceneComponent* InMuzzle) { Muzzle = InMuzzle; }
+
+	void SetTriggerHeld(bool bHeld);
+	bool IsTriggerHeld() const { return bTriggerHeld; }
+
+	// Muzzle flash and gun sound; rounds are fired either way
+	void SetEffectsEnabled(bool bEnabled);
+
+	// Advances the cooldown by DeltaTime and fires the rounds that fell due while the trigger is held
+	void UpdateWeapon(float DeltaTime);
+
+private:
+	void FireRound(const FWeaponStats& Stats, float Age);
+	void UpdateLoopingSound();
+
+	UFUNCTION()
+	void OnRep_TriggerHeld();
+
+	UPROPERTY()
+	USceneComponent* Muzzle;
+
+	// Seconds until the next round may fire. Keeps running down while the trigger is released, so tapping the
+	// trigger is no faster than holding it.
+	float Cooldown;
+
+	UPROPERTY(ReplicatedUsing = OnRep_TriggerHeld)
+	bool bTriggerHeld;
+
+	// Trigger state as of the last update, to tell a fresh press from a held trigger
+	bool bWasTriggerHeld;
+	bool bEffectsEnabled;
+};
@@ -0,0 +1,56 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "WeaponDefinition.generated.h"
+
+class UParticleSystem;
+class USoundBase;
+
+// Tuning for one gun
+USTRUCT(BlueprintType)
+struct FWeaponStats
+{
+	GENERATED_BODY()
+
+	// Seconds between rounds while the trigger is held
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon", meta = (ClampMin = "0.01"))
+	float FireInterval = 0.1f;
+
+	// Speed of a round leaving the barrel, added to the aircraft's own velocity, cm/s
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon")
+	float MuzzleSpeed = 100000.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon")
+	float Damage = 10.0f;
+
+	// Cosine of the largest angle off the nose AI pilots fire at
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon")
+	float FireAngleThreshold = 0.98f;
+
+	// Most rounds one update may fire when it covers several intervals; the rest are dropped
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon", meta = (ClampMin = "1"))
+	int32 MaxRoundsPerUpdate = 4;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Effects")
+	UParticleSystem* MuzzleFlashFX = nullptr;
+
+	// Looping, played while the trigger is held
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Effects")
+	USoundBase* FireSound = nullptr;
+};
+
+/**
+ * A gun type, shared by every UWeaponComponent that fires it.
+ */
+UCLASS(BlueprintType)
+class FLIGHTSIM1_API UWeaponDefinition : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon", meta = (ShowOnlyInnerProperties))
+	FWeaponStats Stats;
+};
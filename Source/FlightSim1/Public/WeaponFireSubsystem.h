@@ -0,0 +1,148 @@
+// Copyright Your Company Name, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Containers/SparseArray.h"
+#include "WorldCollision.h"
+#include "Engine/StreamableManager.h"
+#include "WeaponFireSubsystem.generated.h"
+
+class AActor;
+class UInstancedStaticMeshComponent;
+class UStaticMesh;
+class UAircraftRegistrySubsystem;
+class UTerrainHeightSubsystem;
+class UDroneSwarmSubsystem;
+
+/**
+ * Ballistic simulation of every gun round in flight. Rounds are plain data, not actors.
+ *
+ * Rounds are stored as struct-of-arrays, padded to a multiple of four, and advanced four at a time with vector
+ * math under gravity and quadratic drag. After each step every round is checked along the segment it just
+ * flew: against the cached terrain height, against the drone swarm's grid, and, when the aircraft registry has
+ * an aircraft near the segment, with an async line trace on the Gunfire channel. The traces go out in one batch
+ * per frame and their hits are applied on the next frame, so no gun trace runs synchronously on the game thread.
+ *
+ * Positions are single precision, which is good to about 2 mm at 20 km from the origin.
+ * Every round is drawn as a tracer through one instanced static mesh component.
+ */
+UCLASS(Config = Game)
+class FLIGHTSIM1_API UWeaponFireSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Puts a round in flight at Location. A round fired late may start down range of the Muzzle it left; the stretch
+	// between them is checked as well. Damage is applied to the first aircraft it hits; rounds with no damage, such
+	// as a client's cosmetic rounds, never query collision against aircraft.
+	void FireRound(AActor* Shooter, const FVector& Muzzle, const FVector& Location, const FVector& Velocity, float Damage);
+
+	int32 GetNumRounds() const { return NumRounds; }
+
+	// Tuning is Config, set in the [/Script/FlightSim1.WeaponFireSubsystem] section of DefaultGame.ini
+
+	// --- Ballistics ---
+	// Seconds a round flies before it is removed
+	UPROPERTY(Config, EditAnywhere, Category = "Ballistics")
+	float RoundLifetime = 4.0f;
+
+	// Drag deceleration is DragFactor * speed^2, in 1/cm. The default takes a 20 mm round from 1000 m/s to about
+	// 600 m/s in two seconds.
+	UPROPERTY(Config, EditAnywhere, Category = "Ballistics")
+	float DragFactor = 3.5e-6f;
+
+	// New rounds are dropped beyond this many in flight
+	UPROPERTY(Config, EditAnywhere, Category = "Ballistics")
+	int32 MaxRounds = 8192;
+
+	// Segments passing further than this from every aircraft's origin are not traced
+	UPROPERTY(Config, EditAnywhere, Category = "Ballistics")
+	float AircraftProximity = 2500.0f;
+
+	// --- Tracers ---
+	UPROPERTY(Config, EditAnywhere, Category = "Tracers")
+	TSoftObjectPtr<UStaticMesh> TracerMesh = TSoftObjectPtr<UStaticMesh>(FSoftObjectPath(TEXT("/Engine/BasicShapes/Cylinder.Cylinder")));
+
+	// Tracer length and width in cm. The mesh is scaled from a 100 cm unit shape along its Z axis.
+	UPROPERTY(Config, EditAnywhere, Category = "Tracers")
+	float TracerLength = 3000.0f;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Tracers")
+	float TracerWidth = 20.0f;
+
+private:
+	struct FRoundTrace
+	{
+		uint32 Serial;
+		TWeakObjectPtr<AActor> Shooter;
+		float Damage;
+	};
+
+	struct FRoundHit
+	{
+		int32 TraceIndex;
+		TWeakObjectPtr<AActor> HitActor;
+	};
+
+	void StepRounds(float DeltaTime);
+	void CollideRounds();
+	// Queues an async trace of the round along Start-End when an aircraft is near it; returns whether one was queued
+	bool TraceRound(int32 Index, const FVector& Start, const FVector& End);
+	bool IsNearAircraft(const FVector& Start, const FVector& End, const AActor* Shooter);
+	void ApplyCompletedHits();
+	void OnRoundTraceComplete(const FTraceHandle& Handle, FTraceDatum& Data);
+	void OnTracerMeshLoaded();
+	void UpdateTracers();
+	void RemoveRound(int32 Index);
+
+	UPROPERTY()
+	UAircraftRegistrySubsystem* Registry;
+
+	UPROPERTY()
+	UTerrainHeightSubsystem* Terrain;
+
+	UPROPERTY()
+	UDroneSwarmSubsystem* Drones;
+
+	UPROPERTY()
+	UInstancedStaticMeshComponent* Tracers;
+
+	// Keeps the tracer mesh loaded for as long as the subsystem lives
+	TSharedPtr<FStreamableHandle> TracerMeshLoad;
+
+	// --- Rounds, struct-of-arrays ---
+	// Kinematic state, padded to a multiple of four for the vector step. Lanes past NumRounds are scratch.
+	TArray<float> PositionX, PositionY, PositionZ;
+	TArray<float> VelocityX, VelocityY, VelocityZ;
+	// Position before the last step, the start of the segment to check
+	TArray<float> StartX, StartY, StartZ;
+	TArray<float> TimeRemaining;
+
+	// Per-round data the step does not touch, exactly NumRounds long
+	TArray<uint32> Serials;
+	TArray<TWeakObjectPtr<AActor>> Shooters;
+	TArray<float> Damages;
+
+	int32 NumRounds = 0;
+	uint32 NextSerial = 0;
+
+	// Rounds whose traces are in flight, indexed by the trace's UserData
+	TSparseArray<FRoundTrace> InFlightTraces;
+
+	// Traces that have come back with a hit and are waiting to be applied
+	TArray<FRoundHit> CompletedHits;
+
+	FTraceDelegate RoundTraceDelegate;
+
+	// --- Scratch ---
+	TArray<int32> NearbyEntries;
+	TArray<FTransform> TracerTransforms;
+};